@@ -0,0 +1,108 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <cerrno>
+#include <cstring>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+
+#include "async_writer.h"
+
+namespace ExtremeEventPlugin {
+
+AsyncFileWriter::AsyncFileWriter(const std::string& path, bool append, size_t maxPending) :
+    path_(path), maxPending_(maxPending) {
+    if (maxPending_ == 0) {
+        throw eckit::BadParameter("An asynchronous file writer needs room for at least one pending buffer", Here());
+    }
+    file_ = std::fopen(path_.c_str(), append ? "ab" : "wb");
+    if (!file_) {
+        throw eckit::CantOpenFile(path_, Here());
+    }
+    std::fseek(file_, 0, SEEK_END);
+    startedEmpty_ = std::ftell(file_) == 0;
+    thread_       = std::thread(&AsyncFileWriter::writerLoop, this);
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wakeUp_.notify_one();
+    thread_.join();
+    std::fclose(file_);
+}
+
+void AsyncFileWriter::write(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    buffer_.insert(buffer_.end(), bytes, bytes + size);
+}
+
+void AsyncFileWriter::flush() {
+    if (buffer_.empty()) {
+        return;
+    }
+    std::vector<char> next;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (pending_.size() >= maxPending_) {
+            if (!warnedFull_) {
+                eckit::Log::warning() << "Writing to '" << path_ << "' falls behind, waiting for the file system with "
+                                      << pending_.size() << " pending buffer(s)" << std::endl;
+                warnedFull_ = true;
+            }
+            drained_.wait(lock, [this] { return pending_.size() < maxPending_; });
+        }
+        pending_.push_back(std::move(buffer_));
+        if (!recycled_.empty()) {
+            next = std::move(recycled_.back());
+            recycled_.pop_back();
+        }
+    }
+    wakeUp_.notify_one();
+    next.clear();
+    buffer_ = std::move(next);
+}
+
+void AsyncFileWriter::sync() {
+    flush();
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [this] { return pending_.empty() && !writing_; });
+}
+
+void AsyncFileWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wakeUp_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            // Only reached when stopping, the destructor flushed before asking to stop
+            break;
+        }
+        std::vector<char> data = std::move(pending_.front());
+        pending_.pop_front();
+        writing_ = true;
+
+        lock.unlock();
+        if (std::fwrite(data.data(), 1, data.size(), file_) != data.size() || std::fflush(file_) != 0) {
+            eckit::Log::error() << "Failed to write " << data.size() << " bytes to '" << path_
+                                << "': " << std::strerror(errno) << std::endl;
+        }
+        lock.lock();
+
+        writing_ = false;
+        recycled_.push_back(std::move(data));
+        drained_.notify_all();
+    }
+}
+
+}  // namespace ExtremeEventPlugin
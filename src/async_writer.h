@@ -0,0 +1,103 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ExtremeEventPlugin {
+
+/**
+ * @class AsyncFileWriter
+ * @brief Append-only file writer that performs the actual I/O on a background thread.
+ *
+ * The plugin runs inside the model time step, so its outputs should not wait on the file system. Data is appended
+ * to an in-memory buffer by the caller, and `flush` hands the buffer over to a background thread which writes it to
+ * the file. The file is only opened and written by the background thread after construction. At most `maxPending`
+ * buffers wait for the background thread, `flush` blocks beyond that, so a slow file system slows the caller down
+ * rather than letting the memory grow without bound.
+ */
+class AsyncFileWriter {
+public:
+    /**
+     * @brief Opens the file and starts the background writing thread.
+     *
+     * @param path The path of the file to write to.
+     * @param append Whether to append to an existing file or truncate it.
+     * @param maxPending The number of flushed buffers that can wait to be written before `flush` blocks.
+     *
+     * @throws eckit::CantOpenFile if the file cannot be opened.
+     * @throws eckit::BadParameter if `maxPending` is 0.
+     */
+    AsyncFileWriter(const std::string& path, bool append = true, size_t maxPending = 16);
+
+    /// Flushes any remaining data, waits for it to be written and closes the file.
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&)            = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    /// Appends raw bytes to the current buffer, nothing is written until the next `flush`.
+    void write(const void* data, size_t size);
+
+    /// Appends a string to the current buffer, nothing is written until the next `flush`.
+    void write(const std::string& data) { write(data.data(), data.size()); }
+
+    /// Appends the binary representation of a trivially copyable value to the current buffer.
+    template <typename T>
+    void writeValue(const T& value) {
+        write(&value, sizeof(T));
+    }
+
+    /**
+     * @brief Hands the current buffer over to the background thread without waiting for it to be written.
+     *
+     * Blocks while `maxPending` buffers are already waiting, with a warning the first time.
+     */
+    void flush();
+
+    /// Flushes the current buffer and blocks until all the data handed over so far has reached the file.
+    void sync();
+
+    /// Returns whether the file was empty when it was opened, e.g. to decide whether to write a header.
+    bool startedEmpty() const { return startedEmpty_; }
+
+    /// Returns the path of the file.
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    std::FILE* file_;
+    bool startedEmpty_;
+    size_t maxPending_;
+    bool warnedFull_ = false;
+
+    std::vector<char> buffer_;                 ///< Buffer filled by the caller
+    std::deque<std::vector<char>> pending_;    ///< Buffers waiting to be written, protected by `mutex_`
+    std::vector<std::vector<char>> recycled_;  ///< Written buffers kept to avoid reallocations, protected by `mutex_`
+    bool writing_ = false;
+    bool stop_    = false;
+
+    std::mutex mutex_;
+    std::condition_variable wakeUp_;
+    std::condition_variable drained_;  ///< Signals that a pending buffer was written
+    std::thread thread_;
+
+    /// Background loop writing the pending buffers in order.
+    void writerLoop();
+};
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,139 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "eckit/exception/Exceptions.h"
+
+namespace ExtremeEventPlugin {
+
+/**
+ * @brief Helpers for the append-only binary files written by the plugin (results, notification journal, ...).
+ *
+ * These files start with a 4 characters magic and a format version (uint32), followed by a sequence of records.
+ * Each record is made of a one byte type, the payload size in bytes (uint32) and the payload. Strings are stored as
+ * their length (uint32) followed by their characters, and values use the native byte order. Since the size of each
+ * record is known, readers can skip unknown record types and ignore a truncated last record.
+ */
+
+/// Serialises the values of a record payload.
+class RecordEncoder {
+public:
+    template <typename T>
+    void put(const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        data_.insert(data_.end(), bytes, bytes + sizeof(T));
+    }
+    void put(const std::string& value) {
+        put(static_cast<uint32_t>(value.size()));
+        data_.insert(data_.end(), value.begin(), value.end());
+    }
+
+    /// Returns the full record, i.e. type, payload size and payload.
+    std::string record(char type) const {
+        RecordEncoder prefix;
+        prefix.put(type);
+        prefix.put(static_cast<uint32_t>(data_.size()));
+        return prefix.data_ + data_;
+    }
+
+private:
+    std::string data_;
+};
+
+/**
+ * @brief Returns the type and payload size of a record whose payload is written separately, e.g. a large array that
+ *        should not be copied into an encoder.
+ *
+ * @throws eckit::BadValue if the payload does not fit in a record.
+ */
+inline std::string recordPrefix(char type, size_t payloadSize) {
+    if (payloadSize > UINT32_MAX) {
+        throw eckit::BadValue("Record of " + std::to_string(payloadSize) + " bytes is too large for a binary file",
+                              Here());
+    }
+    const auto size = static_cast<uint32_t>(payloadSize);
+    std::string prefix(1, type);
+    prefix.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    return prefix;
+}
+
+/// Deserialises the values of a record payload, throws if reading past its end.
+class RecordDecoder {
+public:
+    RecordDecoder(const char* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    T get() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+    std::string getString() {
+        auto size = get<uint32_t>();
+        return std::string(take(size), size);
+    }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t pos_ = 0;
+
+    const char* take(size_t size) {
+        if (pos_ + size > size_) {
+            throw eckit::BadValue("Corrupted record in binary file", Here());
+        }
+        pos_ += size;
+        return data_ + pos_ - size;
+    }
+};
+
+/// Returns the file header, i.e. the magic followed by the format version.
+inline std::string fileHeader(const char (&magic)[4], uint32_t version) {
+    std::string header(magic, sizeof(magic));
+    header.append(reinterpret_cast<const char*>(&version), sizeof(version));
+    return header;
+}
+
+/// Returns whether a file content starts with the given header.
+inline bool hasFileHeader(const std::string& content, const char (&magic)[4], uint32_t version) {
+    const std::string header = fileHeader(magic, version);
+    return content.compare(0, header.size(), header) == 0;
+}
+
+/**
+ * @brief Calls `callback(type, decoder)` for each complete record of a file content, in order.
+ *
+ * @param content The content of the file, whose header is assumed to have been checked.
+ * @param callback The functor called with the type and a decoder of the payload of each record.
+ */
+template <typename Callback>
+void forEachRecord(const std::string& content, Callback&& callback) {
+    const size_t prefixSize = sizeof(char) + sizeof(uint32_t);
+    size_t pos              = sizeof(char[4]) + sizeof(uint32_t);
+    while (pos + prefixSize <= content.size()) {
+        RecordDecoder prefix(content.data() + pos, prefixSize);
+        const auto type = prefix.get<char>();
+        const auto size = prefix.get<uint32_t>();
+        if (pos + prefixSize + size > content.size()) {
+            // Truncated last record, e.g. the run was interrupted while writing
+            break;
+        }
+        RecordDecoder payload(content.data() + pos + prefixSize, size);
+        pos += prefixSize + size;
+        callback(type, payload);
+    }
+}
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,200 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <unordered_map>
+
+#include "eckit/exception/Exceptions.h"
+
+#include "cell_aggregation.h"
+
+namespace ExtremeEventPlugin {
+
+CellSlots::CellSlots(const std::vector<int>& pointToCell) : pointSlot(pointToCell.size(), -1) {
+    std::unordered_map<int, int> cellSlot;
+    for (size_t point = 0; point < pointToCell.size(); ++point) {
+        if (pointToCell[point] < 0) {
+            continue;
+        }
+        auto slot = cellSlot.emplace(pointToCell[point], static_cast<int>(slotCell.size()));
+        if (slot.second) {
+            slotCell.push_back(pointToCell[point]);
+            slotPoints.push_back(0);
+        }
+        pointSlot[point] = slot.first->second;
+        ++slotPoints[slot.first->second];
+    }
+}
+
+CoarseSlots::CoarseSlots(const CellSlots& fine, const std::function<int(int)>& coarseCell) :
+    fineSlot(fine.slotCell.size(), -1) {
+    std::unordered_map<int, int> cellSlot;
+    for (size_t slot = 0; slot < fine.slotCell.size(); ++slot) {
+        const int cell = coarseCell(fine.slotCell[slot]);
+        auto coarse    = cellSlot.emplace(cell, static_cast<int>(slotCell.size()));
+        if (coarse.second) {
+            slotCell.push_back(cell);
+            slotPoints.push_back(0);
+        }
+        fineSlot[slot] = coarse.first->second;
+        slotPoints[coarse.first->second] += fine.slotPoints[slot];
+    }
+}
+
+SharedSlots::SharedSlots(const std::vector<int>& slotCell, const std::vector<int>& slotPoints,
+                         const eckit::mpi::Comm& comm) :
+    slotShared(slotCell.size(), -1), comm_(&comm) {
+    const size_t ranks = comm.size();
+    if (ranks == 1) {
+        return;
+    }
+    // Each cell is sent to the rank looking it up
+    std::vector<std::vector<int>> sent(ranks), received;
+    for (int cell : slotCell) {
+        if (cell >= 0) {
+            sent[cell % ranks].push_back(cell);
+        }
+    }
+    comm.allToAll(sent, received);
+
+    // The cells received from several ranks are shared, numbered by looking-up rank, then by cell
+    std::map<int, int> holders;
+    for (const auto& cells : received) {
+        for (int cell : cells) {
+            ++holders[cell];
+        }
+    }
+    std::unordered_map<int, int> index;
+    for (const auto& holder : holders) {
+        if (holder.second > 1) {
+            index.emplace(holder.first, static_cast<int>(index.size()));
+        }
+    }
+    std::vector<int> counts(ranks);
+    comm.allGather(static_cast<int>(index.size()), counts.begin(), counts.end());
+    const int offset = std::accumulate(counts.begin(), counts.begin() + comm.rank(), 0);
+    size             = std::accumulate(counts.begin(), counts.end(), 0);
+
+    // Each rank gets the index of the cells it sent back, in the order it sent them, -1 for those only it holds
+    for (auto& cells : received) {
+        for (int& cell : cells) {
+            auto shared = index.find(cell);
+            cell        = shared != index.end() ? offset + shared->second : -1;
+        }
+    }
+    std::vector<std::vector<int>> answers;
+    comm.allToAll(received, answers);
+    std::vector<size_t> next(ranks, 0);
+    for (size_t slot = 0; slot < slotCell.size(); ++slot) {
+        const int cell = slotCell[slot];
+        if (cell < 0) {
+            continue;
+        }
+        slotShared[slot] = answers[cell % ranks][next[cell % ranks]++];
+        if (slotShared[slot] >= 0) {
+            cellShared.emplace(cell, slotShared[slot]);
+        }
+    }
+
+    // The fraction of the points detected in a shared cell is taken over all its points
+    sharedPoints.assign(size, 0);
+    for (size_t slot = 0; slot < slotCell.size(); ++slot) {
+        if (slotShared[slot] >= 0) {
+            sharedPoints[slotShared[slot]] = slotPoints[slot];
+        }
+    }
+    if (size > 0) {
+        comm.allReduceInPlace(sharedPoints.begin(), sharedPoints.end(), eckit::mpi::sum());
+    }
+}
+
+void SharedSlots::reduce(std::vector<int>& counts, std::vector<double>& sums) const {
+    if (size == 0) {
+        return;
+    }
+    std::vector<int> sharedCounts(size, 0);
+    std::vector<double> sharedSums(sums.empty() ? 0 : size, 0.0);
+    for (size_t slot = 0; slot < slotShared.size(); ++slot) {
+        if (slotShared[slot] >= 0) {
+            sharedCounts[slotShared[slot]] = counts[slot];
+            if (!sums.empty()) {
+                sharedSums[slotShared[slot]] = sums[slot];
+            }
+        }
+    }
+    comm_->allReduceInPlace(sharedCounts.begin(), sharedCounts.end(), eckit::mpi::sum());
+    if (!sums.empty()) {
+        comm_->allReduceInPlace(sharedSums.begin(), sharedSums.end(), eckit::mpi::sum());
+    }
+    for (size_t slot = 0; slot < slotShared.size(); ++slot) {
+        if (slotShared[slot] >= 0) {
+            counts[slot] = sharedCounts[slotShared[slot]];
+            if (!sums.empty()) {
+                sums[slot] = sharedSums[slotShared[slot]];
+            }
+        }
+    }
+}
+
+std::vector<int> aggregateCells(const std::vector<int>& detectedPoints, const std::vector<float>& detectedValues,
+                                const CellSlots& slots, const ExtremeEvent::CellCriterion& criterion,
+                                const CoarseSlots* coarse, const SharedSlots* shared) {
+    const bool checksMean = criterion.minMean > std::numeric_limits<double>::lowest();
+    if (checksMean && detectedValues.size() != detectedPoints.size()) {
+        throw eckit::BadValue("A 'cell_criterion' with 'min_mean' requires an event reporting its detected values",
+                              Here());
+    }
+    std::vector<int> counts(slots.slotCell.size(), 0);
+    std::vector<double> sums(checksMean ? slots.slotCell.size() : 0, 0.0);
+    scatterAdd(detectedPoints.data(), checksMean ? detectedValues.data() : nullptr, detectedPoints.size(),
+               slots.pointSlot.data(), counts.data(), sums.data());
+    const std::vector<int>* slotCell   = &slots.slotCell;
+    const std::vector<int>* slotPoints = &slots.slotPoints;
+    if (coarse) {
+        // The fine slots are few compared to the points, folding them is cheap
+        std::vector<int> coarseCounts(coarse->slotCell.size(), 0);
+        std::vector<double> coarseSums(checksMean ? coarse->slotCell.size() : 0, 0.0);
+        for (size_t slot = 0; slot < counts.size(); ++slot) {
+            coarseCounts[coarse->fineSlot[slot]] += counts[slot];
+            if (checksMean) {
+                coarseSums[coarse->fineSlot[slot]] += sums[slot];
+            }
+        }
+        counts.swap(coarseCounts);
+        sums.swap(coarseSums);
+        slotCell   = &coarse->slotCell;
+        slotPoints = &coarse->slotPoints;
+    }
+
+    if (shared) {
+        shared->reduce(counts, sums);
+    }
+
+    std::vector<int> cells;
+    for (size_t slot = 0; slot < counts.size(); ++slot) {
+        const int count  = counts[slot];
+        const int points = shared && shared->slotShared[slot] >= 0 ? shared->sharedPoints[shared->slotShared[slot]]
+                                                                   : (*slotPoints)[slot];
+        if (count == 0 || count < criterion.minPoints || count < criterion.minFraction * points) {
+            continue;
+        }
+        if (checksMean && sums[slot] / count < criterion.minMean) {
+            continue;
+        }
+        cells.push_back((*slotCell)[slot]);
+    }
+    std::sort(cells.begin(), cells.end());
+    return cells;
+}
+
+}  // namespace ExtremeEventPlugin
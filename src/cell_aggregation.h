@@ -0,0 +1,146 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "eckit/mpi/Comm.h"
+
+#include "ee_registry/ee_base.h"
+
+namespace ExtremeEventPlugin {
+
+/**
+ * @brief The HEALPix cells of the points of a function space, numbered from 0 within the partition.
+ *
+ * The cell indices are global, so per-cell accumulators indexed by cell would scale with the HEALPix resolution. The
+ * slots only number the cells containing owned points of the partition, so the accumulators are small dense arrays.
+ */
+struct CellSlots {
+    std::vector<int> pointSlot;   ///< Slot of the cell of each point, -1 for the halo
+    std::vector<int> slotCell;    ///< Cell index of each slot
+    std::vector<int> slotPoints;  ///< Number of owned points in the cell of each slot
+
+    CellSlots() = default;
+
+    /// @param pointToCell The point to HEALPix cell mapping of the function space, -1 for the halo points.
+    explicit CellSlots(const std::vector<int>& pointToCell);
+};
+
+/**
+ * @brief The cells of a coarser HEALPix level, numbered from 0 within the partition by grouping the finer slots.
+ *
+ * The points are still accumulated in the slots of the finest level, which are then folded into the coarse slots,
+ * so no mapping of the points to the coarse cells is kept.
+ */
+struct CoarseSlots {
+    std::vector<int> fineSlot;    ///< Coarse slot of each slot of the finest level
+    std::vector<int> slotCell;    ///< Coarse cell index of each slot
+    std::vector<int> slotPoints;  ///< Number of owned points in the coarse cell of each slot
+
+    CoarseSlots() = default;
+
+    /**
+     * @param fine The slots of the finest level.
+     * @param coarseCell Returns the coarse cell of a cell of the finest level.
+     */
+    CoarseSlots(const CellSlots& fine, const std::function<int(int)>& coarseCell);
+};
+
+/**
+ * @brief The cells of the slots of a partition which also hold owned points of other partitions.
+ *
+ * The shared cells are numbered from 0 in the same order on all the ranks, so that their accumulators can be reduced
+ * across the ranks at once. Each cell is looked up on the rank `cell % size`, so that no rank holds the cells of all
+ * the partitions.
+ */
+struct SharedSlots {
+    std::vector<int> slotShared;              ///< Index of the cell of each slot among the shared cells, or -1
+    std::unordered_map<int, int> cellShared;  ///< Index of each shared cell of the partition among the shared cells
+    std::vector<int> sharedPoints;            ///< Number of owned points of each shared cell over all the partitions
+    size_t size = 0;                          ///< Number of shared cells over all the partitions
+
+    SharedSlots() = default;
+
+    /**
+     * @brief Finds the shared cells, collective over the communicator.
+     *
+     * @param slotCell The cell index of each slot of the partition, cells below 0 are never shared.
+     * @param slotPoints The number of owned points in the cell of each slot.
+     * @param comm The communicator of the partitions, kept to reduce the accumulators.
+     */
+    SharedSlots(const std::vector<int>& slotCell, const std::vector<int>& slotPoints, const eckit::mpi::Comm& comm);
+
+    /**
+     * @brief Sums the accumulators of the shared slots over all the partitions, collective over the communicator.
+     *
+     * @param[in,out] counts The number of detected points of each slot.
+     * @param[in,out] sums The sum of the detected values of each slot, left alone if empty.
+     */
+    void reduce(std::vector<int>& counts, std::vector<double>& sums) const;
+
+private:
+    const eckit::mpi::Comm* comm_ = nullptr;
+};
+
+/**
+ * @brief Adds each detected point to the count, and its value to the sum, of the slot of its cell.
+ *
+ * @param[in] points The indices of the detected points on the function space.
+ * @param[in] values The value of each detected point, or `nullptr` to count the points only.
+ * @param[in] size The number of detected points.
+ * @param[in] pointSlot The slot of the cell of each point of the function space.
+ * @param[in,out] counts The number of detected points of each slot.
+ * @param[in,out] sums The sum of the detected values of each slot, unused if `values` is `nullptr`.
+ */
+inline void scatterAdd(const int* points, const float* values, size_t size, const int* pointSlot, int* counts,
+                       double* sums) {
+    if (values) {
+        for (size_t k = 0; k < size; ++k) {
+            const int slot = pointSlot[points[k]];
+            ++counts[slot];
+            sums[slot] += values[k];
+        }
+    }
+    else {
+        for (size_t k = 0; k < size; ++k) {
+            ++counts[pointSlot[points[k]]];
+        }
+    }
+}
+
+/**
+ * @brief Finds the HEALPix cells whose detected points satisfy a cell criterion.
+ *
+ * The detected points are accumulated per cell in a single pass, and each cell is then checked against the minimum
+ * number of points, fraction of points and mean value of the criterion. The accumulators of the cells shared by
+ * several partitions are summed over the partitions first, so that all of them judge a shared cell alike, which makes
+ * the call collective when `shared` holds cells.
+ *
+ * @param detectedPoints The indices of the detected points on the function space, all owned.
+ * @param detectedValues The value of each detected point, only required by a minimum mean.
+ * @param slots The cell slots of the function space.
+ * @param criterion The criterion the cells must satisfy.
+ * @param coarse The slots of a coarser level the cells are judged at, `nullptr` to judge the cells of `slots`.
+ * @param shared The shared cells of the level the cells are judged at, `nullptr` to judge the points of the partition.
+ *
+ * @return The sorted indices of the cells satisfying the criterion.
+ *
+ * @throws eckit::BadValue if the criterion has a minimum mean and the event did not report its values.
+ */
+std::vector<int> aggregateCells(const std::vector<int>& detectedPoints, const std::vector<float>& detectedValues,
+                                const CellSlots& slots, const ExtremeEvent::CellCriterion& criterion,
+                                const CoarseSlots* coarse = nullptr, const SharedSlots* shared = nullptr);
+
+}  // namespace ExtremeEventPlugin
@@ -8,12 +8,18 @@
  * granted to it by virtue of its status as an intergovernmental organisation nor
  * does it submit to any jurisdiction.
  */
+#include <algorithm>
 #include <cmath>
+#include <functional>
+#include <limits>
 #include <map>
+#include <numeric>
 #include <sstream>
+#include <unordered_set>
 
 #include "atlas/field/Field.h"
 #include "atlas/functionspace.h"
+#include "atlas/parallel/mpi/mpi.h"
 
 #include "ee_plugin.h"
 #include "healpix_utils.h"
@@ -23,14 +29,68 @@ using namespace HEALPixUtils;
 
 namespace ExtremeEventPlugin {
 
-EEPluginCore::EEPluginCore(const eckit::Configuration& conf) : PluginCore(conf) {
-    healpixRes_         = conf.getInt("healpix_res", 2);
+EEPluginCore::EEPluginCore(const eckit::Configuration& conf) :
+    PluginCore(conf), polygonCache_(std::max(0, conf.getInt("polygon_cache", 256))) {
+    healpixRes_             = conf.getInt("healpix_res", 2);
+    std::string healpixMesh = conf.getString("healpix_mesh", "global");
+    if (healpixMesh != "global" && healpixMesh != "local") {
+        throw eckit::BadParameter("The 'healpix_mesh' must be 'global' or 'local'", Here());
+    }
+    healpixLocal_       = healpixMesh == "local";
     enableNotification_ = conf.getBool("enable_notification", false);
     if (enableNotification_) {
         notificationHandler_ = AvisoNotificationHandler(conf.getString("aviso_url"), conf.getString("notify_endpoint"));
+        notificationJournal_ = conf.getString("notification_journal", "ee_notifications.journal");
+        if (conf.has("notification_retry")) {
+            retryPolicy_ = RetryPolicy(conf.getSubConfiguration("notification_retry"));
+        }
+        if (conf.has("subscriptions")) {
+            subscriptions_ = std::make_unique<SubscriptionIndex>(conf.getSubConfiguration("subscriptions"));
+        }
     }
 
+    resultsFile_ = conf.getString("results_file", "");
+    if (!enableNotification_ && resultsFile_.empty()) {
+        eckit::Log::warning() << "Extreme event notifications are disabled and no 'results_file' is configured, "
+                              << "detection results will be discarded" << std::endl;
+    }
     extremeEventConfig_ = conf.getSubConfigurations("events");
+
+    if (conf.has("sites")) {
+        siteOutput_ = std::make_unique<SiteWindOutput>(conf.getSubConfiguration("sites"));
+    }
+    if (conf.has("ensemble")) {
+        ensemble_ = std::make_unique<EnsembleReducer>(conf.getSubConfiguration("ensemble"));
+    }
+    recordFile_ = conf.getString("record", "");
+    if (conf.has("tracking")) {
+        trackingDistance_ = conf.getSubConfiguration("tracking").getDouble("max_distance", 0.0);
+    }
+    if (conf.has("threshold_overrides")) {
+        overrideConfig_ = conf.getSubConfiguration("threshold_overrides");
+    }
+    if (conf.has("step_budget")) {
+        // The ranks take the same decisions, from the largest overshoot of the budget
+        budget_ = std::make_unique<StepBudget>(conf.getSubConfiguration("step_budget"), StepBudget::Clock(),
+                                               [](double overshoot) {
+                                                   atlas::mpi::comm().allReduceInPlace(overshoot, eckit::mpi::max());
+                                                   return overshoot;
+                                               });
+    }
+}
+
+EEPluginCore::~EEPluginCore() {
+    try {
+        for (auto& out : deferred_) {
+            output(out);
+        }
+        if (!deferred_.empty() && resultsSink_) {
+            resultsSink_->flush();
+        }
+    }
+    catch (const std::exception& e) {
+        eckit::Log::error() << "The outputs deferred by the last step could not be sent: " << e.what() << std::endl;
+    }
 }
 
 void EEPluginCore::setup() {
@@ -51,6 +111,9 @@ void EEPluginCore::setup() {
         if (hasRequiredParams) {
             ee.set("vertical_levels", modelData().getInt("NFLEVG"));
             extremeEvents_.push_back(ExtremeEventRegistry::instance().createEvent(ee.getString("name"), ee));
+            extremeEvents_.back()->setup(modelData());
+            eventNames_.push_back(ee.getString("name"));
+            eventResolution_.push_back(ee.getInt("healpix_res", healpixRes_));
             eckit::Log::info() << ee.getString("name") << " ";
         }
     }
@@ -60,43 +123,595 @@ void EEPluginCore::setup() {
     eckit::Log::info() << std::endl;
     // Healpix - grid points & polygon mapping matrix
     setHEALPixMapping();
+    if (ensemble_) {
+        // The cells of all the function spaces and levels are reduced together, each instance uses one level only
+        std::vector<int> pointToCell;
+        for (const auto& cached : Point2HPcell_) {
+            pointToCell.insert(pointToCell.end(), cached.second.pointToCell.begin(), cached.second.pointToCell.end());
+            for (const auto& coarse : cached.second.coarseSlots) {
+                pointToCell.insert(pointToCell.end(), coarse.slotCell.begin(), coarse.slotCell.end());
+            }
+        }
+        ensemble_->setup(pointToCell);
+    }
+
+    const auto& comm = atlas::mpi::comm();
+    auto rankPath    = [&comm](const std::string& path) {
+        return comm.size() > 1 ? path + "." + std::to_string(comm.rank()) : path;
+    };
+    // In ensemble mode, the first member outputs the results of the whole ensemble
+    const bool outputs = !ensemble_ || ensemble_->outputs();
+    if (!resultsFile_.empty() && outputs) {
+        // One file per partition, the results of different partitions are not aggregated
+        resultsSink_ = std::make_unique<ResultsSink>(rankPath(resultsFile_));
+    }
+    if ((enableNotification_ || !resultsFile_.empty()) && outputs) {
+        // Identifiers are assigned independently by each partition
+        tracker_ = std::make_unique<EventTracker>(trackingDistance_, comm.rank(), comm.size());
+    }
+    if (enableNotification_ && outputs) {
+        // Each partition sends its own notifications, so it also keeps its own journal
+        notifier_ = std::make_unique<NotificationDispatcher>(notificationHandler_, rankPath(notificationJournal_),
+                                                             retryPolicy_);
+        if (subscriptions_) {
+            for (const auto& cached : Point2HPcell_) {
+                subscriptions_->addFunctionSpace(cached.second.pointToCell,
+                                                 [this](int cell) -> const auto& { return cellVertices(0, cell); });
+            }
+            eckit::Log::info() << subscriptions_->size() << " subscriber(s) indexed on "
+                               << subscriptions_->indexedCells() << " HEALPix cell(s)" << std::endl;
+            coarseSubscriptions_.clear();
+            for (size_t level = 1; level < levels_.size(); ++level) {
+                coarseSubscriptions_.push_back(subscriptions_->coarsened(
+                    [this, level](int cell) { return cellAtLevel(level, cell); },
+                    [this, level](int cell) -> const auto& { return cellVertices(level, cell); }));
+            }
+        }
+    }
+
+    if (!recordFile_.empty()) {
+        // The fields of the loaded events and of the sites, so that the replay runs the same detections
+        std::vector<std::string> fields;
+        auto addFields = [&](const std::vector<std::string>& required) {
+            for (const auto& field : required) {
+                if (modelData().hasParameter(field) && std::find(fields.begin(), fields.end(), field) == fields.end()) {
+                    fields.push_back(field);
+                }
+            }
+        };
+        for (const auto& extremeEvent : extremeEvents_) {
+            addFields(extremeEvent->requiredFields());
+        }
+        if (siteOutput_) {
+            addFields(siteOutput_->requiredFields());
+        }
+        // Each member of an ensemble records its own fields
+        recorder_ = std::make_unique<SnapshotWriter>(snapshotPath(recordFile_, ensemble_ ? ensemble_->member() : -1),
+                                                     modelData(), fields);
+    }
+
+    if (overrideConfig_.has("file")) {
+        overrideWatcher_ = std::make_unique<ThresholdOverrideWatcher>(overrideConfig_.getString("file"),
+                                                                      overrideConfig_.getDouble("poll_interval", 10.0));
+    }
+
+    if (siteOutput_) {
+        for (const auto& field : siteOutput_->requiredFields()) {
+            if (!modelData().hasParameter(field)) {
+                eckit::Log::error() << "Site output disabled, the model does not offer field '" << field << "'"
+                                    << std::endl;
+                siteOutput_.reset();
+                return;
+            }
+        }
+        // The sites are extracted from each member, in separate files
+        siteOutput_->setup(modelData(), ensemble_ ? ".member" + std::to_string(ensemble_->member()) : "");
+    }
 }
 
 void EEPluginCore::run() {
+    if (budget_) {
+        budget_->startStep();
+    }
+    if (recorder_) {
+        // The fields are copied before the detection, the file is written by a background thread
+        recorder_->write(modelData());
+        recorder_->flush();
+    }
+    if (overrideWatcher_) {
+        applyThresholdOverrides();
+    }
     // Determine the elapsed time in the simulation in minutes
     std::string elapsedTime = modelStepStr();
-    for (auto& ee : extremeEvents_) {
-        // Run the detection for each extreme event suite
-        auto results = ee->detect(modelData());
-        for (size_t idx = 0; idx < results.size(); ++idx) {
-            if (results[idx].detectedPoints.empty()) {
-                // No actual points were detected for that instance of the event
+    // Run the detection for each extreme event suite, the firing cells of all the instances are gathered so that they
+    // can be reduced at once across the members in ensemble mode
+    std::vector<std::vector<ExtremeEvent::DetectionData>> results;
+    std::vector<std::vector<int>> firingCells;
+    for (size_t eventIdx = 0; eventIdx < extremeEvents_.size(); ++eventIdx) {
+        results.push_back(extremeEvents_[eventIdx]->detect(modelData()));
+        const auto& mapping = *eventPoint2HPcell_[eventIdx];
+        const size_t level  = eventLevel_[eventIdx];
+        const auto* coarse  = level > 0 ? &mapping.coarseSlots[level - 1] : nullptr;
+        for (const auto& instance : results.back()) {
+            if (instance.cellCriterion.aggregates()) {
+                // Collective, the instances and their criteria are the same on all the ranks
+                firingCells.push_back(aggregateCells(instance.detectedPoints, instance.detectedValues, mapping.slots,
+                                                     instance.cellCriterion, coarse, &mapping.sharedSlots[level]));
+            }
+            else {
+                firingCells.push_back(
+                    cellsAtLevel(pointsToCells(instance.detectedPoints, mapping.pointToCell), level));
+            }
+        }
+    }
+    if (ensemble_) {
+        firingCells = ensemble_->reduce(firingCells);
+    }
+    // The statistics are reduced over the partitions first, the partitions without firing cells skip the output
+    std::vector<std::unordered_map<int, EventStatistics>> cellStats;
+    const auto instanceStats = instanceStatistics(results, firingCells, cellStats);
+    if (budget_) {
+        budget_->mark(StepBudget::Phase::Detection);
+    }
+
+    // The outputs deferred by the previous step go first, so the results file stays in step order
+    for (auto& out : deferred_) {
+        output(out);
+    }
+    deferred_.clear();
+    if (budget_) {
+        budget_->mark(StepBudget::Phase::Output);
+    }
+
+    size_t instanceIdx = 0;
+    bool deferring     = false;
+    for (size_t eventIdx = 0; eventIdx < results.size(); ++eventIdx) {
+        for (size_t idx = 0; idx < results[eventIdx].size(); ++idx) {
+            const size_t trackIdx = instanceIdx;
+            auto& ee_cells        = firingCells[instanceIdx++];
+            if (budget_ && !deferring) {
+                // All the ranks check the budget before each instance, outputting or not, so that they defer the same
+                // instances. Once the budget ran out, it stays so until the end of the step
+                deferring = budget_->exhausted();
+            }
+            if ((!notifier_ && !resultsSink_) || (ee_cells.empty() && !tracker_->tracking(trackIdx))) {
+                // This member does not output, or no actual points were detected for that instance of the event and
+                // no event of the previous step ends
                 continue;
             }
-            auto ee_polygon_points = cellToPolygons(results[idx].detectedPoints, Point2HPcell_, HPcell2polygon_);
-            if (enableNotification_) {
-                // Send notification for each polygon individually if enabled
-                for (auto& polygon : ee_polygon_points) {
-                    // TODO: move the payload building responsibility to the aviso handler after payload is agreed on
-                    std::ostringstream payload;
-                    payload << "{\"step\":\"" << elapsedTime << "\",\"description\":\"" << results[idx].description
-                            << "\",\"param\":\"" << results[idx].param << "\",\"levtype\":\"" << results[idx].levtype
-                            << "\",\"levelist\":\"" << results[idx].levelist << "\"}";
-                    notificationHandler_.send(payload.str(), polygon);
+            const auto& result  = results[eventIdx][idx];
+            const auto& mapping = *eventPoint2HPcell_[eventIdx];
+            const auto& level   = levels_[eventLevel_[eventIdx]];
+            InstanceOutput out;
+            out.step          = elapsedTime;
+            out.event         = static_cast<uint32_t>(eventIdx);
+            out.instance      = static_cast<uint32_t>(idx);
+            out.level         = eventLevel_[eventIdx];
+            out.description   = ensemble_ ? ensemble_->describe(result.description) : result.description;
+            out.param         = result.param;
+            out.levtype       = result.levtype;
+            out.levelist      = result.levelist;
+            out.quantity      = result.quantity;
+            out.cells         = std::move(ee_cells);
+            out.instanceStats = instanceStats[trackIdx];
+            // Polygons are extracted per contiguous group of cells, so that each carries the statistics of its cells
+            const auto& byCell = cellStats[trackIdx];
+            out.groups         = healpixLocal_ ? contiguousCells(out.cells, level.localVertices)
+                                               : contiguousCells(out.cells, level.vertices);
+            std::vector<atlas::PointLonLat> centroids;
+            for (const auto& group : out.groups) {
+                centroids.push_back(healpixLocal_ ? cellsCentroid(group, level.localVertices)
+                                                  : cellsCentroid(group, level.vertices));
+            }
+            // The groups are matched to the events of the previous step, which gives them their identifier
+            out.tracks = tracker_->update(trackIdx, out.groups, centroids, out.died);
+
+            for (const auto& group : out.groups) {
+                EventStatistics groupStats;
+                for (int cell : group) {
+                    auto stats = byCell.find(cell);
+                    if (stats != byCell.end()) {
+                        groupStats.merge(stats->second);
+                    }
+                }
+                // Cells fired by other members only have no values, but they count in the area
+                groupStats.cells = group.size();
+                groupStats.locate(mapping.functionSpace);
+                out.groupStats.push_back(groupStats);
+            }
+            if (budget_) {
+                budget_->mark(StepBudget::Phase::Tracking);
+                if (deferring) {
+                    // The events are tracked at every step, only their polygons wait for the next step
+                    budget_->deferred();
+                    deferred_.push_back(std::move(out));
+                    continue;
                 }
             }
-            else {
-                // TODO what do we do with the results of notifications are disabled ?
+            output(out);
+            if (budget_) {
+                budget_->mark(StepBudget::Phase::Output);
             }
         }
     }
+    if (resultsSink_) {
+        // Hand the step over to the writing thread, the model does not wait for the file system
+        resultsSink_->flush();
+    }
+    if (siteOutput_) {
+        siteOutput_->write(modelData(), elapsedTime);
+    }
+    if (budget_) {
+        budget_->mark(StepBudget::Phase::Output);
+        budget_->endStep(elapsedTime);
+    }
+}
+
+std::vector<EventStatistics> EEPluginCore::instanceStatistics(
+    const std::vector<std::vector<ExtremeEvent::DetectionData>>& results,
+    const std::vector<std::vector<int>>& firingCells,
+    std::vector<std::unordered_map<int, EventStatistics>>& cellStats) const {
+    const auto& comm = atlas::mpi::comm();
+    const int rank   = static_cast<int>(comm.rank());
+    std::vector<EventStatistics> stats;
+    // Largest value and its rank, then the points, sum, cells held by a single partition and location of each instance
+    std::vector<std::pair<double, int>> maxima;
+    std::vector<double> totals;
+    // Whether each shared cell fired, by instance, so that the cells shared by partitions count once in the area
+    std::vector<int> sharedFired;
+    std::vector<size_t> sharedOffset;
+    size_t instanceIdx = 0;
+    for (size_t eventIdx = 0; eventIdx < results.size(); ++eventIdx) {
+        const auto& mapping = *eventPoint2HPcell_[eventIdx];
+        const size_t level  = eventLevel_[eventIdx];
+        const auto& shared  = mapping.sharedSlots[level];
+        for (const auto& result : results[eventIdx]) {
+            const auto& cells = firingCells[instanceIdx++];
+            cellStats.emplace_back();
+            auto& byCell = cellStats.back();
+            if (!cells.empty()) {
+                byCell = cellStatistics(result.detectedPoints, result.detectedValues, mapping.pointToCell);
+            }
+            if (level > 0) {
+                // The statistics are gathered on the finest cells, then merged into the cells of the event
+                std::unordered_map<int, EventStatistics> byCoarseCell;
+                for (const auto& cell : byCell) {
+                    byCoarseCell[cellAtLevel(level, cell.first)].merge(cell.second);
+                }
+                byCell.swap(byCoarseCell);
+            }
+            EventStatistics local;
+            size_t single = 0;
+            sharedOffset.push_back(sharedFired.size());
+            sharedFired.resize(sharedFired.size() + shared.size, 0);
+            for (int cell : cells) {
+                auto found = byCell.find(cell);
+                if (found != byCell.end()) {
+                    local.merge(found->second);
+                }
+                auto index = shared.cellShared.find(cell);
+                if (index != shared.cellShared.end()) {
+                    sharedFired[sharedOffset.back() + index->second] = 1;
+                }
+                else {
+                    ++single;
+                }
+            }
+            local.locate(mapping.functionSpace);
+            stats.push_back(local);
+            maxima.emplace_back(local.points > 0 ? local.max : std::numeric_limits<double>::lowest(), rank);
+            totals.insert(totals.end(), {static_cast<double>(local.points), local.sum, static_cast<double>(single),
+                                         0.0, 0.0});
+        }
+    }
+    comm.allReduceInPlace(maxima.begin(), maxima.end(), eckit::mpi::maxloc());
+    for (size_t idx = 0; idx < stats.size(); ++idx) {
+        if (maxima[idx].second == rank && stats[idx].points > 0) {
+            totals[5 * idx + 3] = stats[idx].maxLon;
+            totals[5 * idx + 4] = stats[idx].maxLat;
+        }
+    }
+    comm.allReduceInPlace(totals.begin(), totals.end(), eckit::mpi::sum());
+    if (!sharedFired.empty()) {
+        comm.allReduceInPlace(sharedFired.begin(), sharedFired.end(), eckit::mpi::max());
+    }
+    sharedOffset.push_back(sharedFired.size());
+    for (size_t idx = 0; idx < stats.size(); ++idx) {
+        auto& instance  = stats[idx];
+        instance.points = static_cast<size_t>(totals[5 * idx]);
+        instance.sum    = totals[5 * idx + 1];
+        instance.cells  = static_cast<size_t>(totals[5 * idx + 2]) +
+                         std::count(sharedFired.begin() + sharedOffset[idx],
+                                    sharedFired.begin() + sharedOffset[idx + 1], 1);
+        instance.max    = static_cast<float>(maxima[idx].first);
+        instance.maxLon = totals[5 * idx + 3];
+        instance.maxLat = totals[5 * idx + 4];
+        if (maxima[idx].second != rank) {
+            instance.maxPoint = -1;
+        }
+    }
+    return stats;
+}
+
+void EEPluginCore::output(InstanceOutput& out) {
+    // The largest groups come first when the polygons are capped
+    const size_t allowed = budget_ ? budget_->polygonCap() : std::numeric_limits<size_t>::max();
+    std::vector<size_t> order(out.groups.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (allowed < std::numeric_limits<size_t>::max()) {
+        std::stable_sort(order.begin(), order.end(),
+                         [&out](size_t a, size_t b) { return out.groups[a].size() > out.groups[b].size(); });
+    }
+    // Groups left without polygons by the cap, their polygons are not even extracted
+    size_t dropped = 0;
+    std::vector<std::vector<atlas::PointLonLat>> ee_polygon_points;
+    std::vector<size_t> polygonGroup;
+    for (size_t groupIdx : order) {
+        if (ee_polygon_points.size() >= allowed) {
+            ++dropped;
+            continue;
+        }
+        for (const auto& polygon : polygonsOf(out.groups[groupIdx], out.level)) {
+            if (ee_polygon_points.size() < allowed) {
+                ee_polygon_points.push_back(polygon);
+                polygonGroup.push_back(groupIdx);
+            }
+        }
+    }
+    if (notifier_) {
+        // Send notification for each polygon individually if enabled
+        // TODO: move the payload building responsibility to the aviso handler after payload is agreed on
+        std::ostringstream header;
+        header << "{\"step\":\"" << out.step << "\",\"description\":\"" << out.description << "\",\"param\":\""
+               << out.param << "\",\"levtype\":\"" << out.levtype << "\",\"levelist\":\"" << out.levelist
+               << "\",\"track\":";
+        const double cellArea     = healpixCellArea(levels_[out.level].resolution);
+        const std::string summary = statisticsToJson(out.instanceStats, out.quantity, cellArea);
+        const SubscriptionIndex* index =
+            !subscriptions_ ? nullptr : out.level > 0 ? &coarseSubscriptions_[out.level - 1] : subscriptions_.get();
+        // Complete payload of a notification: the track, the statistics if any and the subscribers of its cells
+        auto payload = [&](const EventTracker::Track& track, const std::string& stats,
+                           const std::vector<int>& cells) {
+            std::vector<size_t> subscribers;
+            std::ostringstream json;
+            json << header.str() << EventTracker::toJson(track) << stats;
+            if (index) {
+                subscribers = index->subscribersOf(cells);
+                json << ",\"subscribers\":" << index->namesToJson(subscribers);
+            }
+            json << "}";
+            return std::make_pair(json.str(), subscribers);
+        };
+        for (size_t polyIdx = 0; polyIdx < ee_polygon_points.size(); ++polyIdx) {
+            const size_t groupIdx = polygonGroup[polyIdx];
+            const std::string stats =
+                ",\"polygon_stats\":" + statisticsToJson(out.groupStats[groupIdx], out.quantity, cellArea) +
+                ",\"event_stats\":" + summary;
+            const auto message = payload(out.tracks[groupIdx], stats, out.groups[groupIdx]);
+            notify(message.first, ee_polygon_points[polyIdx], message.second, out.level);
+        }
+        // The end of an event is notified with its last polygons, within what is left of the cap
+        size_t sent = ee_polygon_points.size();
+        for (const auto& track : out.died) {
+            if (sent >= allowed) {
+                ++dropped;
+                continue;
+            }
+            const auto message = payload(track, "", track.cells);
+            for (const auto& polygon : polygonsOf(track.cells, out.level)) {
+                if (sent < allowed) {
+                    notify(message.first, polygon, message.second, out.level);
+                    ++sent;
+                }
+            }
+        }
+    }
+    if (budget_ && dropped > 0) {
+        budget_->capped(dropped);
+    }
+    if (resultsSink_ && !out.cells.empty()) {
+        resultsSink_->write({out.step, out.event, out.instance, out.description, out.param, out.levtype, out.levelist,
+                             std::move(out.cells), std::move(ee_polygon_points)});
+    }
 }
 
 void EEPluginCore::setHEALPixMapping() {
-    // TODO: Should this plugin handle multiple functionspaces if fields passed are not all on the same mesh?
-    // Retrieve the function space from the first field found in the first extreme event
-    auto fs = modelData().getAtlasFieldShared(extremeEvents_[0]->requiredFields()[0]).functionspace();
-    mapLonLatToHEALPixCell(healpixRes_, fs, Point2HPcell_, HPcell2polygon_);
+    // The cached polygons are only valid for the cell vertices they were extracted from
+    polygonCache_.clear();
+    Point2HPcell_.clear();
+    eventPoint2HPcell_.clear();
+    eventLevel_.clear();
+    levels_.clear();
+    // One level per resolution used by the events, the finest first
+    std::vector<int> resolutions = eventResolution_;
+    if (resolutions.empty()) {
+        resolutions.push_back(healpixRes_);
+    }
+    std::sort(resolutions.begin(), resolutions.end(), std::greater<int>());
+    resolutions.erase(std::unique(resolutions.begin(), resolutions.end()), resolutions.end());
+    for (int resolution : resolutions) {
+        const int ratio = resolution > 0 ? resolutions[0] / resolution : 0;
+        if (resolution <= 0 || resolutions[0] % resolution != 0 || (ratio & (ratio - 1)) != 0) {
+            throw eckit::BadParameter("The HEALPix resolution " + std::to_string(resolution) +
+                                          " of an event must be the finest resolution " +
+                                          std::to_string(resolutions[0]) + " divided by a power of two",
+                                      Here());
+        }
+        levels_.push_back(HEALPixLevel{resolution, {}, {}, {}, {}, {}});
+    }
+    for (size_t eventIdx = 0; eventIdx < extremeEvents_.size(); ++eventIdx) {
+        eventLevel_.push_back(std::find(resolutions.begin(), resolutions.end(), eventResolution_[eventIdx]) -
+                              resolutions.begin());
+        // The fields of an event are expected to share the function space of its first field
+        auto fs = modelData().getAtlasFieldShared(extremeEvents_[eventIdx]->requiredFields()[0]).functionspace();
+        eventPoint2HPcell_.push_back(&pointToCellMapping(fs));
+    }
+
+    // The coarser levels are derived from the cells of the finest one, the grid points are not searched again
+    const auto& finest = levels_[0];
+    for (size_t levelIdx = 1; levelIdx < levels_.size(); ++levelIdx) {
+        auto& level = levels_[levelIdx];
+        if (healpixLocal_) {
+            // The coarse mesh is distributed like each function space in turn, in the order of the events on all
+            // the ranks, so that the parents of its cells are around the partition
+            std::unordered_set<const PointCellMapping*> visited;
+            for (const auto* eventMapping : eventPoint2HPcell_) {
+                if (visited.insert(eventMapping).second) {
+                    mapLocalHEALPixCellsToCoarserCells(level.resolution, finest.resolution,
+                                                       eventMapping->functionSpace, eventMapping->pointToCell,
+                                                       level.localFromFinest, level.localVertices);
+                }
+            }
+        }
+        else {
+            mapHEALPixCellsToCoarserCells(level.resolution, finest.resolution, level.fromFinest, level.vertices);
+        }
+    }
+    for (auto& cached : Point2HPcell_) {
+        auto& mapping = cached.second;
+        mapping.coarseSlots.clear();
+        for (size_t levelIdx = 1; levelIdx < levels_.size(); ++levelIdx) {
+            mapping.coarseSlots.emplace_back(mapping.slots,
+                                             [this, levelIdx](int cell) { return cellAtLevel(levelIdx, cell); });
+        }
+    }
+    // The shared cells are found collectively, so the mappings are visited in the order of the events on all the ranks
+    std::unordered_set<const PointCellMapping*> shared;
+    for (const auto* eventMapping : eventPoint2HPcell_) {
+        if (!shared.insert(eventMapping).second) {
+            continue;
+        }
+        auto& mapping = Point2HPcell_.at(eventMapping->functionSpace.get());
+        mapping.sharedSlots.clear();
+        mapping.sharedSlots.emplace_back(mapping.slots.slotCell, mapping.slots.slotPoints, atlas::mpi::comm());
+        for (const auto& coarse : mapping.coarseSlots) {
+            mapping.sharedSlots.emplace_back(coarse.slotCell, coarse.slotPoints, atlas::mpi::comm());
+        }
+    }
+
+    if (healpixLocal_) {
+        eckit::Log::info() << "HEALPix mesh generated around the partition, " << finest.localVertices.size()
+                           << " cells kept" << std::endl;
+    }
+    eckit::Log::info() << Point2HPcell_.size() << " function space(s) mapped to HEALPix cells at resolution";
+    for (const auto& level : levels_) {
+        eckit::Log::info() << " " << level.resolution;
+    }
+    eckit::Log::info() << std::endl;
+}
+
+int EEPluginCore::cellAtLevel(size_t level, int cell) const {
+    if (level == 0) {
+        return cell;
+    }
+    if (healpixLocal_) {
+        auto coarse = levels_[level].localFromFinest.find(cell);
+        return coarse != levels_[level].localFromFinest.end() ? coarse->second : -1;
+    }
+    const auto& fromFinest = levels_[level].fromFinest;
+    return cell >= 0 && static_cast<size_t>(cell) < fromFinest.size() ? fromFinest[cell] : -1;
+}
+
+std::vector<int> EEPluginCore::cellsAtLevel(const std::vector<int>& cells, size_t level) const {
+    if (level == 0) {
+        return cells;
+    }
+    return healpixLocal_ ? coarserCells(cells, levels_[level].localFromFinest)
+                         : coarserCells(cells, levels_[level].fromFinest);
+}
+
+const std::vector<atlas::PointLonLat>& EEPluginCore::cellVertices(size_t level, int cell) const {
+    static const std::vector<atlas::PointLonLat> unknown;
+    if (healpixLocal_) {
+        auto vertices = levels_[level].localVertices.find(cell);
+        return vertices != levels_[level].localVertices.end() ? vertices->second : unknown;
+    }
+    const auto& vertices = levels_[level].vertices;
+    return cell >= 0 && static_cast<size_t>(cell) < vertices.size() ? vertices[cell] : unknown;
+}
+
+const EEPluginCore::PointCellMapping& EEPluginCore::pointToCellMapping(const atlas::FunctionSpace& fs) {
+    // References to the cached mappings stay valid when the map grows
+    auto cached   = Point2HPcell_.emplace(fs.get(), PointCellMapping{fs, {}, {}, {}, {}});
+    auto& mapping = cached.first->second.pointToCell;
+    if (!cached.second) {
+        return cached.first->second;
+    }
+    // The points are only mapped to the cells of the finest level
+    auto& finest = levels_[0];
+    if (healpixLocal_) {
+        CellVertexMap vertices;
+        mapLonLatToLocalHEALPixCells(finest.resolution, fs, mapping, vertices);
+        finest.localVertices.insert(vertices.begin(), vertices.end());
+    }
+    else {
+        // The global mesh does not depend on the function space, it is only generated for the first one
+        mapLonLatToHEALPixCell(finest.resolution, fs, mapping, finest.vertices, finest.search);
+    }
+    cached.first->second.slots = CellSlots(mapping);
+    return cached.first->second;
+}
+
+const PolygonCache::Polygons& EEPluginCore::polygonsOf(const std::vector<int>& cells, size_t level) {
+    return polygonCache_.polygons(
+        cells,
+        [&]() {
+            return healpixLocal_ ? cellsToPolygons(cells, levels_[level].localVertices)
+                                 : cellsToPolygons(cells, levels_[level].vertices);
+        },
+        static_cast<int>(level));
+}
+
+void EEPluginCore::notify(const std::string& payload, const std::vector<atlas::PointLonLat>& polygon,
+                          const std::vector<size_t>& subscribers, size_t level) {
+    if (!subscriptions_) {
+        notifier_->post(payload, polygon);
+        return;
+    }
+    const auto& index = level > 0 ? coarseSubscriptions_[level - 1] : *subscriptions_;
+    const auto main   = index.mainEndpoint();
+    if (main == SubscriptionIndex::MainEndpoint::All ||
+        (main == SubscriptionIndex::MainEndpoint::Subscribed && !subscribers.empty())) {
+        notifier_->post(payload, polygon);
+    }
+    for (size_t subscriber : subscribers) {
+        const auto& endpoint = index.subscriber(subscriber).endpoint;
+        if (!endpoint.empty()) {
+            notifier_->post(payload, polygon, endpoint);
+        }
+    }
+}
+
+void EEPluginCore::applyThresholdOverrides() {
+    // Each rank reads the file on its own, a version only applies once all the ranks read it, so that the partitions
+    // always detect with the same options. The minimum of the complement gives the maximum version in the same
+    // allreduce, a rank without overrides makes them differ.
+    const auto* overrides = overrideWatcher_->latest();
+    uint64_t versions[2]  = {0, 0};
+    if (overrides) {
+        versions[0] = overrides->version;
+        versions[1] = ~overrides->version;
+    }
+    atlas::mpi::comm().allReduceInPlace(versions, versions + 2, eckit::mpi::min());
+    if (versions[0] != ~versions[1] || versions[0] == overridesVersion_) {
+        return;
+    }
+    overridesVersion_ = overrides->version;
+    const std::vector<eckit::LocalConfiguration> none;
+    for (size_t eventIdx = 0; eventIdx < extremeEvents_.size(); ++eventIdx) {
+        auto eventOverrides = overrides->events.find(eventNames_[eventIdx]);
+        try {
+            extremeEvents_[eventIdx]->overrideInstances(eventOverrides == overrides->events.end()
+                                                            ? none
+                                                            : eventOverrides->second);
+        }
+        catch (const eckit::Exception& e) {
+            eckit::Log::error() << "Threshold overrides of '" << eventNames_[eventIdx]
+                                << "' rejected, its previous options are kept: " << e.what() << std::endl;
+        }
+    }
+    eckit::Log::info() << "Threshold overrides version " << overridesVersion_ << " applied from step "
+                       << modelData().getInt("NSTEP") << std::endl;
 }
 
 std::string EEPluginCore::modelStepStr() {
@@ -8,15 +8,32 @@
  * granted to it by virtue of its status as an intergovernmental organisation nor
  * does it submit to any jurisdiction.
  */
+#include <deque>
+#include <unordered_map>
+
+#include "atlas/functionspace.h"
 #include "atlas/grid.h"
 #include "eckit/config/Configuration.h"
 #include "eckit/config/LocalConfiguration.h"
 #include "plume/Plugin.h"
 #include "plume/PluginCore.h"
 
+#include "cell_aggregation.h"
 #include "ee_registry/ee_registry.h"
+#include "ensemble_reducer.h"
+#include "event_statistics.h"
+#include "event_tracker.h"
 #include "git_sha1.h"
+#include "healpix_utils.h"
 #include "notification.h"
+#include "notification_dispatcher.h"
+#include "polygon_cache.h"
+#include "results_sink.h"
+#include "site_output.h"
+#include "snapshot.h"
+#include "step_budget.h"
+#include "subscription_index.h"
+#include "threshold_overrides.h"
 #include "version.h"
 
 namespace ExtremeEventPlugin {
@@ -49,11 +66,23 @@ public:
      */
     EEPluginCore(const eckit::Configuration& conf);
 
+    /// Sends the outputs still deferred by the step budget.
+    ~EEPluginCore() override;
+
     /**
      * @brief Sets up the necessary variables to run the plugin.
      *
-     * 1. Creates an instance of each extreme event enabled in the configuration from the extreme event registry.
+     * 1. Creates an instance of each extreme event enabled in the configuration from the extreme event registry,
+     *    and lets it precompute what depends on the model grid (e.g. the points of its regions of interest).
      * 2. Creates the mapping between model grid points and HEALPix cells and vertices.
+     * 3. Starts the notification delivery thread, which first replays the notifications left undelivered by a
+     *    previous run, if notifications are enabled, and indexes the HEALPix cells of the subscribers, if any.
+     * 4. Assigns the configured wind sites to the partitions, if the site output is enabled.
+     * 5. Opens the snapshot file and records the partition geometry, if `record` is configured.
+     * 6. Reads the threshold override file and starts watching it, if `threshold_overrides` is configured.
+     *
+     * In ensemble mode, the ranks sharing a partition index across the members are grouped after step 2, and only
+     * the first member starts the notifications and the results file.
      *
      * @note This phase fails if the configuration does not contain the necessary information.
      */
@@ -62,15 +91,35 @@ public:
     /**
      * @brief Runs the plugin.
      *
+     * 0. Records the fields and parameters of the step to the snapshot file, if `record` is configured, and hands
+     *    the threshold overrides read since the previous step over to the events.
      * 1. Runs the detection method of each of the extreme event instances. See registry documentation for more
      *    details on the output structure.
      * 2. From the raw detection output, extract the extreme event polygons (contiguous firing HEALPix cells).
+     *    A cell fires if it contains a detected point, or if its detected points satisfy the cell criterion of the
+     *    instance, if it has one.
      *    n.b.: cells are considered contiguous if they have *one or more* vertices in common.
      *    See `healpix_utils` documentation for more details, and currently not handle edge cases.
+     *    In ensemble mode, the firing cells of all the instances are first reduced across the members, and only the
+     *    cells fired by enough members are turned into polygons, by the first member.
      * 3. Send notifications to Aviso. A notification consists of a single polygon for a single event.
      *    If there are two events, and for each two polygons were extracted, it will result in four notifications.
+     *    The payload carries the statistics of the values that fired within the polygon and within the whole
+     *    instance (maximum and its location, mean, firing area), computed from the values returned by the detection.
+     *    Each group of contiguous cells is matched to the groups of the previous step, and the payload carries its
+     *    stable identifier and lifecycle state. The events that ended are notified once more with their last polygons.
+     *    With `subscriptions`, each notification is tagged with the subscribers whose areas intersect its cells,
+     *    and also sent to the endpoints of these subscribers.
+     *    Notifications are only queued here, they are delivered by a background thread which journals and retries
+     *    the failed ones, so the model step does not wait for the Aviso server.
+     *    If a results file is configured, the firing cells and polygons are also appended to it, which allows
+     *    capturing the results of local runs without an Aviso server.
+     * 4. Append the wind at the configured sites to the site output, if enabled.
+     *
+     * With a `step_budget`, the time of each phase is measured. Once the budget of the step is spent, the polygons,
+     * notifications and results of the remaining instances are deferred to the next step, and after a step over
+     * budget the polygons of each instance are capped, the largest groups of cells first. Each decision is logged.
      *
-     * @todo Properly provide an alternative to Aviso notifications for local runs.
      * @todo Refine the content of the Aviso payload to contain more detailed information about the signal and how
      *       to retrieve the closest data for boundary conditions of downstream models.
      *
@@ -80,29 +129,181 @@ public:
      */
     void run() override;
 
+    /// Returns the number of function spaces mapped to HEALPix cells, the events on the same one share its mapping.
+    size_t mappedFunctionSpaces() const { return Point2HPcell_.size(); }
+
     /// Returns the plugin core type, for Plume usage.
     constexpr static const char* type() { return "ee-plugincore"; }
 
 private:
     std::vector<eckit::LocalConfiguration> extremeEventConfig_;
     std::vector<std::unique_ptr<ExtremeEvent>>
-        extremeEvents_;  ///< A single plugin manages all instances of different extreme events
+        extremeEvents_;                    ///< A single plugin manages all instances of different extreme events
+    std::vector<std::string> eventNames_;  ///< Registry name of each loaded event
+
+    eckit::LocalConfiguration overrideConfig_;                   ///< Threshold override file options, empty if unused
+    std::unique_ptr<ThresholdOverrideWatcher> overrideWatcher_;  ///< Watches the threshold override file
+    uint64_t overridesVersion_ = 0;                              ///< Version of the overrides applied to the events
 
     AvisoNotificationHandler notificationHandler_;
     bool enableNotification_;
+    std::string notificationJournal_;                   ///< Path of the journal of the undelivered notifications
+    RetryPolicy retryPolicy_;                           ///< Retry behaviour of the undelivered notifications
+    std::unique_ptr<NotificationDispatcher> notifier_;  ///< Delivers the notifications from a background thread
+    std::unique_ptr<SubscriptionIndex> subscriptions_;  ///< Routes the notifications to their subscribers, if any
+
+    std::string resultsFile_;                   ///< Path of the local results file, suffixed with the rank if needed
+    std::unique_ptr<ResultsSink> resultsSink_;  ///< Local results file, independent of the notifications
+
+    std::unique_ptr<SiteWindOutput> siteOutput_;  ///< Wind time series at given sites, independent of the events
+
+    std::unique_ptr<EnsembleReducer> ensemble_;  ///< Exceedance probability across ensemble members, if configured
+
+    double trackingDistance_ = 0.0;          ///< Maximum centroid distance matching events without common cells, km
+    std::unique_ptr<EventTracker> tracker_;  ///< Follows the events across the steps, when this member outputs
+
+    /// What an instance outputs at a step, kept as is when its output is deferred to the next step.
+    struct InstanceOutput {
+        std::string step;
+        uint32_t event, instance;
+        size_t level;  ///< HEALPix level of the cells
+        std::string description, param, levtype, levelist, quantity;
+        std::vector<int> cells;
+        std::vector<std::vector<int>> groups;  ///< Contiguous groups of cells, each with its track and statistics
+        std::vector<EventTracker::Track> tracks;
+        std::vector<EventStatistics> groupStats;
+        EventStatistics instanceStats;  ///< Over all the partitions
+        std::vector<EventTracker::Track> died;  ///< Events of the previous step that ended, with their last cells
+    };
+
+    std::unique_ptr<StepBudget> budget_;   ///< Degrades the output of the steps over budget, if configured
+    std::deque<InstanceOutput> deferred_;  ///< Outputs deferred to the next step by the budget
+
+    std::string recordFile_;                    ///< Path of the snapshot file, suffixed with the rank if needed
+    std::unique_ptr<SnapshotWriter> recorder_;  ///< Records the model data of each step for offline replay
 
-    int healpixRes_;
-    std::vector<int> Point2HPcell_;                                ///< Mapping from point index to HEALPix cell index
-    std::vector<std::vector<atlas::PointLonLat>> HPcell2polygon_;  ///< Mapping from HEALPix cell index to vertices
+    /// Mapping from the point index of a function space to the HEALPix cell index.
+    struct PointCellMapping {
+        atlas::FunctionSpace functionSpace;  ///< Kept alive, so that its address identifies it while it is cached
+        std::vector<int> pointToCell;          ///< Cells of the finest level
+        CellSlots slots;                       ///< Cells of the partition numbered locally, finest level
+        std::vector<CoarseSlots> coarseSlots;  ///< Slots of the coarser levels, folded from `slots`
+        std::vector<SharedSlots> sharedSlots;  ///< Cells of the slots shared with other partitions, for each level
+    };
+
+    /// HEALPix cells at one resolution, only the finest level is mapped from the grid points, the others from its cells
+    struct HEALPixLevel {
+        int resolution;
+        std::vector<int> fromFinest;                   ///< Cell of each cell of the finest level, global mesh
+        std::unordered_map<int, int> localFromFinest;  ///< Cell of each cell of the finest level, local mesh
+        std::vector<std::vector<atlas::PointLonLat>> vertices;  ///< Mapping from HEALPix cell index to vertices
+        HEALPixUtils::CellVertexMap localVertices;              ///< Vertices of the partition cells, local mesh
+        HEALPixUtils::CellSearch search;                        ///< Cell centres of the global mesh, reused
+    };
+
+    int healpixRes_;     ///< Resolution of the events without their own `healpix_res`
+    bool healpixLocal_;  ///< Whether only the partition cells are generated
+    std::unordered_map<const atlas::FunctionSpace::Implementation*, PointCellMapping>
+        Point2HPcell_;  ///< Mappings keyed by function space, shared by the events on the same function space
+    std::vector<const PointCellMapping*> eventPoint2HPcell_;  ///< Mapping of the function space of each event
+    std::vector<int> eventResolution_;                        ///< HEALPix resolution of each event
+    std::vector<size_t> eventLevel_;                          ///< HEALPix level of each event
+    std::vector<HEALPixLevel> levels_;                        ///< Resolutions used by the events, the finest first
+    PolygonCache polygonCache_;                               ///< Polygons of the recently fired groups of cells
+    std::vector<SubscriptionIndex> coarseSubscriptions_;      ///< Subscribers of the cells of the coarser levels
 
     /**
      * @brief Fills out the mapping matrices for coarsening regions where an extreme event is detected.
      *
      * These mapping matrices are contain only the subset of points managed by the partition. But each partition
-     * creates a global HEALPix mesh to perform the mapping.
+     * creates a global HEALPix mesh to perform the mapping, unless `healpix_mesh` is `local`, in which case the
+     * HEALPix mesh is distributed like the model and each partition only keeps the vertices of its own cells.
+     *
+     * The points of an event are mapped on the function space of its first required field, so events on different
+     * grids or function spaces can be mixed. Each function space is only mapped once, when the first event using it
+     * is found, and its mapping is shared with the following events.
+     *
+     * The points are only mapped at the finest resolution of the events. Each coarser resolution maps the cells of
+     * the finest level to their parent cells, so the cells of an event are derived from the finest cells at detection.
+     *
+     * @throws eckit::BadParameter if a resolution is not the finest one divided by a power of two.
      */
     void setHEALPixMapping();
 
+    /// Returns the cell of a level containing a cell of the finest level, -1 if the cell is unknown.
+    int cellAtLevel(size_t level, int cell) const;
+
+    /// Returns the sorted cells of a level containing the given sorted cells of the finest level.
+    std::vector<int> cellsAtLevel(const std::vector<int>& cells, size_t level) const;
+
+    /**
+     * @brief Returns the point to cell mapping of a function space, built at the first request.
+     *
+     * With the local HEALPix mesh, the vertices of the new cells are added to the vertices known to the partition.
+     *
+     * @note Building a mapping can be collective, so the function spaces must be requested in the same order on
+     *       all the ranks.
+     */
+    const PointCellMapping& pointToCellMapping(const atlas::FunctionSpace& fs);
+
+    /**
+     * @brief Returns the polygons of a group of contiguous cells, from the cache if the same cells fired recently.
+     *
+     * The polygons stay valid until the next call.
+     */
+    const PolygonCache::Polygons& polygonsOf(const std::vector<int>& cells, size_t level);
+
+    /**
+     * @brief Returns the statistics of the firing cells of each instance over all the partitions.
+     *
+     * The maximum is located by the partition holding it, and a cell holding points of several partitions counts
+     * once in the area. This is collective over the model communicator.
+     *
+     * @param[in] results The detections of each event.
+     * @param[in] firingCells The firing cells of each instance, in the order of the events and of their instances.
+     * @param[out] cellStats The statistics of the points of the partition in each firing cell, for each instance.
+     */
+    std::vector<EventStatistics> instanceStatistics(
+        const std::vector<std::vector<ExtremeEvent::DetectionData>>& results,
+        const std::vector<std::vector<int>>& firingCells,
+        std::vector<std::unordered_map<int, EventStatistics>>& cellStats) const;
+
+    /**
+     * @brief Extracts the polygons of an instance, and sends them to the notifications and the results file.
+     *
+     * The number of polygons is capped by the step budget, if it is capping, the largest groups of cells first.
+     */
+    void output(InstanceOutput& out);
+
+    /**
+     * @brief Posts a notification to the main endpoint and to the endpoints of the subscribers of its cells.
+     *
+     * @param payload The complete payload of the notification, already tagged with its subscribers.
+     * @param polygon The polygon of the notification.
+     * @param subscribers The subscribers of the cells the polygon was extracted from.
+     * @param level The HEALPix level of the cells.
+     */
+    void notify(const std::string& payload, const std::vector<atlas::PointLonLat>& polygon,
+                const std::vector<size_t>& subscribers, size_t level);
+
+    /**
+     * @brief Returns the vertices of a HEALPix cell at a level, none if the cell is unknown to this partition.
+     *
+     * @param level The HEALPix level of the cell.
+     * @param cell The HEALPix cell.
+     * @return The vertices of the cell.
+     */
+    const std::vector<atlas::PointLonLat>& cellVertices(size_t level, int cell) const;
+
+    /**
+     * @brief Applies the latest threshold overrides to the events, if they changed since the previous step.
+     *
+     * The overrides are read by the watching thread, this only swaps them in once all the ranks hold the same
+     * version. An event rejecting its overrides keeps its previous options, the error is logged and the run
+     * continues. This is collective over the model communicator.
+     */
+    void applyThresholdOverrides();
+
     /**
      * @brief Returns the MARS value string representing the sub-hourly model step.
      *
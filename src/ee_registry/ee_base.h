@@ -10,12 +10,16 @@
  */
 #ifndef EE_BASE_H
 #define EE_BASE_H
+#include <algorithm>
+#include <limits>
 #include <string>
 #include <vector>
 
+#include "eckit/config/LocalConfiguration.h"
 #include "plume/data/ModelData.h"
 
 #include "../plugin_types.h"
+#include "../region_utils.h"
 
 /**
  * @class ExtremeEvent
@@ -29,6 +33,78 @@ protected:
     std::vector<std::string> requiredParams_;
     std::vector<std::string> requiredFields_;
 
+    /// Regions of interest of the instances, the first set is empty and stands for the whole partition
+    std::vector<std::vector<RegionUtils::Region>> regionSets_;
+    /// Sorted indices of the owned points inside each set of regions, resolved at setup
+    std::vector<std::vector<atlas::idx_t>> regionPoints_;
+
+    /**
+     * @brief Checks that the required fields are all supported by the event.
+     *
+     * @param supported The names of the fields the event supports.
+     * @param type The type of the event, for the error message.
+     *
+     * @throws eckit::BadValue if a required field is not supported.
+     */
+    template <typename Fields>
+    void checkSupportedFields(const Fields& supported, const std::string& type) const {
+        for (const auto& field : requiredFields_) {
+            if (std::find(supported.begin(), supported.end(), field) == supported.end()) {
+                throw eckit::BadValue("The field '" + field + "' is not supported, please correct '" + type +
+                                          "' event configuration.",
+                                      Here());
+            }
+        }
+    }
+
+    /**
+     * @brief Adds the regions of interest of an instance, and returns the index of its set of regions.
+     *
+     * The instances without regions share the first set, which is empty and created by the first call.
+     */
+    size_t addRegionSet(const eckit::LocalConfiguration& instanceConfig) {
+        if (regionSets_.empty()) {
+            regionSets_.emplace_back();
+        }
+        auto regions = RegionUtils::regionsFromConfig(instanceConfig);
+        if (regions.empty()) {
+            return 0;
+        }
+        regionSets_.push_back(std::move(regions));
+        return regionSets_.size() - 1;
+    }
+
+    /// Resolves each set of regions into the owned points it contains, on the function space of the first field.
+    void resolveRegionPoints(plume::data::ModelData& modelData) {
+        auto fs = modelData.getAtlasFieldShared(requiredFields_[0]).functionspace();
+        regionPoints_.clear();
+        for (const auto& regions : regionSets_) {
+            regionPoints_.push_back(RegionUtils::ownedPointsInRegions(fs, regions));
+        }
+    }
+
+    /**
+     * @brief Returns the first required field, whose datatype selects the detection kernels.
+     *
+     * The precision is decided by the model, all the required fields are expected to share it.
+     *
+     * @param modelData The model data offered through Plume.
+     * @param type The type of the event, for the error message.
+     *
+     * @throws eckit::BadValue if the required fields have different datatypes.
+     */
+    const atlas::Field& precisionField(plume::data::ModelData& modelData, const std::string& type) const {
+        const auto& refField = modelData.getAtlasFieldShared(requiredFields_[0]);
+        for (const auto& field : requiredFields_) {
+            if (modelData.getAtlasFieldShared(field).datatype() != refField.datatype()) {
+                throw eckit::BadValue("Fields '" + requiredFields_[0] + "' and '" + field + "' have different " +
+                                          "datatypes, '" + type + "' requires a single precision.",
+                                      Here());
+            }
+        }
+        return refField;
+    }
+
 public:
     /// Default constructor.
     ExtremeEvent() = default;
@@ -59,17 +135,71 @@ public:
     /// Virtual destructor.
     virtual ~ExtremeEvent() = default;
 
+    /**
+     * @brief Decides which HEALPix cells fire from the detected points they contain.
+     *
+     * By default a single detected point fires its cell. An instance can require several detected points in a cell,
+     * a fraction of the points of the cell, or a mean of the detected values, so that isolated points do not fire
+     * whole cells. A cell holding points of several partitions is judged on the points of all of them.
+     */
+    struct CellCriterion {
+        int minPoints      = 1;                                       ///< Minimum number of detected points
+        double minFraction = 0.0;                                     ///< Minimum fraction of the points detected
+        double minMean     = std::numeric_limits<double>::lowest();  ///< Minimum mean of the detected values
+
+        /// Whether the cells need more than one detected point to fire.
+        bool aggregates() const {
+            return minPoints > 1 || minFraction > 0.0 || minMean > std::numeric_limits<double>::lowest();
+        }
+
+        /**
+         * @brief Reads the `cell_criterion` options of an instance (`min_points`, `min_fraction`, `min_mean`).
+         *
+         * @throws eckit::BadParameter if the number of points is not positive or the fraction is not in [0, 1].
+         */
+        static CellCriterion fromConfig(const eckit::LocalConfiguration& instanceConfig) {
+            CellCriterion criterion;
+            if (!instanceConfig.has("cell_criterion")) {
+                return criterion;
+            }
+            auto options          = instanceConfig.getSubConfiguration("cell_criterion");
+            criterion.minPoints   = options.getInt("min_points", criterion.minPoints);
+            criterion.minFraction = options.getDouble("min_fraction", criterion.minFraction);
+            criterion.minMean     = options.getDouble("min_mean", criterion.minMean);
+            if (criterion.minPoints < 1 || criterion.minFraction < 0.0 || criterion.minFraction > 1.0) {
+                throw eckit::BadParameter(
+                    "The 'cell_criterion' requires 'min_points' >= 1 and 'min_fraction' in [0, 1]", Here());
+            }
+            return criterion;
+        }
+    };
+
     /**
      * @brief A structure that represents the result of detecting the extreme event.
      * 
      * This information can later be used to build an Aviso request allowing the receiver to create a MARS request
-     * to retrieve the relevant data regarding the detected event.
+     * to retrieve the relevant data regarding the detected event. Events can also return the value that fired at
+     * each detected point, from which the plugin derives the statistics added to the notifications.
      */
     struct DetectionData {
         std::vector<int> detectedPoints;
         std::string description, param, levtype, levelist;
+        std::vector<float> detectedValues;  ///< Value at each detected point, empty if the event does not report it
+        std::string quantity;               ///< Name of the quantity of the values, e.g. `wind_speed`
+        CellCriterion cellCriterion;        ///< How the detected points fire their HEALPix cells
     };
 
+    /**
+     * @brief Prepares the event for detection once the model data is available.
+     *
+     * This is called once by the plugin after the event is constructed and before the first detection. Events can
+     * override it to precompute anything that depends on the model grid or its partitioning, so that this work is
+     * not repeated at every time step.
+     *
+     * @param modelData The model data offered through Plume (parameters and Atlas fields).
+     */
+    virtual void setup(plume::data::ModelData& /*modelData*/) {}
+
     /**
      * @brief Runs the detection algorithm on the provided model data (once per model internal time step).
      *
@@ -88,6 +218,24 @@ public:
      */
     virtual std::vector<DetectionData> detect(plume::data::ModelData& modelData) = 0;
 
+    /**
+     * @brief Replaces options of the instances while the model runs, e.g. their bounds.
+     *
+     * This is called by the plugin between two detections when the threshold override file changes. Each call
+     * gives the complete set of overrides of the event, the instances that are not listed return to their configured
+     * options. Events that support overrides validate all of them before applying any.
+     *
+     * @param overrides The overridden options, each with the `instance` index (from 0) in the event configuration.
+     *
+     * @throws eckit::BadValue if the event does not support overrides or an override is invalid, the options of the
+     *         instances are then left unchanged.
+     */
+    virtual void overrideInstances(const std::vector<eckit::LocalConfiguration>& overrides) {
+        if (!overrides.empty()) {
+            throw eckit::BadValue("This event does not support instance overrides", Here());
+        }
+    }
+
     /// Getters
     std::vector<std::string> requiredParams() const { return requiredParams_; }
     std::vector<std::string> requiredFields() const { return requiredFields_; }
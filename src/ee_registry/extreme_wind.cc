@@ -9,6 +9,8 @@
  * does it submit to any jurisdiction.
  */
 #include <algorithm>
+#include <map>
+#include <memory>
 #include <sstream>
 #include <unordered_map>
 
@@ -17,21 +19,40 @@
 #include "atlas/functionspace.h"
 #include "eckit/exception/Exceptions.h"
 
+#include "../threshold_field.h"
 #include "extreme_wind.h"
+#include "wind_kernels.h"
+
+namespace {
+
+/// Returns the description of an instance followed by its bounds, the fields of each interval are appended to it.
+std::string describeBounds(const std::string& description, double lBound, double uBound,
+                           const std::string& thresholdFile, double runQuantile) {
+    std::ostringstream bounds;
+    bounds << description;
+    if (runQuantile > 0.0) {
+        bounds << " (threshold : per point quantile " << std::to_string(runQuantile) << " of the run";
+    }
+    else if (!thresholdFile.empty()) {
+        bounds << " (threshold : per point from '" << thresholdFile << "'";
+    }
+    else if (lBound > uBound) {
+        bounds << " (threshold : " << std::to_string(lBound) << " m/s)";
+    }
+    else {
+        bounds << " (lower bound : " << std::to_string(lBound) << " m/s, upper bound : " << std::to_string(uBound)
+               << " m/s";
+    }
+    return bounds.str();
+}
+
+}  // namespace
 
 const std::string ExtremeWind::type_                           = "extreme_wind";
 const std::array<std::string, 6> ExtremeWind::supportedFields_ = {"100u", "100v", "10u", "10v", "u", "v"};
 
 ExtremeWind::ExtremeWind(const eckit::LocalConfiguration& config) : ExtremeEvent(config) {
-    // Validate that all required fields are named like wind fields
-    for (const auto& field : requiredFields_) {
-        if (std::find(supportedFields_.begin(), supportedFields_.end(), field) == supportedFields_.end()) {
-            throw eckit::BadValue(
-                "The field '" + field +
-                    "' is not a supported wind field, please correct 'extreme_wind' event configruation.",
-                Here());
-        }
-    }
+    checkSupportedFields(supportedFields_, type_);
 
     // Retrieve the wind intervals to run detection on and their description if applicable
     auto findField = [this](const std::string& field) {
@@ -39,20 +60,36 @@ ExtremeWind::ExtremeWind(const eckit::LocalConfiguration& config) : ExtremeEvent
     };
 
     for (const auto& eventConfig : config.getSubConfigurations("instances")) {
+        const size_t regionSet = addRegionSet(eventConfig);
+
         if (eventConfig.isIntegralList("heights") && !eventConfig.getIntVector("heights").empty()) {
             throw eckit::BadParameter(
                 "Detecting extreme wind at given heights is not currently supported, please remove from config.");
         }
 
-        std::ostringstream description;
-        description << eventConfig.getString("description");
-        if (eventConfig.getDouble("lower_bound") > eventConfig.getDouble("upper_bound")) {
-            description << " (threshold : " << std::to_string(eventConfig.getDouble("lower_bound")) << " m/s)";
+        // Per-point thresholds replace the bounds, they are read from the file at setup or estimated during the run
+        const std::string thresholdFile = eventConfig.getString("threshold_file", "");
+        const double runQuantile        = eventConfig.getDouble("run_quantile", 0.0);
+        const int warmup                = eventConfig.getInt("quantile_warmup", 24);
+        if (eventConfig.has("run_quantile")) {
+            if (!thresholdFile.empty()) {
+                throw eckit::BadParameter("'run_quantile' and 'threshold_file' cannot be used together", Here());
+            }
+            if (!(runQuantile > 0.0 && runQuantile < 1.0) || warmup < 5) {
+                throw eckit::BadParameter("'run_quantile' must be in (0, 1) and 'quantile_warmup' at least 5", Here());
+            }
         }
-        else {
-            description << " (lower bound : " << std::to_string(eventConfig.getDouble("lower_bound"))
-                        << " m/s, upper bound : " << std::to_string(eventConfig.getDouble("upper_bound")) << " m/s";
+        double lBound = 0.0;
+        double uBound = 0.0;
+        if (thresholdFile.empty() && runQuantile == 0.0) {
+            lBound = eventConfig.getDouble("lower_bound");
+            uBound = eventConfig.getDouble("upper_bound");
         }
+        const auto cellCriterion = CellCriterion::fromConfig(eventConfig);
+        const size_t instance    = instanceDescriptions_.size();
+        instanceDescriptions_.push_back(eventConfig.getString("description"));
+        const std::string description =
+            describeBounds(instanceDescriptions_.back(), lBound, uBound, thresholdFile, runQuantile);
 
         std::ostringstream fieldDesc;
         if (eventConfig.isIntegralList("model_levels")) {
@@ -77,8 +114,9 @@ ExtremeWind::ExtremeWind(const eckit::LocalConfiguration& config) : ExtremeEvent
                 else {
                     fieldDesc << "s : ('u','v'))";
                 }
-                intervals_.push_back({eventConfig.getDouble("lower_bound"), eventConfig.getDouble("upper_bound"), -1,
-                                      ml, u, v, description.str() + fieldDesc.str()});
+                intervals_.push_back({lBound, uBound, -1, ml, u, v, description + fieldDesc.str(), regionSet,
+                                      thresholdFile, instance, fieldDesc.str(), cellCriterion, runQuantile,
+                                      static_cast<size_t>(warmup)});
             }
         }
         else {
@@ -105,8 +143,9 @@ ExtremeWind::ExtremeWind(const eckit::LocalConfiguration& config) : ExtremeEvent
                 else {
                     fieldDesc << "s : ('" << cpnt.first << "','" << cpnt.second << "'))";
                 }
-                intervals_.push_back({eventConfig.getDouble("lower_bound"), eventConfig.getDouble("upper_bound"), -1, 0,
-                                      cpnt.first, cpnt.second, description.str() + fieldDesc.str()});
+                intervals_.push_back({lBound, uBound, -1, 0, cpnt.first, cpnt.second, description + fieldDesc.str(),
+                                      regionSet, thresholdFile, instance, fieldDesc.str(), cellCriterion, runQuantile,
+                                      static_cast<size_t>(warmup)});
             }
         }
     }
@@ -116,52 +155,149 @@ ExtremeWind::ExtremeWind(const eckit::LocalConfiguration& config) : ExtremeEvent
         throw eckit::BadValue("No valid instance found for 'extreme_wind', ensure options and required fields align",
                               Here());
     }
+    configuredIntervals_ = intervals_;
+}
+
+void ExtremeWind::setup(plume::data::ModelData& modelData) {
+    resolveRegionPoints(modelData);
+    auto fs = modelData.getAtlasFieldShared(requiredFields_[0]).functionspace();
+
+    // Each file is mapped once, and only the thresholds at the points of interest of the partition are kept
+    std::map<std::string, std::unique_ptr<ThresholdUtils::ThresholdField>> thresholdFiles;
+    thresholds_.assign(intervals_.size(), {});
+    sketches_.clear();
+    sketches_.resize(intervals_.size());
+    for (size_t idx_int = 0; idx_int < intervals_.size(); idx_int++) {
+        const auto& interval = intervals_[idx_int];
+        if (interval.runQuantile > 0.0) {
+            // Each point of interest keeps a sketch of constant size, whatever the length of the run
+            sketches_[idx_int] =
+                std::make_unique<QuantileSketch>(interval.runQuantile, regionPoints_[interval.regionSet].size());
+            continue;
+        }
+        if (interval.thresholdFile.empty()) {
+            continue;
+        }
+        auto& file = thresholdFiles[interval.thresholdFile];
+        if (!file) {
+            file = std::make_unique<ThresholdUtils::ThresholdField>(interval.thresholdFile);
+        }
+        // Model levels start at 1, surface fields use the first level of the file
+        size_t level         = interval.modelLevel > 0 ? interval.modelLevel - 1 : 0;
+        thresholds_[idx_int] = file->slice(fs, regionPoints_[interval.regionSet], level);
+    }
 }
 
 std::vector<ExtremeEvent::DetectionData> ExtremeWind::detect(plume::data::ModelData& modelData) {
+    ASSERT_MSG(regionPoints_.size() == regionSets_.size() && thresholds_.size() == intervals_.size() &&
+                   sketches_.size() == intervals_.size(),
+               "'extreme_wind' detection requires the event to be set up");
     std::vector<DetectionData> ee_points;
     for (const auto& interval : intervals_) {
         std::string level = interval.modelLevel > 0 ? "ml" : "sfc";
         std::string param = interval.u.empty()   ? interval.v
                             : interval.v.empty() ? interval.u
                                                  : interval.u + "/" + interval.v;
-        ee_points.push_back({{}, interval.description, param, level, std::to_string(interval.modelLevel)});
-    }
-    std::unordered_map<std::string, std::unique_ptr<atlas::array::ArrayView<const FIELD_TYPE_REAL, 2>>> windFields;
-    auto halo =
-        atlas::array::make_view<int, 1>(modelData.getAtlasFieldShared(requiredFields_[0]).functionspace().ghost());
-    int nbOfValues = modelData.getAtlasFieldShared(requiredFields_[0]).shape(0);
-    for (const auto& windField : requiredFields_) {
-        windFields[windField] = std::make_unique<atlas::array::ArrayView<const FIELD_TYPE_REAL, 2>>(
-            atlas::array::make_view<const FIELD_TYPE_REAL, 2>(modelData.getAtlasFieldShared(windField)));
+        ee_points.push_back({{}, interval.description, param, level, std::to_string(interval.modelLevel), {},
+                             "wind_speed", interval.cellCriterion});
     }
 
-    for (atlas::idx_t idx = 0; idx < nbOfValues; idx++) {
-        // Skip the halo
-        if (halo(idx) > 0) {
-            continue;
-        }
+    dispatchFieldType(precisionField(modelData, type_),
+                      [&](auto tag) { detectWithType<decltype(tag)>(modelData, ee_points); });
+    return ee_points;
+}
 
-        for (size_t idx_int = 0; idx_int < intervals_.size(); idx_int++) {
-            // If it is not a surface field we remove 1 from the index as model levels start at 1 and not 0
-            int levelIdx = intervals_[idx_int].modelLevel > 0 ? intervals_[idx_int].modelLevel - 1 : 0;
-            FIELD_TYPE_REAL valU =
-                intervals_[idx_int].u.empty() ? 0 : (*windFields[intervals_[idx_int].u])(idx, levelIdx);
-            FIELD_TYPE_REAL valV =
-                intervals_[idx_int].v.empty() ? 0 : (*windFields[intervals_[idx_int].v])(idx, levelIdx);
-            FIELD_TYPE_REAL windMagnitude = std::sqrt(valU * valU + valV * valV);
-            if (windMagnitude < intervals_[idx_int].lBound) {
+void ExtremeWind::overrideInstances(const std::vector<eckit::LocalConfiguration>& overrides) {
+    // The overrides are applied to a copy, so that an invalid one leaves the current intervals unchanged
+    auto intervals = configuredIntervals_;
+    for (const auto& instanceOverride : overrides) {
+        const auto instance = static_cast<size_t>(instanceOverride.getInt("instance"));
+        if (instance >= instanceDescriptions_.size()) {
+            throw eckit::BadValue("'extreme_wind' has no instance " + std::to_string(instance) + ", it has " +
+                                      std::to_string(instanceDescriptions_.size()) + " instances",
+                                  Here());
+        }
+        const bool overridesBounds = instanceOverride.has("lower_bound") || instanceOverride.has("upper_bound");
+        for (auto& interval : intervals) {
+            if (interval.instance != instance) {
                 continue;
             }
-            if (intervals_[idx_int].lBound > intervals_[idx_int].uBound || windMagnitude < intervals_[idx_int].uBound) {
-                // /!\ if the upper bound is lower than the lower bound then we check
-                // only if the wind exceeds the lower bound
-                // if the upper bound is higher, then we check for belonging
-                ee_points[idx_int].detectedPoints.push_back(idx);
+            if (overridesBounds && (!interval.thresholdFile.empty() || interval.runQuantile > 0.0)) {
+                throw eckit::BadValue("The bounds of the 'extreme_wind' instance " + std::to_string(instance) +
+                                          " cannot be overridden, it uses per point thresholds",
+                                      Here());
             }
+            interval.lBound = instanceOverride.getDouble("lower_bound", interval.lBound);
+            interval.uBound = instanceOverride.getDouble("upper_bound", interval.uBound);
+            interval.description =
+                describeBounds(instanceOverride.getString("description", instanceDescriptions_[instance]),
+                               interval.lBound, interval.uBound, interval.thresholdFile, interval.runQuantile) +
+                interval.fieldDescription;
         }
     }
-    return ee_points;
+    intervals_.swap(intervals);
+}
+
+template <typename T>
+void ExtremeWind::detectWithType(plume::data::ModelData& modelData, std::vector<DetectionData>& ee_points) {
+    std::unordered_map<std::string, atlas::array::ArrayView<const T, 2>> windFields;
+    for (const auto& windField : requiredFields_) {
+        windFields.emplace(windField, atlas::array::make_view<const T, 2>(modelData.getAtlasFieldShared(windField)));
+    }
+
+    // Scratch buffers reused by every interval, the magnitude is computed over all the points of interest in one pass
+    size_t maxPoints = 0;
+    for (const auto& points : regionPoints_) {
+        maxPoints = std::max(maxPoints, points.size());
+    }
+    std::vector<T> windMagnitude(maxPoints);
+    std::vector<unsigned char> exceeds(maxPoints);
+    for (size_t idx_int = 0; idx_int < intervals_.size(); idx_int++) {
+        const auto& interval = intervals_[idx_int];
+        // If it is not a surface field we remove 1 from the index as model levels start at 1 and not 0
+        int levelIdx = interval.modelLevel > 0 ? interval.modelLevel - 1 : 0;
+
+        const T* valU       = nullptr;
+        const T* valV       = nullptr;
+        atlas::idx_t stride = 0;
+        if (!interval.u.empty()) {
+            const auto& view = windFields.at(interval.u);
+            valU             = view.data() + levelIdx * view.stride(1);
+            stride           = view.stride(0);
+        }
+        if (!interval.v.empty()) {
+            const auto& view = windFields.at(interval.v);
+            valV             = view.data() + levelIdx * view.stride(1);
+            stride           = view.stride(0);
+        }
+        // Owned points within the regions of interest, the halo is already excluded
+        const auto& points    = regionPoints_[interval.regionSet];
+        const auto nbOfPoints = static_cast<atlas::idx_t>(points.size());
+        WindKernels::windMagnitude(valU, valV, stride, points.data(), nbOfPoints, windMagnitude.data());
+        if (auto& sketch = sketches_[idx_int]) {
+            // The wind is compared to the quantile of the previous steps, then added to it
+            if (sketch->count() >= interval.warmup) {
+                WindKernels::selectAboveThresholds(windMagnitude.data(), sketch->estimates(), points.data(),
+                                                   nbOfPoints, exceeds.data(), ee_points[idx_int].detectedPoints,
+                                                   &ee_points[idx_int].detectedValues);
+            }
+            sketch->update(windMagnitude.data());
+            continue;
+        }
+        if (!thresholds_[idx_int].empty()) {
+            // Per-point thresholds, aligned with the points of interest at setup
+            WindKernels::selectAboveThresholds(windMagnitude.data(), thresholds_[idx_int].data(), points.data(),
+                                               nbOfPoints, exceeds.data(), ee_points[idx_int].detectedPoints,
+                                               &ee_points[idx_int].detectedValues);
+            continue;
+        }
+        // /!\ if the upper bound is lower than the lower bound then we check
+        // only if the wind exceeds the lower bound
+        // if the upper bound is higher, then we check for belonging
+        WindKernels::selectInInterval(windMagnitude.data(), points.data(), nbOfPoints,
+                                      static_cast<T>(interval.lBound), static_cast<T>(interval.uBound),
+                                      ee_points[idx_int].detectedPoints, &ee_points[idx_int].detectedValues);
+    }
 }
 
 ExtremeWind::Registrar ExtremeWind::registrar;
@@ -9,6 +9,7 @@
  * does it submit to any jurisdiction.
  */
 #include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -16,6 +17,7 @@
 #include "plume/data/ModelData.h"
 
 #include "ee_registry.h"
+#include "quantile_sketch.h"
 
 /**
  * @class ExtremeWind
@@ -38,9 +40,32 @@ private:
         double lBound, uBound;
         int height, modelLevel;
         std::string u, v, description;
+        size_t regionSet;              ///< Index of the set of regions of interest (and its point list) of the instance
+        std::string thresholdFile;     ///< File of per-point thresholds replacing the bounds, empty if not used
+        size_t instance;               ///< Index of the instance in the configuration
+        std::string fieldDescription;  ///< Part of the description naming the level and fields
+        CellCriterion cellCriterion;   ///< How the detected points fire their HEALPix cells
+        double runQuantile;            ///< Quantile of the wind of the run replacing the bounds, 0 if not used
+        size_t warmup;                 ///< Number of steps before the quantile is used, at least 5
     };
 
     std::vector<Interval> intervals_;
+    std::vector<Interval> configuredIntervals_;       ///< Intervals as configured, before any override
+    std::vector<std::string> instanceDescriptions_;  ///< Configured description of each instance
+
+    /// Per-point thresholds of each interval at the points of its regions, loaded at setup, empty for fixed bounds
+    std::vector<std::vector<float>> thresholds_;
+    /// Quantile of the wind of the run at the points of the regions of each interval, null if not used
+    std::vector<std::unique_ptr<QuantileSketch>> sketches_;
+
+    /**
+     * @brief Runs the detection on wind fields of value type `T`.
+     *
+     * @param modelData The model data that contains the wind fields to run detection on.
+     * @param results The detection results for each interval, filled in place.
+     */
+    template <typename T>
+    void detectWithType(plume::data::ModelData& modelData, std::vector<ExtremeEvent::DetectionData>& results);
 
 public:
     /**
@@ -55,10 +80,24 @@ public:
      */
     ExtremeWind(const eckit::LocalConfiguration& config);
 
+    /**
+     * @brief Resolves the regions of interest of each instance into the list of owned points they contain.
+     *
+     * Detection then only iterates over these lists, so its cost scales with the area of interest and the halo
+     * does not need to be tested at each step. The per-point thresholds of the instances using a threshold file are
+     * sliced at these points, so that each partition only reads its own part of the file.
+     *
+     * @param modelData The model data that contains the wind fields, only their function space is used.
+     */
+    void setup(plume::data::ModelData& modelData) override;
+
     /**
      * @brief Detects extreme winds at a given time step.
      *
      * This event checks whether the wind exceeds a certain threshold, or is between bounds, at a single time step.
+     * The threshold is either the same for all the points, or read per point from a threshold file.
+     * The kernel is selected from the datatype of the wind fields, which must all share the same precision.
+     * Only the owned points within the regions of interest of each instance are checked.
      *
      * @param modelData The model data that contains the wind fields to run detection on.
      *
@@ -66,6 +105,14 @@ public:
      */
     std::vector<ExtremeEvent::DetectionData> detect(plume::data::ModelData& modelData) override;
 
+    /**
+     * @brief Replaces the bounds and descriptions of instances while the model runs.
+     *
+     * The `lower_bound`, `upper_bound` and `description` keys of an override replace the configured ones for all
+     * the levels and fields of the instance. The bounds of instances using a threshold file cannot be overridden.
+     */
+    void overrideInstances(const std::vector<eckit::LocalConfiguration>& overrides) override;
+
     /// Register the extreme wind event into the registry so it can be used in the plugin.
     static struct Registrar {
         Registrar() {
@@ -0,0 +1,89 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <cmath>
+
+#include "eckit/exception/Exceptions.h"
+
+#include "power_curve.h"
+
+namespace {
+
+/// Largest table accepted, e.g. 100 m/s at 1 cm/s
+constexpr double maxTableSize = 1e4;
+
+}  // namespace
+
+PowerCurve::PowerCurve(const eckit::Configuration& config) {
+    const double resolution = config.getDouble("resolution", 0.1);
+    if (config.has("speeds") || config.has("capacity")) {
+        *this = PowerCurve(config.getDoubleVector("speeds"), config.getDoubleVector("capacity"), resolution);
+        return;
+    }
+    const double cutIn  = config.getDouble("cut_in");
+    const double rated  = config.getDouble("rated_speed");
+    const double cutOut = config.getDouble("cut_out");
+    if (cutIn < 0.0 || cutIn >= rated || rated > cutOut) {
+        throw eckit::BadParameter("The power curve requires 0 <= cut_in < rated_speed <= cut_out", Here());
+    }
+    const double cubeIn    = cutIn * cutIn * cutIn;
+    const double cubeRated = rated * rated * rated;
+    tabulate(
+        [=](double speed) {
+            if (speed < cutIn || speed >= cutOut) {
+                return 0.0;
+            }
+            return speed >= rated ? 1.0 : (speed * speed * speed - cubeIn) / (cubeRated - cubeIn);
+        },
+        cutOut, resolution);
+}
+
+PowerCurve::PowerCurve(const std::vector<double>& speeds, const std::vector<double>& capacity, double resolution) {
+    if (speeds.size() != capacity.size() || speeds.size() < 2) {
+        throw eckit::BadParameter("The power curve requires as many 'speeds' as 'capacity' values, at least two",
+                                  Here());
+    }
+    for (size_t i = 1; i < speeds.size(); ++i) {
+        if (speeds[i] < speeds[i - 1]) {
+            throw eckit::BadParameter("The power curve 'speeds' must be sorted", Here());
+        }
+    }
+    tabulate(
+        [&](double speed) {
+            // First tabulated speed strictly above, so that a step applies from its speed onwards
+            const auto upper = std::upper_bound(speeds.begin(), speeds.end(), speed);
+            if (upper == speeds.begin()) {
+                return capacity.front();
+            }
+            if (upper == speeds.end()) {
+                return capacity.back();
+            }
+            const size_t i    = upper - speeds.begin();
+            const double frac = (speed - speeds[i - 1]) / (speeds[i] - speeds[i - 1]);
+            return capacity[i - 1] + frac * (capacity[i] - capacity[i - 1]);
+        },
+        speeds.back(), resolution);
+}
+
+void PowerCurve::tabulate(const std::function<double(double)>& curve, double maxSpeed, double resolution) {
+    if (!(resolution > 0.0) || maxSpeed / resolution > maxTableSize) {
+        throw eckit::BadParameter("The power curve 'resolution' must be positive and give at most " +
+                                      std::to_string(static_cast<int>(maxTableSize)) + " table values",
+                                  Here());
+    }
+    // One sample past the last speed so that it is reached exactly, and the last value repeated for the interpolation
+    const size_t samples = static_cast<size_t>(std::ceil(maxSpeed / resolution)) + 2;
+    invSpacing_          = static_cast<float>(1.0 / resolution);
+    table_.resize(samples + 1);
+    for (size_t k = 0; k < samples; ++k) {
+        table_[k] = static_cast<float>(curve(k * resolution));
+    }
+    table_[samples] = table_[samples - 1];
+}
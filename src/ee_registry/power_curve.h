@@ -0,0 +1,86 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#ifndef POWER_CURVE_H
+#define POWER_CURVE_H
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "atlas/library/config.h"
+#include "eckit/config/Configuration.h"
+
+/**
+ * @class PowerCurve
+ * @brief Maps the wind speed to the capacity factor of a wind turbine (produced power over rated power).
+ *
+ * The curve is tabulated once at a uniform wind speed spacing, so that mapping a speed is an index computation and a
+ * linear interpolation between two table values, without searching or branching, which the compiler can vectorise.
+ * Discontinuities of the curve (e.g. the cut-out) are resolved to the spacing of the table.
+ */
+class PowerCurve {
+public:
+    /**
+     * @brief Builds the curve from its configuration.
+     *
+     * Either tabulated, with the lists `speeds` (m/s, non decreasing) and `capacity` (capacity factor at each speed),
+     * or parametric, with `cut_in`, `rated_speed` and `cut_out` (m/s), in which case the power grows with the cube of
+     * the speed from the cut-in to the rated speed, is rated up to the cut-out, and is null outside. The spacing of the
+     * table is `resolution` (m/s, default 0.1).
+     *
+     * @throws eckit::BadParameter if the curve is inconsistent.
+     */
+    explicit PowerCurve(const eckit::Configuration& config);
+
+    /**
+     * @brief Builds a tabulated curve.
+     *
+     * The capacity factor is linearly interpolated between the given speeds, it is the first capacity below the first
+     * speed and the last capacity above the last speed. Two equal speeds describe a step, e.g. the cut-out.
+     *
+     * @throws eckit::BadParameter if the lists have different or insufficient sizes or the speeds are not sorted.
+     */
+    PowerCurve(const std::vector<double>& speeds, const std::vector<double>& capacity, double resolution = 0.1);
+
+    /**
+     * @brief Computes the capacity factor at a list of wind speeds.
+     *
+     * Speeds beyond the table use its last value, negative or NaN speeds are considered calm.
+     *
+     * @param[in] speed The wind speeds.
+     * @param[in] size The number of speeds.
+     * @param[out] capacity The capacity factor at `speed[k]` is stored in `capacity[k]`, must hold `size` values.
+     */
+    template <typename T>
+    void capacityFactor(const T* speed, atlas::idx_t size, float* capacity) const {
+        const float* table  = table_.data();
+        const float maxPos  = static_cast<float>(table_.size() - 2);
+        const float scaling = invSpacing_;
+        for (atlas::idx_t k = 0; k < size; ++k) {
+            // std::max(0, NaN) is 0, so the index is always within the table
+            const float pos  = std::min(std::max(0.f, static_cast<float>(speed[k]) * scaling), maxPos);
+            const int idx    = static_cast<int>(pos);
+            const float frac = pos - static_cast<float>(idx);
+            capacity[k]      = table[idx] + frac * (table[idx + 1] - table[idx]);
+        }
+    }
+
+    /// Returns the spacing of the table in m/s.
+    double resolution() const { return 1.0 / invSpacing_; }
+
+private:
+    float invSpacing_;          ///< Inverse of the wind speed spacing of the table
+    std::vector<float> table_;  ///< Capacity factor at multiples of the spacing, the last value is repeated
+
+    /// Samples a curve from 0 to `maxSpeed` at the given spacing.
+    void tabulate(const std::function<double(double)>& curve, double maxSpeed, double resolution);
+};
+
+#endif  // POWER_CURVE_H
@@ -0,0 +1,104 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <algorithm>
+
+#include "eckit/exception/Exceptions.h"
+
+#include "quantile_sketch.h"
+
+QuantileSketch::QuantileSketch(double quantile, size_t points) :
+    quantile_(quantile), points_(points), heights_(5 * points), positions_(3 * points) {
+    if (!(quantile_ > 0.0 && quantile_ < 1.0)) {
+        throw eckit::BadParameter("The estimated quantile must be in (0, 1)", Here());
+    }
+    desired_   = {1.0, 1.0 + 2.0 * quantile_, 1.0 + 4.0 * quantile_, 3.0 + 2.0 * quantile_, 5.0};
+    increment_ = {0.0, quantile_ / 2.0, quantile_, (1.0 + quantile_) / 2.0, 1.0};
+    for (size_t m = 0; m < 3; ++m) {
+        std::fill(positions_.begin() + m * points_, positions_.begin() + (m + 1) * points_, static_cast<float>(m + 2));
+    }
+}
+
+template <typename T>
+void QuantileSketch::update(const T* values) {
+    if (count_ < 5) {
+        // The first values are the initial marker heights, sorted once the fifth one arrives
+        std::copy(values, values + points_, heights_.begin() + count_ * points_);
+        if (++count_ == 5) {
+            for (size_t k = 0; k < points_; ++k) {
+                std::array<float, 5> first;
+                for (size_t m = 0; m < 5; ++m) {
+                    first[m] = heights_[m * points_ + k];
+                }
+                std::sort(first.begin(), first.end());
+                for (size_t m = 0; m < 5; ++m) {
+                    heights_[m * points_ + k] = first[m];
+                }
+            }
+        }
+        return;
+    }
+    ++count_;
+    for (size_t m = 0; m < 5; ++m) {
+        desired_[m] += increment_[m];
+    }
+    const float last = static_cast<float>(count_);  // Position of the maximum marker, the minimum is at 1
+    float* q[5];
+    float* n[3];
+    for (size_t m = 0; m < 5; ++m) {
+        q[m] = heights_.data() + m * points_;
+    }
+    for (size_t m = 0; m < 3; ++m) {
+        n[m] = positions_.data() + m * points_;
+    }
+    for (size_t k = 0; k < points_; ++k) {
+        const float x = static_cast<float>(values[k]);
+        // Markers above the value move up by one position
+        if (x < q[0][k]) {
+            q[0][k] = x;
+        }
+        else if (x > q[4][k]) {
+            q[4][k] = x;
+        }
+        float h[5]   = {q[0][k], q[1][k], q[2][k], q[3][k], q[4][k]};
+        float pos[5] = {1.f, n[0][k], n[1][k], n[2][k], last};
+        for (size_t m = 1; m < 4; ++m) {
+            if (x < h[m]) {
+                pos[m] += 1.f;
+            }
+        }
+        // Inner markers more than a position away from their desired position move towards it
+        for (size_t m = 1; m < 4; ++m) {
+            const double offset = desired_[m] - pos[m];
+            if ((offset >= 1.0 && pos[m + 1] - pos[m] > 1.f) || (offset <= -1.0 && pos[m - 1] - pos[m] < -1.f)) {
+                const float d        = offset > 0.0 ? 1.f : -1.f;
+                const float above    = (pos[m] - pos[m - 1] + d) * (h[m + 1] - h[m]) / (pos[m + 1] - pos[m]);
+                const float below    = (pos[m + 1] - pos[m] - d) * (h[m] - h[m - 1]) / (pos[m] - pos[m - 1]);
+                const float parabola = h[m] + d / (pos[m + 1] - pos[m - 1]) * (above + below);
+                if (h[m - 1] < parabola && parabola < h[m + 1]) {
+                    h[m] = parabola;
+                }
+                else {
+                    // Linear interpolation towards the neighbouring marker when the parabola overshoots
+                    const size_t next = d > 0.f ? m + 1 : m - 1;
+                    h[m] += d * (h[next] - h[m]) / (pos[next] - pos[m]);
+                }
+                pos[m] += d;
+            }
+        }
+        for (size_t m = 1; m < 4; ++m) {
+            q[m][k]     = h[m];
+            n[m - 1][k] = pos[m];
+        }
+    }
+}
+
+template void QuantileSketch::update<float>(const float*);
+template void QuantileSketch::update<double>(const double*);
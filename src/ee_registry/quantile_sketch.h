@@ -0,0 +1,67 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class QuantileSketch
+ * @brief Estimates a quantile of the values seen so far at each of a set of points, in constant memory.
+ *
+ * Each point runs the P² algorithm (Jain and Chlamtac, 1985): five markers track the minimum, the maximum, the
+ * quantile and two intermediate quantiles, and their heights are adjusted with a piecewise parabolic interpolation as
+ * values arrive, without storing the values. The desired marker positions only depend on the number of values, so
+ * they are shared by all the points, and each point only keeps the five marker heights and the three inner marker
+ * positions, 32 bytes, whatever the length of the run. An update costs a few comparisons per point.
+ */
+class QuantileSketch {
+public:
+    /**
+     * @param quantile The quantile to estimate, in (0, 1).
+     * @param points The number of points.
+     *
+     * @throws eckit::BadParameter if the quantile is not in (0, 1).
+     */
+    QuantileSketch(double quantile, size_t points);
+
+    /**
+     * @brief Adds a value at each point.
+     *
+     * @param values The values, `values[k]` is the value at point `k`, must hold as many values as there are points.
+     */
+    template <typename T>
+    void update(const T* values);
+
+    /// Returns the estimate of the quantile at each point, valid once five values were added.
+    const float* estimates() const { return heights_.data() + 2 * points_; }
+
+    /// Returns the number of values added at each point.
+    size_t count() const { return count_; }
+
+    /// Returns the number of points.
+    size_t points() const { return points_; }
+
+    /// Returns the memory used by the sketch, in bytes.
+    size_t memory() const { return (heights_.size() + positions_.size()) * sizeof(float); }
+
+private:
+    double quantile_;
+    size_t points_;
+    size_t count_ = 0;
+    std::array<double, 5> desired_;    ///< Desired position of each marker, shared by all the points
+    std::array<double, 5> increment_;  ///< Increment of the desired positions at each value
+    std::vector<float> heights_;       ///< Marker heights, marker by marker, `heights_[m * points + k]`
+    std::vector<float> positions_;     ///< Positions of the three inner markers, `positions_[(m - 1) * points + k]`
+};
+
+#endif  // QUANTILE_SKETCH_H
@@ -0,0 +1,203 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#ifndef WIND_KERNELS_H
+#define WIND_KERNELS_H
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "atlas/library/config.h"
+
+/**
+ * @brief Detection kernels shared by the wind events.
+ *
+ * The kernels work on raw pointers to a single level of the model fields so that they do not depend on how the
+ * event retrieved the data, and they are templated on the field value type so that single precision fields are
+ * processed with single precision arithmetic.
+ */
+namespace WindKernels {
+
+/**
+ * @brief Computes the wind magnitude at a list of points of a single level.
+ *
+ * One of the components can be missing (null pointer), in which case the magnitude is the absolute value of the other.
+ * Each case has its own branch-free loop so the compiler can vectorise it.
+ *
+ * @param[in] u The first value of the u component at the requested level, or `nullptr`.
+ * @param[in] v The first value of the v component at the requested level, or `nullptr`.
+ * @param[in] stride The distance between two consecutive points in the component arrays (number of levels).
+ * @param[in] points The indices of the points to compute the magnitude at.
+ * @param[in] size The number of points.
+ * @param[out] magnitude The wind magnitude at `points[k]` is stored in `magnitude[k]`, must hold `size` values.
+ */
+template <typename T>
+void windMagnitude(const T* u, const T* v, atlas::idx_t stride, const atlas::idx_t* points, atlas::idx_t size,
+                   T* magnitude) {
+    if (u && v) {
+        for (atlas::idx_t k = 0; k < size; ++k) {
+            const T valU = u[points[k] * stride];
+            const T valV = v[points[k] * stride];
+            magnitude[k] = std::sqrt(valU * valU + valV * valV);
+        }
+    }
+    else if (u || v) {
+        const T* cpnt = u ? u : v;
+        for (atlas::idx_t k = 0; k < size; ++k) {
+            magnitude[k] = std::abs(cpnt[points[k] * stride]);
+        }
+    }
+    else {
+        for (atlas::idx_t k = 0; k < size; ++k) {
+            magnitude[k] = T(0);
+        }
+    }
+}
+
+/**
+ * @brief Appends the indices of the points whose value falls within the bounds.
+ *
+ * If the upper bound is lower than the lower bound, only the lower bound is checked (threshold), otherwise the value
+ * must belong to `[lBound, uBound)`.
+ *
+ * @param[in] values The values to check, `values[k]` is the value at `points[k]`.
+ * @param[in] points The indices of the points the values were computed at.
+ * @param[in] size The number of points.
+ * @param[in] lBound The lower bound.
+ * @param[in] uBound The upper bound.
+ * @param[out] detected The vector to which the indices of the detected points are appended.
+ * @param[out] detectedValues If not null, the vector to which the values of the detected points are appended, in the
+ *                            same pass, so that their statistics do not need the fields again.
+ */
+template <typename T>
+void selectInInterval(const T* values, const atlas::idx_t* points, atlas::idx_t size, T lBound, T uBound,
+                      std::vector<int>& detected, std::vector<float>* detectedValues = nullptr) {
+    const bool threshold = lBound > uBound;
+    for (atlas::idx_t k = 0; k < size; ++k) {
+        if (values[k] >= lBound && (threshold || values[k] < uBound)) {
+            detected.push_back(points[k]);
+            if (detectedValues) {
+                detectedValues->push_back(static_cast<float>(values[k]));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Appends the indices of the points whose value reaches their own threshold.
+ *
+ * The comparison runs over all the points in a branch-free loop that the compiler can vectorise, and the exceeding
+ * points, usually few, are gathered in a second pass. A NaN threshold never fires.
+ *
+ * @param[in] values The values to check, `values[k]` is the value at `points[k]`.
+ * @param[in] thresholds The thresholds, `thresholds[k]` is the threshold at `points[k]`.
+ * @param[in] points The indices of the points the values were computed at.
+ * @param[in] size The number of points.
+ * @param[out] exceeds Scratch buffer of the comparisons, must hold `size` values, reused by the caller across calls.
+ * @param[out] detected The vector to which the indices of the detected points are appended.
+ * @param[out] detectedValues If not null, the vector to which the values of the detected points are appended.
+ */
+template <typename T>
+void selectAboveThresholds(const T* values, const float* thresholds, const atlas::idx_t* points, atlas::idx_t size,
+                           unsigned char* exceeds, std::vector<int>& detected,
+                           std::vector<float>* detectedValues = nullptr) {
+    for (atlas::idx_t k = 0; k < size; ++k) {
+        exceeds[k] = values[k] >= static_cast<T>(thresholds[k]);
+    }
+    for (atlas::idx_t k = 0; k < size; ++k) {
+        if (exceeds[k]) {
+            detected.push_back(points[k]);
+            if (detectedValues) {
+                detectedValues->push_back(static_cast<float>(values[k]));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Returns the angle in degrees, within [0, 180], of the point (x, y) with y >= 0, i.e. `atan2(y, x)`.
+ *
+ * The arctangent of the ratio of the smaller to the larger coordinate is approximated by the odd polynomial of
+ * Abramowitz and Stegun (4.4.47) on [0, 1], whose absolute error is about 1e-5 rad (7e-4 degrees), then moved to
+ * its octant. The octant is chosen from the signs of `|x| - y` and `x` rather than by comparisons, which compilers
+ * do not turn into selections while floating point exceptions are honoured, so that the loops calling it vectorise.
+ * The angle of the origin is 0.
+ */
+template <typename T>
+inline T vectorAngle(T y, T x) {
+    const T absX  = std::abs(x);
+    const T small = std::min(absX, y);
+    const T large = std::max(absX, y);
+    // The smaller coordinate is 0 when the larger one is, the ratio of the origin is 0 without a test
+    const T ratio = small / std::max(large, std::numeric_limits<T>::min());
+    const T sq    = ratio * ratio;
+    const T poly  = (((T(0.0208351) * sq - T(0.0851330)) * sq + T(0.1801410)) * sq - T(0.3302995)) * sq;
+    const T acute = (poly + T(0.9998660)) * ratio;
+    // -1 above the diagonal, where the angle is pi/2 - acute, and -1 left of the y axis, where it is pi - angle. The
+    // sum with 0 turns -0 into 0, so that the angle of (0, -0) is 0
+    const T steep = std::copysign(T(1), absX - y);
+    const T left  = std::copysign(T(1), x + T(0));
+    const T angle = steep * acute + (T(1) - steep) * T(M_PI / 4);
+    return (left * angle + (T(1) - left) * T(M_PI / 2)) * T(180.0 / M_PI);
+}
+
+/**
+ * @brief Computes the speed shear and the direction veer between two levels at a list of points, in a single pass.
+ *
+ * The shear is the absolute difference between the wind speeds at the two levels, in m/s, and the veer is the angle
+ * between the two wind vectors, in degrees within [0, 180]. Both are computed from the same loads of the four
+ * components, so an event testing both only reads the columns once. The veer uses `vectorAngle` rather than `atan2`,
+ * which keeps the loop free of library calls.
+ *
+ * @param[in] u1 The first value of the u component at the first level.
+ * @param[in] v1 The first value of the v component at the first level.
+ * @param[in] stride1 The distance between two consecutive points in the first level arrays.
+ * @param[in] u2 The first value of the u component at the second level.
+ * @param[in] v2 The first value of the v component at the second level.
+ * @param[in] stride2 The distance between two consecutive points in the second level arrays.
+ * @param[in] points The indices of the points to compute the shear and veer at.
+ * @param[in] size The number of points.
+ * @param[out] shear The shear at `points[k]` is stored in `shear[k]`, must hold `size` values.
+ * @param[out] veer The veer at `points[k]` is stored in `veer[k]`, must hold `size` values.
+ */
+template <typename T>
+void shearAndVeer(const T* u1, const T* v1, atlas::idx_t stride1, const T* u2, const T* v2, atlas::idx_t stride2,
+                  const atlas::idx_t* points, atlas::idx_t size, T* shear, T* veer) {
+    for (atlas::idx_t k = 0; k < size; ++k) {
+        const T valU1 = u1[points[k] * stride1];
+        const T valV1 = v1[points[k] * stride1];
+        const T valU2 = u2[points[k] * stride2];
+        const T valV2 = v2[points[k] * stride2];
+        shear[k]      = std::abs(std::sqrt(valU2 * valU2 + valV2 * valV2) - std::sqrt(valU1 * valU1 + valV1 * valV1));
+        // The angle from the cross and dot products is accurate for small and large angles, and 0 for a calm level
+        veer[k] = vectorAngle(std::abs(valU1 * valV2 - valV1 * valU2), valU1 * valU2 + valV1 * valV2);
+    }
+}
+
+/**
+ * @brief Computes the absolute rate of change of a value between two steps.
+ *
+ * @param[in] current The values at the current step.
+ * @param[in] previous The values at the previous step.
+ * @param[in] size The number of values.
+ * @param[in] scaling The factor converting a change per step to a rate, e.g. the number of steps per hour.
+ * @param[out] rate The rate of change of `current[k]` is stored in `rate[k]`, must hold `size` values.
+ */
+template <typename T>
+void rampRate(const T* current, const T* previous, atlas::idx_t size, T scaling, T* rate) {
+    for (atlas::idx_t k = 0; k < size; ++k) {
+        rate[k] = std::abs(current[k] - previous[k]) * scaling;
+    }
+}
+
+}  // namespace WindKernels
+
+#endif  // WIND_KERNELS_H
@@ -0,0 +1,211 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+
+#include "atlas/array.h"
+#include "atlas/field.h"
+#include "atlas/functionspace.h"
+#include "eckit/exception/Exceptions.h"
+
+#include "wind_kernels.h"
+#include "wind_power.h"
+
+const std::string WindPower::type_                           = "wind_power";
+const std::array<std::string, 6> WindPower::supportedFields_ = {"100u", "100v", "10u", "10v", "u", "v"};
+
+WindPower::WindPower(const eckit::LocalConfiguration& config) : ExtremeEvent(config) {
+    checkSupportedFields(supportedFields_, type_);
+
+    auto findField = [this](const std::string& field) {
+        return std::find(requiredFields_.begin(), requiredFields_.end(), field) == requiredFields_.end() ? "" : field;
+    };
+
+    for (const auto& eventConfig : config.getSubConfigurations("instances")) {
+        const size_t regionSet = addRegionSet(eventConfig);
+
+        PowerCurve curve(eventConfig.getSubConfiguration("power_curve"));
+        const std::string criterionName = eventConfig.getString("criterion");
+        const double threshold          = eventConfig.getDouble("threshold");
+        Criterion criterion;
+        std::ostringstream description;
+        description << eventConfig.getString("description");
+        if (criterionName == "capacity_below") {
+            criterion = Criterion::CapacityBelow;
+            description << " (capacity factor below : " << std::to_string(threshold);
+        }
+        else if (criterionName == "capacity_above") {
+            criterion = Criterion::CapacityAbove;
+            description << " (capacity factor above : " << std::to_string(threshold);
+        }
+        else if (criterionName == "ramp") {
+            if (threshold <= 0.0) {
+                throw eckit::BadValue("The 'wind_power' ramp threshold must be positive", Here());
+            }
+            criterion = Criterion::Ramp;
+            description << " (capacity factor ramp above : " << std::to_string(threshold) << " per hour";
+        }
+        else {
+            throw eckit::BadValue("Unknown 'wind_power' criterion '" + criterionName +
+                                      "', expected 'capacity_below', 'capacity_above' or 'ramp'",
+                                  Here());
+        }
+
+        // The 100 m wind is the closest to the hub height of most turbines, the 10 m wind is a fallback
+        std::vector<std::pair<int, std::pair<std::string, std::string>>> levels;
+        if (eventConfig.isIntegralList("model_levels")) {
+            std::string u = findField("u");
+            std::string v = findField("v");
+            if (u.empty() && v.empty()) {
+                throw eckit::BadParameter(
+                    "The `model_levels` key can only be used when non surface fields are required", Here());
+            }
+            for (const auto& ml : eventConfig.getIntVector("model_levels")) {
+                if (ml > config.getInt("vertical_levels")) {
+                    throw eckit::BadValue("The model has " + std::to_string(config.getInt("vertical_levels")) +
+                                              " vertical levels, please adjust the config.",
+                                          Here());
+                }
+                levels.push_back({ml, {u, v}});
+            }
+        }
+        else {
+            std::string u = findField("100u");
+            std::string v = findField("100v");
+            if (u.empty() && v.empty()) {
+                u = findField("10u");
+                v = findField("10v");
+            }
+            if (u.empty() && v.empty()) {
+                throw eckit::BadParameter("The `model_levels` key or surface field(s) is missing in the configuration",
+                                          Here());
+            }
+            levels.push_back({0, {u, v}});
+        }
+
+        const auto cellCriterion = CellCriterion::fromConfig(eventConfig);
+        for (const auto& [ml, cpnts] : levels) {
+            std::ostringstream fieldDesc;
+            if (ml > 0) {
+                fieldDesc << ", level: " << std::to_string(ml);
+            }
+            if (cpnts.first.empty() || cpnts.second.empty()) {
+                fieldDesc << ", field : '" << cpnts.first << cpnts.second << "')";
+            }
+            else {
+                fieldDesc << ", fields : ('" << cpnts.first << "','" << cpnts.second << "'))";
+            }
+            instances_.push_back({curve, criterion, threshold, ml, cpnts.first, cpnts.second,
+                                  description.str() + fieldDesc.str(), regionSet, cellCriterion});
+        }
+    }
+
+    if (instances_.empty()) {
+        throw eckit::BadValue("No valid instance found for 'wind_power', ensure options and required fields align",
+                              Here());
+    }
+    previousCapacity_.resize(instances_.size());
+}
+
+void WindPower::setup(plume::data::ModelData& modelData) {
+    resolveRegionPoints(modelData);
+    for (auto& previous : previousCapacity_) {
+        previous.clear();
+    }
+}
+
+std::vector<ExtremeEvent::DetectionData> WindPower::detect(plume::data::ModelData& modelData) {
+    ASSERT_MSG(regionPoints_.size() == regionSets_.size(), "'wind_power' detection requires the event to be set up");
+    std::vector<DetectionData> results;
+    for (const auto& instance : instances_) {
+        std::string level = instance.modelLevel > 0 ? "ml" : "sfc";
+        std::string param = instance.u.empty()   ? instance.v
+                            : instance.v.empty() ? instance.u
+                                                 : instance.u + "/" + instance.v;
+        const std::string quantity = instance.criterion == Criterion::Ramp ? "capacity_ramp" : "capacity_factor";
+        results.push_back({{}, instance.description, param, level, std::to_string(instance.modelLevel), {}, quantity,
+                           instance.cellCriterion});
+    }
+
+    dispatchFieldType(precisionField(modelData, type_),
+                      [&](auto tag) { detectWithType<decltype(tag)>(modelData, results); });
+    return results;
+}
+
+template <typename T>
+void WindPower::detectWithType(plume::data::ModelData& modelData, std::vector<DetectionData>& results) {
+    std::unordered_map<std::string, atlas::array::ArrayView<const T, 2>> windFields;
+    for (const auto& windField : requiredFields_) {
+        windFields.emplace(windField, atlas::array::make_view<const T, 2>(modelData.getAtlasFieldShared(windField)));
+    }
+    const double stepHours = modelData.getDouble("TSTEP") / 3600.0;
+    ASSERT_MSG(stepHours > 0.0, "'wind_power' ramps require a positive model time step");
+
+    // Scratch buffers reused by every instance
+    size_t maxPoints = 0;
+    for (const auto& points : regionPoints_) {
+        maxPoints = std::max(maxPoints, points.size());
+    }
+    std::vector<T> windMagnitude(maxPoints);
+    std::vector<float> capacity(maxPoints);
+    std::vector<float> ramp(maxPoints);
+    for (size_t idx = 0; idx < instances_.size(); idx++) {
+        const auto& instance = instances_[idx];
+        int levelIdx         = instance.modelLevel > 0 ? instance.modelLevel - 1 : 0;
+
+        const T* valU       = nullptr;
+        const T* valV       = nullptr;
+        atlas::idx_t stride = 0;
+        if (!instance.u.empty()) {
+            const auto& view = windFields.at(instance.u);
+            valU             = view.data() + levelIdx * view.stride(1);
+            stride           = view.stride(0);
+        }
+        if (!instance.v.empty()) {
+            const auto& view = windFields.at(instance.v);
+            valV             = view.data() + levelIdx * view.stride(1);
+            stride           = view.stride(0);
+        }
+        const auto& points    = regionPoints_[instance.regionSet];
+        const auto nbOfPoints = static_cast<atlas::idx_t>(points.size());
+        WindKernels::windMagnitude(valU, valV, stride, points.data(), nbOfPoints, windMagnitude.data());
+        instance.curve.capacityFactor(windMagnitude.data(), nbOfPoints, capacity.data());
+
+        const float threshold = static_cast<float>(instance.threshold);
+        const float lowest    = std::numeric_limits<float>::lowest();
+        switch (instance.criterion) {
+            case Criterion::CapacityBelow:
+                WindKernels::selectInInterval(capacity.data(), points.data(), nbOfPoints, lowest, threshold,
+                                              results[idx].detectedPoints, &results[idx].detectedValues);
+                break;
+            case Criterion::CapacityAbove:
+                // An upper bound lower than the lower bound only checks the lower bound
+                WindKernels::selectInInterval(capacity.data(), points.data(), nbOfPoints, threshold, lowest,
+                                              results[idx].detectedPoints, &results[idx].detectedValues);
+                break;
+            case Criterion::Ramp: {
+                auto& previous = previousCapacity_[idx];
+                if (previous.size() == points.size()) {
+                    WindKernels::rampRate(capacity.data(), previous.data(), nbOfPoints,
+                                          static_cast<float>(1.0 / stepHours), ramp.data());
+                    WindKernels::selectInInterval(ramp.data(), points.data(), nbOfPoints, threshold, lowest,
+                                                  results[idx].detectedPoints, &results[idx].detectedValues);
+                }
+                previous.assign(capacity.begin(), capacity.begin() + nbOfPoints);
+                break;
+            }
+        }
+    }
+}
+
+WindPower::Registrar WindPower::registrar;
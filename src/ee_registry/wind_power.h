@@ -0,0 +1,103 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <array>
+#include <string>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "plume/data/ModelData.h"
+
+#include "ee_registry.h"
+#include "power_curve.h"
+
+/**
+ * @class WindPower
+ * @brief This event represents losses or ramps of the wind power production at a given time step.
+ *
+ * The wind at hub height (100 m or a model level) is mapped through the power curve of each instance to a capacity
+ * factor, which is compared to a threshold or to its value at the previous step. See README for configuration
+ * guidelines.
+ */
+class WindPower final : public ExtremeEvent {
+private:
+    static const std::string type_;
+    static const std::array<std::string, 6> supportedFields_;
+
+    /// What is compared to the threshold of an instance
+    enum class Criterion
+    {
+        CapacityBelow,  ///< The capacity factor is below the threshold, e.g. below cut-in or above cut-out
+        CapacityAbove,  ///< The capacity factor reaches the threshold
+        Ramp            ///< The capacity factor changes by at least the threshold per hour
+    };
+
+    /// Represents the detection options of an instance.
+    struct Instance {
+        PowerCurve curve;
+        Criterion criterion;
+        double threshold;
+        int modelLevel;
+        std::string u, v, description;
+        size_t regionSet;             ///< Index of the set of regions of interest (and its point list) of the instance
+        CellCriterion cellCriterion;  ///< How the detected points fire their HEALPix cells
+    };
+
+    std::vector<Instance> instances_;
+
+    /// Capacity factor of each ramp instance at the previous step, empty before the first step
+    std::vector<std::vector<float>> previousCapacity_;
+
+    /**
+     * @brief Runs the detection on wind fields of value type `T`.
+     *
+     * @param modelData The model data that contains the wind fields to run detection on.
+     * @param results The detection results for each instance, filled in place.
+     */
+    template <typename T>
+    void detectWithType(plume::data::ModelData& modelData, std::vector<ExtremeEvent::DetectionData>& results);
+
+public:
+    /**
+     * @brief Constructs a wind power event.
+     *
+     * Instances with `model_levels` use the `u` and `v` fields, the others use the 100 m wind if offered, and the
+     * 10 m wind otherwise.
+     *
+     * @param The configuration of the event, the power curve, criterion and threshold of several instances.
+     */
+    WindPower(const eckit::LocalConfiguration& config);
+
+    /**
+     * @brief Resolves the regions of interest of each instance into the list of owned points they contain.
+     *
+     * @param modelData The model data that contains the wind fields, only their function space is used.
+     */
+    void setup(plume::data::ModelData& modelData) override;
+
+    /**
+     * @brief Detects wind power losses or ramps at a given time step.
+     *
+     * The ramp instances compare the capacity factor to the previous step, so they do not fire at the first step.
+     *
+     * @param modelData The model data that contains the wind fields to run detection on.
+     *
+     * @return The detection results for each instance.
+     */
+    std::vector<ExtremeEvent::DetectionData> detect(plume::data::ModelData& modelData) override;
+
+    /// Register the wind power event into the registry so it can be used in the plugin.
+    static struct Registrar {
+        Registrar() {
+            ExtremeEventRegistry::instance().registerEvent(
+                type_, [](const eckit::LocalConfiguration& config) { return std::make_unique<WindPower>(config); });
+        }
+    } registrar;
+};
@@ -0,0 +1,176 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+
+#include "atlas/array.h"
+#include "atlas/field.h"
+#include "atlas/functionspace.h"
+#include "eckit/exception/Exceptions.h"
+
+#include "wind_kernels.h"
+#include "wind_shear.h"
+
+const std::string WindShear::type_                           = "wind_shear";
+const std::array<std::string, 6> WindShear::supportedFields_ = {"100u", "100v", "10u", "10v", "u", "v"};
+
+WindShear::WindShear(const eckit::LocalConfiguration& config) : ExtremeEvent(config) {
+    checkSupportedFields(supportedFields_, type_);
+    auto hasField = [this](const std::string& field) {
+        return std::find(requiredFields_.begin(), requiredFields_.end(), field) != requiredFields_.end();
+    };
+
+    for (const auto& eventConfig : config.getSubConfigurations("instances")) {
+        const size_t regionSet = addRegionSet(eventConfig);
+
+        Column column;
+        if (eventConfig.isIntegralList("model_levels")) {
+            const auto levels = eventConfig.getIntVector("model_levels");
+            if (levels.size() != 2 || !hasField("u") || !hasField("v")) {
+                throw eckit::BadParameter(
+                    "'wind_shear' instances with `model_levels` require two levels and the 'u' and 'v' fields", Here());
+            }
+            for (const auto& ml : levels) {
+                if (ml < 1 || ml > config.getInt("vertical_levels")) {
+                    throw eckit::BadValue("The model has " + std::to_string(config.getInt("vertical_levels")) +
+                                              " vertical levels, please adjust the config.",
+                                          Here());
+                }
+            }
+            column = {"u", "v", "u", "v", levels[0], levels[1], regionSet};
+        }
+        else {
+            if (!hasField("10u") || !hasField("10v") || !hasField("100u") || !hasField("100v")) {
+                throw eckit::BadParameter(
+                    "'wind_shear' instances without `model_levels` require the '10u', '10v', '100u' and '100v' fields",
+                    Here());
+            }
+            column = {"10u", "10v", "100u", "100v", 0, 0, regionSet};
+        }
+
+        const std::string criterionName = eventConfig.getString("criterion");
+        Criterion criterion;
+        std::string unit;
+        if (criterionName == "shear") {
+            criterion = Criterion::Shear;
+            unit      = " m/s";
+        }
+        else if (criterionName == "veer") {
+            criterion = Criterion::Veer;
+            unit      = " deg";
+        }
+        else {
+            throw eckit::BadValue(
+                "Unknown 'wind_shear' criterion '" + criterionName + "', expected 'shear' or 'veer'", Here());
+        }
+        const double lBound = eventConfig.getDouble("lower_bound");
+        const double uBound = eventConfig.getDouble("upper_bound");
+
+        std::ostringstream description;
+        description << eventConfig.getString("description") << " (" << criterionName;
+        if (lBound > uBound) {
+            description << " threshold : " << std::to_string(lBound) << unit;
+        }
+        else {
+            description << " lower bound : " << std::to_string(lBound) << unit
+                        << ", upper bound : " << std::to_string(uBound) << unit;
+        }
+        if (column.level1 > 0) {
+            description << ", levels : (" << column.level1 << "," << column.level2 << "), fields : ('u','v'))";
+        }
+        else {
+            description << ", fields : ('10u','10v') to ('100u','100v'))";
+        }
+
+        // Instances on the same levels and regions share the computation of the shear and veer
+        auto sameColumn = std::find_if(columns_.begin(), columns_.end(), [&column](const Column& other) {
+            return other.level1 == column.level1 && other.level2 == column.level2 &&
+                   other.regionSet == column.regionSet && other.u1 == column.u1;
+        });
+        const size_t columnIdx = sameColumn - columns_.begin();
+        if (sameColumn == columns_.end()) {
+            columns_.push_back(column);
+        }
+        instances_.push_back(
+            {criterion, lBound, uBound, columnIdx, description.str(), CellCriterion::fromConfig(eventConfig)});
+    }
+
+    if (instances_.empty()) {
+        throw eckit::BadValue("No valid instance found for 'wind_shear', ensure options and required fields align",
+                              Here());
+    }
+}
+
+void WindShear::setup(plume::data::ModelData& modelData) {
+    resolveRegionPoints(modelData);
+}
+
+std::vector<ExtremeEvent::DetectionData> WindShear::detect(plume::data::ModelData& modelData) {
+    ASSERT_MSG(regionPoints_.size() == regionSets_.size(), "'wind_shear' detection requires the event to be set up");
+    std::vector<DetectionData> results;
+    for (const auto& instance : instances_) {
+        const auto& column = columns_[instance.column];
+        const bool surface = column.level1 == 0;
+        std::string param  = surface ? "10u/10v/100u/100v" : "u/v";
+        std::string levels = surface ? "0" : std::to_string(column.level1) + "/" + std::to_string(column.level2);
+        results.push_back({{}, instance.description, param, surface ? "sfc" : "ml", levels, {},
+                           instance.criterion == Criterion::Shear ? "wind_shear" : "wind_veer",
+                           instance.cellCriterion});
+    }
+
+    dispatchFieldType(precisionField(modelData, type_),
+                      [&](auto tag) { detectWithType<decltype(tag)>(modelData, results); });
+    return results;
+}
+
+template <typename T>
+void WindShear::detectWithType(plume::data::ModelData& modelData, std::vector<DetectionData>& results) const {
+    std::unordered_map<std::string, atlas::array::ArrayView<const T, 2>> windFields;
+    for (const auto& windField : requiredFields_) {
+        windFields.emplace(windField, atlas::array::make_view<const T, 2>(modelData.getAtlasFieldShared(windField)));
+    }
+    // Pointer to the first value of a component at a level, model levels start at 1
+    auto levelData = [&windFields](const std::string& field, int level) {
+        const auto& view = windFields.at(field);
+        return view.data() + (level > 0 ? level - 1 : 0) * view.stride(1);
+    };
+
+    // Scratch buffers reused by every column
+    size_t maxPoints = 0;
+    for (const auto& points : regionPoints_) {
+        maxPoints = std::max(maxPoints, points.size());
+    }
+    std::vector<T> shear(maxPoints);
+    std::vector<T> veer(maxPoints);
+    for (size_t idx_col = 0; idx_col < columns_.size(); ++idx_col) {
+        const auto& column    = columns_[idx_col];
+        const auto& points    = regionPoints_[column.regionSet];
+        const auto nbOfPoints = static_cast<atlas::idx_t>(points.size());
+        WindKernels::shearAndVeer(levelData(column.u1, column.level1), levelData(column.v1, column.level1),
+                                  windFields.at(column.u1).stride(0), levelData(column.u2, column.level2),
+                                  levelData(column.v2, column.level2), windFields.at(column.u2).stride(0),
+                                  points.data(), nbOfPoints, shear.data(), veer.data());
+        for (size_t idx = 0; idx < instances_.size(); ++idx) {
+            const auto& instance = instances_[idx];
+            if (instance.column != idx_col) {
+                continue;
+            }
+            const T* values = instance.criterion == Criterion::Shear ? shear.data() : veer.data();
+            // An upper bound lower than the lower bound only checks the lower bound
+            WindKernels::selectInInterval(values, points.data(), nbOfPoints, static_cast<T>(instance.lBound),
+                                          static_cast<T>(instance.uBound), results[idx].detectedPoints,
+                                          &results[idx].detectedValues);
+        }
+    }
+}
+
+WindShear::Registrar WindShear::registrar;
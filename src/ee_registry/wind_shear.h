@@ -0,0 +1,104 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <array>
+#include <string>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "plume/data/ModelData.h"
+
+#include "ee_registry.h"
+
+/**
+ * @class WindShear
+ * @brief This event represents strong vertical wind shear or veer across the rotor of wind turbines.
+ *
+ * The speed shear and the direction veer are computed between two model levels, or between the 10 m and the 100 m
+ * wind, and compared to the bounds of each instance. See README for configuration guidelines.
+ */
+class WindShear final : public ExtremeEvent {
+private:
+    static const std::string type_;
+    static const std::array<std::string, 6> supportedFields_;
+
+    /// What is compared to the bounds of an instance
+    enum class Criterion
+    {
+        Shear,  ///< Absolute difference of the wind speeds at the two levels, in m/s
+        Veer    ///< Angle between the winds at the two levels, in degrees
+    };
+
+    /// A pair of levels over a set of regions, whose shear and veer are computed once per step for all its instances.
+    struct Column {
+        std::string u1, v1, u2, v2;  ///< Wind components at the first and second level
+        int level1, level2;          ///< Model levels, 0 for surface fields
+        size_t regionSet;            ///< Index of the set of regions of interest (and its point list)
+    };
+
+    /// Represents the detection options of an instance.
+    struct Instance {
+        Criterion criterion;
+        double lBound, uBound;
+        size_t column;  ///< Index of the column the instance is detected on
+        std::string description;
+        CellCriterion cellCriterion;  ///< How the detected points fire their HEALPix cells
+    };
+
+    std::vector<Column> columns_;
+    std::vector<Instance> instances_;
+
+
+    /**
+     * @brief Runs the detection on wind fields of value type `T`.
+     *
+     * @param modelData The model data that contains the wind fields to run detection on.
+     * @param results The detection results for each instance, filled in place.
+     */
+    template <typename T>
+    void detectWithType(plume::data::ModelData& modelData, std::vector<ExtremeEvent::DetectionData>& results) const;
+
+public:
+    /**
+     * @brief Constructs a wind shear event.
+     *
+     * Instances with `model_levels` (two levels) use the `u` and `v` fields, the others use the 10 m and 100 m wind.
+     *
+     * @param The configuration of the event, the levels, criterion and bounds of several instances.
+     *
+     * @throws eckit::BadParameter if an instance does not have two levels, or the fields of its levels are missing.
+     * @throws eckit::BadValue if the criterion is unknown.
+     */
+    WindShear(const eckit::LocalConfiguration& config);
+
+    /**
+     * @brief Resolves the regions of interest of each instance into the list of owned points they contain.
+     *
+     * @param modelData The model data that contains the wind fields, only their function space is used.
+     */
+    void setup(plume::data::ModelData& modelData) override;
+
+    /**
+     * @brief Detects strong shear or veer at a given time step.
+     *
+     * @param modelData The model data that contains the wind fields to run detection on.
+     *
+     * @return The detection results for each instance.
+     */
+    std::vector<ExtremeEvent::DetectionData> detect(plume::data::ModelData& modelData) override;
+
+    /// Register the wind shear event into the registry so it can be used in the plugin.
+    static struct Registrar {
+        Registrar() {
+            ExtremeEventRegistry::instance().registerEvent(
+                type_, [](const eckit::LocalConfiguration& config) { return std::make_unique<WindShear>(config); });
+        }
+    } registrar;
+};
@@ -0,0 +1,160 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <algorithm>
+#include <sstream>
+
+#include "atlas/parallel/mpi/mpi.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+
+#include "ensemble_reducer.h"
+
+namespace ExtremeEventPlugin {
+
+namespace {
+
+const std::string groupName = "ee_ensemble_partition";
+
+/// Checks that a value is the same on all the ranks of a communicator.
+bool sameOnAllRanks(const eckit::mpi::Comm& comm, long value) {
+    long minValue = value;
+    long maxValue = value;
+    comm.allReduceInPlace(minValue, eckit::mpi::min());
+    comm.allReduceInPlace(maxValue, eckit::mpi::max());
+    return minValue == maxValue;
+}
+
+}  // namespace
+
+EnsembleReducer::EnsembleReducer(const eckit::Configuration& conf) {
+    probability_       = conf.getDouble("probability");
+    configuredMembers_ = conf.getInt("members", 0);
+    if (probability_ <= 0.0 || probability_ > 1.0) {
+        throw eckit::BadParameter("The ensemble 'probability' must be in (0, 1]", Here());
+    }
+    if (configuredMembers_ < 0) {
+        throw eckit::BadParameter("The ensemble 'members' must be positive", Here());
+    }
+}
+
+void EnsembleReducer::setup(const std::vector<int>& pointToCell) {
+    // Each member runs on its own model communicator, made of consecutive ranks of the world communicator
+    const auto& world = atlas::mpi::comm("world");
+    const auto& model = atlas::mpi::comm();
+    if (world.size() % model.size() != 0) {
+        throw eckit::BadValue("The world communicator size is not a multiple of the model communicator size, "
+                              "the ensemble members cannot be identified",
+                              Here());
+    }
+    members_ = static_cast<int>(world.size() / model.size());
+    member_  = static_cast<int>(world.rank() / model.size());
+    if (configuredMembers_ > 0 && configuredMembers_ != members_) {
+        throw eckit::BadValue("The ensemble is configured with " + std::to_string(configuredMembers_) +
+                                  " members, but " + std::to_string(members_) + " members are running",
+                              Here());
+    }
+    // The member index above only holds if each model communicator is a block of consecutive world ranks in order,
+    // the ranks that would pair other partitions are reported on all the ranks so that they all throw
+    long leader = static_cast<long>(world.rank());
+    model.allReduceInPlace(leader, eckit::mpi::min());
+    int misplaced = leader != static_cast<long>(member_ * model.size()) ||
+                    static_cast<long>(world.rank()) - leader != static_cast<long>(model.rank());
+    world.allReduceInPlace(misplaced, eckit::mpi::max());
+    if (misplaced) {
+        throw eckit::BadValue("The ensemble members must be consecutive blocks of ranks of the world communicator, "
+                              "with the model ranks in the same order",
+                              Here());
+    }
+    if (members_ == 1) {
+        eckit::Log::warning() << "Ensemble mode with a single member, run the members under a single mpirun with "
+                              << "one model communicator each" << std::endl;
+    }
+    if (!eckit::mpi::hasComm(groupName.c_str())) {
+        world.split(static_cast<int>(model.rank()), groupName);
+    }
+    group_ = &atlas::mpi::comm(groupName);
+
+    cells_.clear();
+    for (const int cell : pointToCell) {
+        if (cell >= 0) {
+            cells_.push_back(cell);
+        }
+    }
+    std::sort(cells_.begin(), cells_.end());
+    cells_.erase(std::unique(cells_.begin(), cells_.end()), cells_.end());
+
+    // The flags are exchanged slot by slot, so the partitions of a group must cover exactly the same cells
+    long checksum = 0;
+    for (const int cell : cells_) {
+        checksum = (checksum * 31 + cell) % 1000000007L;
+    }
+    if (!sameOnAllRanks(*group_, static_cast<long>(cells_.size())) || !sameOnAllRanks(*group_, checksum)) {
+        throw eckit::BadValue("The ensemble members do not share the same partitioning or HEALPix resolution", Here());
+    }
+    instances_ = 0;
+    eckit::Log::info() << "Ensemble mode: member " << member_ << " of " << members_ << ", " << cells_.size()
+                       << " cells per partition" << std::endl;
+}
+
+std::vector<std::vector<int>> EnsembleReducer::reduce(const std::vector<std::vector<int>>& firingCells) {
+    ASSERT_MSG(group_, "The ensemble reducer requires to be set up");
+    if (instances_ != firingCells.size()) {
+        // Checked once, the buffers of the allreduce must have the same size on all the members
+        if (!sameOnAllRanks(*group_, static_cast<long>(firingCells.size()))) {
+            throw eckit::BadValue("The ensemble members do not run the same event instances", Here());
+        }
+        instances_ = firingCells.size();
+    }
+
+    // One flag per instance and cell of the partition, all the instances are reduced in a single collective
+    const size_t nbCells = cells_.size();
+    std::vector<int> counts(firingCells.size() * nbCells, 0);
+    for (size_t instance = 0; instance < firingCells.size(); ++instance) {
+        for (const int cell : firingCells[instance]) {
+            if (cell < 0) {
+                continue;  // Halo point, fired by the partition owning it
+            }
+            auto slot = std::lower_bound(cells_.begin(), cells_.end(), cell);
+            ASSERT(slot != cells_.end() && *slot == cell);
+            counts[instance * nbCells + (slot - cells_.begin())] = 1;
+        }
+    }
+    group_->allReduceInPlace(counts.begin(), counts.end(), eckit::mpi::sum());
+
+    std::vector<std::vector<int>> ensembleCells(firingCells.size());
+    for (size_t instance = 0; instance < firingCells.size(); ++instance) {
+        ensembleCells[instance] =
+            cellsAboveProbability(cells_, counts.data() + instance * nbCells, members_, probability_);
+    }
+    return ensembleCells;
+}
+
+std::string EnsembleReducer::describe(const std::string& description) const {
+    std::ostringstream ensembleDescription;
+    ensembleDescription << description << " (ensemble probability >= " << probability_ * 100.0 << "% of " << members_
+                        << " members)";
+    return ensembleDescription.str();
+}
+
+std::vector<int> cellsAboveProbability(const std::vector<int>& cells, const int* counts, int members,
+                                       double probability) {
+    // Compared on counts to avoid rounding issues, e.g. 3 of 10 members for a probability of 0.3
+    const double minCount = probability * members - 1e-9;
+    std::vector<int> selected;
+    for (size_t slot = 0; slot < cells.size(); ++slot) {
+        if (counts[slot] > 0 && counts[slot] >= minCount) {
+            selected.push_back(cells[slot]);
+        }
+    }
+    return selected;
+}
+
+}  // namespace ExtremeEventPlugin
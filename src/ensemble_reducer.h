@@ -0,0 +1,105 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "eckit/config/Configuration.h"
+#include "eckit/mpi/Comm.h"
+
+namespace ExtremeEventPlugin {
+
+/**
+ * @class EnsembleReducer
+ * @brief Turns the firing cells of each ensemble member into the cells where enough members fire.
+ *
+ * In ensemble mode, the members run under a single `mpirun` (e.g. `mpirun -n 4 model : -n 4 model`), each member on
+ * its own model communicator (the default one), and the world communicator holding all of them. The ranks with the
+ * same partition index in every member are grouped in a communicator at setup. At each step, each rank flags the
+ * cells that fire in its partition for every event instance, the flags are summed across the group with a single
+ * allreduce (only the cells touched by the partition are exchanged, not the fields), and the cells fired by at least
+ * `probability` of the members are kept. Only the first member outputs the result, so an ensemble sends one stream of
+ * notifications instead of one per member.
+ *
+ * The members must share the grid, the partitioning, the HEALPix resolution and the events configuration, so that
+ * the partitions of a group cover the same cells. This is checked at setup.
+ */
+class EnsembleReducer {
+public:
+    /**
+     * @brief Reads the ensemble options.
+     *
+     * @param conf The `ensemble` configuration: `probability` (fraction of members, required) and `members` (optional,
+     *             checked against the number of members found at setup).
+     *
+     * @throws eckit::BadParameter if the probability is not in `(0, 1]` or the number of members is not positive.
+     */
+    explicit EnsembleReducer(const eckit::Configuration& conf);
+
+    /**
+     * @brief Groups the ranks of the partition across the members and checks that they cover the same cells.
+     *
+     * This is collective over the world communicator.
+     *
+     * @param pointToCell The HEALPix cell of each point of the partition, -1 for the halo.
+     *
+     * @throws eckit::BadValue if the members are not consecutive blocks of world ranks or do not share the same
+     *         partitioning.
+     */
+    void setup(const std::vector<int>& pointToCell);
+
+    /**
+     * @brief Returns, for each event instance, the cells fired by enough members.
+     *
+     * This is collective over the partition group, all the members must call it at every step with the same number
+     * of instances.
+     *
+     * @param firingCells The sorted cells fired by this member, for each event instance.
+     *
+     * @return The sorted cells whose fraction of firing members reaches the probability, for each event instance.
+     */
+    std::vector<std::vector<int>> reduce(const std::vector<std::vector<int>>& firingCells);
+
+    /// Returns whether this member outputs the ensemble results (the first member).
+    bool outputs() const { return member_ == 0; }
+
+    /// Appends the ensemble criterion to a detection description.
+    std::string describe(const std::string& description) const;
+
+    int members() const { return members_; }
+    int member() const { return member_; }
+
+private:
+    double probability_;
+    int configuredMembers_;  ///< Number of members from the configuration, 0 if not given
+    int members_ = 0;
+    int member_  = 0;
+
+    const eckit::mpi::Comm* group_ = nullptr;  ///< Ranks with the same partition index in every member
+    std::vector<int> cells_;                   ///< Sorted cells touched by the partition, the slots of the flags
+    size_t instances_ = 0;                     ///< Number of instances checked across members, 0 before the first step
+};
+
+/**
+ * @brief Selects the cells whose fraction of firing members reaches a probability.
+ *
+ * @param cells The cells.
+ * @param counts The number of firing members of each cell.
+ * @param members The number of members.
+ * @param probability The minimum fraction of firing members.
+ *
+ * @return The selected cells, in the order of `cells`. Cells fired by no member are never selected.
+ */
+std::vector<int> cellsAboveProbability(const std::vector<int>& cells, const int* counts, int members,
+                                       double probability);
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,97 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ExtremeEventPlugin {
+
+/**
+ * @class EpochPublisher
+ * @brief Hands immutable values over from writer threads to a single reader thread, without locking the reader.
+ *
+ * Each published value is tagged with an increasing epoch and swapped in with an atomic pointer store. The reader
+ * announces the epoch of the value it loaded, and the values replaced by a later publication are only deleted once
+ * the reader has announced a later epoch, so the value returned by `acquire` stays valid until the next `acquire`.
+ * Writers serialise among themselves with a mutex, the reader only performs an atomic load and an atomic store.
+ *
+ * @warning Only one thread may call `acquire`.
+ */
+template <typename T>
+class EpochPublisher {
+public:
+    EpochPublisher() = default;
+
+    ~EpochPublisher() {
+        delete current_.load();
+        for (auto* node : retired_) {
+            delete node;
+        }
+    }
+
+    EpochPublisher(const EpochPublisher&)            = delete;
+    EpochPublisher& operator=(const EpochPublisher&) = delete;
+
+    /// Publishes a new value, and deletes the values the reader cannot be using anymore.
+    void publish(std::unique_ptr<const T> value) {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        auto* node     = new Node{std::move(value), ++epoch_};
+        auto* previous = current_.exchange(node);
+        if (previous) {
+            retired_.push_back(previous);
+        }
+        // The reader never goes back to an older value, so the values older than the one it announced are unused
+        const uint64_t inUse = readerEpoch_.load();
+        std::vector<Node*> kept;
+        for (auto* retired : retired_) {
+            if (retired->epoch < inUse) {
+                delete retired;
+            }
+            else {
+                kept.push_back(retired);
+            }
+        }
+        retired_.swap(kept);
+    }
+
+    /**
+     * @brief Returns the latest published value, or `nullptr` if nothing was published yet.
+     *
+     * The value stays valid until the next call to `acquire`.
+     */
+    const T* acquire() {
+        Node* node = current_.load(std::memory_order_acquire);
+        if (!node) {
+            return nullptr;
+        }
+        readerEpoch_.store(node->epoch);
+        return node->value.get();
+    }
+
+private:
+    struct Node {
+        std::unique_ptr<const T> value;
+        uint64_t epoch;
+    };
+
+    std::atomic<Node*> current_{nullptr};
+    std::atomic<uint64_t> readerEpoch_{0};  ///< Epoch of the value last acquired by the reader
+
+    std::mutex writerMutex_;
+    uint64_t epoch_ = 0;          ///< Epoch of the last published value
+    std::vector<Node*> retired_;  ///< Replaced values, possibly still used by the reader
+};
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,65 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <cmath>
+#include <sstream>
+
+#include "atlas/array.h"
+
+#include "event_statistics.h"
+
+namespace ExtremeEventPlugin {
+
+namespace {
+
+constexpr double earthRadius = 6371.0;  ///< Mean Earth radius, in km
+
+}  // namespace
+
+void EventStatistics::locate(const atlas::FunctionSpace& fs) {
+    if (points > 0 && maxPoint >= 0) {
+        auto lonlat = atlas::array::make_view<double, 2>(fs.lonlat());
+        maxLon      = lonlat(maxPoint, 0);
+        maxLat      = lonlat(maxPoint, 1);
+    }
+}
+
+std::unordered_map<int, EventStatistics> cellStatistics(const std::vector<int>& detectedPoints,
+                                                        const std::vector<float>& detectedValues,
+                                                        const std::vector<int>& pointToCell) {
+    std::unordered_map<int, EventStatistics> statistics;
+    if (detectedValues.size() != detectedPoints.size()) {
+        return statistics;
+    }
+    for (size_t k = 0; k < detectedPoints.size(); ++k) {
+        auto& cell = statistics[pointToCell[detectedPoints[k]]];
+        cell.cells = 1;
+        cell.add(detectedValues[k], detectedPoints[k]);
+    }
+    return statistics;
+}
+
+double healpixCellArea(int resolution) {
+    // The 12 base cells of HEALPix are split in resolution² cells of equal area
+    return 4.0 * M_PI * earthRadius * earthRadius / (12.0 * resolution * resolution);
+}
+
+std::string statisticsToJson(const EventStatistics& stats, const std::string& quantity, double cellArea) {
+    std::ostringstream json;
+    json << "{";
+    if (stats.points > 0) {
+        json << "\"quantity\":\"" << quantity << "\",\"max\":" << stats.max << ",\"mean\":" << stats.mean()
+             << ",\"lat\":" << stats.maxLat << ",\"lon\":" << stats.maxLon << ",\"points\":" << stats.points << ",";
+    }
+    json << "\"area\":" << std::lround(stats.cells * cellArea) << "}";
+    return json.str();
+}
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,97 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "atlas/functionspace.h"
+
+namespace ExtremeEventPlugin {
+
+/**
+ * @brief Summary of the values that fired within an event instance, or within one of its polygons.
+ *
+ * The statistics are accumulated from the values the events return alongside the detected points, so nothing is
+ * read back from the model fields after the detection.
+ */
+struct EventStatistics {
+    size_t points = 0;                                     ///< Number of firing points with a value
+    size_t cells  = 0;                                     ///< Number of firing HEALPix cells
+    float max     = std::numeric_limits<float>::lowest();  ///< Largest firing value
+    double sum    = 0.0;                                   ///< Sum of the firing values, for the mean
+    int maxPoint  = -1;                                    ///< Function space index of the point of the largest value
+    double maxLon = 0.0;                                   ///< Longitude of the largest value, once located
+    double maxLat = 0.0;                                   ///< Latitude of the largest value, once located
+
+    /// Accounts for the value of a firing point.
+    void add(float value, int point) {
+        ++points;
+        sum += value;
+        if (value > max) {
+            max      = value;
+            maxPoint = point;
+        }
+    }
+
+    /// Accounts for the points and cells of another part of the event.
+    void merge(const EventStatistics& other) {
+        if (other.points > 0 && other.max > max) {
+            max      = other.max;
+            maxPoint = other.maxPoint;
+            maxLon   = other.maxLon;
+            maxLat   = other.maxLat;
+        }
+        points += other.points;
+        cells += other.cells;
+        sum += other.sum;
+    }
+
+    double mean() const { return points > 0 ? sum / points : 0.0; }
+
+    /// Sets the location of the largest value from its point on the function space of the firing points.
+    void locate(const atlas::FunctionSpace& fs);
+};
+
+/**
+ * @brief Accumulates the values of the firing points by HEALPix cell.
+ *
+ * @param detectedPoints The indices of the firing points on the function space.
+ * @param detectedValues The value of each firing point, aligned with `detectedPoints`. If the event does not report
+ *                       its values (empty vector), no statistics are returned.
+ * @param pointToCell The point to HEALPix cell mapping of the function space.
+ *
+ * @return The statistics of the points of each cell, keyed by cell index, with the cell counted once.
+ */
+std::unordered_map<int, EventStatistics> cellStatistics(const std::vector<int>& detectedPoints,
+                                                        const std::vector<float>& detectedValues,
+                                                        const std::vector<int>& pointToCell);
+
+/// Returns the area of a HEALPix cell, in km², all the cells of a resolution having the same area.
+double healpixCellArea(int resolution);
+
+/**
+ * @brief Formats statistics as a JSON object for the notification payload.
+ *
+ * The object holds the `quantity` the values refer to, the `max` and `mean` values, the `lat` and `lon` of the
+ * maximum, the number of firing `points` and the firing `area` in km². Only the area is given when no value was
+ * reported for the cells, e.g. cells fired by other ensemble members only.
+ *
+ * @param stats The statistics to format, located.
+ * @param quantity The name of the quantity the values refer to.
+ * @param cellArea The area of a HEALPix cell, in km².
+ */
+std::string statisticsToJson(const EventStatistics& stats, const std::string& quantity, double cellArea);
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,184 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <cmath>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+#include "eckit/exception/Exceptions.h"
+
+#include "event_tracker.h"
+
+namespace ExtremeEventPlugin {
+
+namespace {
+
+constexpr double earthRadius = 6371.0;  ///< Mean Earth radius, in km
+
+/// Great circle distance between two points, in km.
+double distance(const atlas::PointLonLat& a, const atlas::PointLonLat& b) {
+    const double toRad = M_PI / 180.0;
+    const double dLat  = (b.lat() - a.lat()) * toRad;
+    const double dLon  = (b.lon() - a.lon()) * toRad;
+    const double h     = std::sin(dLat / 2) * std::sin(dLat / 2) +
+                     std::cos(a.lat() * toRad) * std::cos(b.lat() * toRad) * std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2.0 * earthRadius * std::asin(std::sqrt(std::min(1.0, h)));
+}
+
+}  // namespace
+
+EventTracker::EventTracker(double maxDistance, size_t rank, size_t size) :
+    maxDistance_(maxDistance), nextId_(rank), idStride_(size) {
+    if (maxDistance_ < 0.0) {
+        throw eckit::BadParameter("The tracking 'max_distance' cannot be negative", Here());
+    }
+}
+
+std::vector<EventTracker::Track> EventTracker::update(size_t instance, const std::vector<std::vector<int>>& groups,
+                                                      const std::vector<atlas::PointLonLat>& centroids,
+                                                      std::vector<Track>& died) {
+    if (previous_.size() <= instance) {
+        previous_.resize(instance + 1);
+    }
+    const auto& previous = previous_[instance];
+
+    // Common cells between each current group and each previous event, the groups of a step never share cells
+    std::unordered_map<int, size_t> cellEvent;
+    for (size_t prev = 0; prev < previous.size(); ++prev) {
+        for (int cell : previous[prev].cells) {
+            cellEvent.emplace(cell, prev);
+        }
+    }
+    std::vector<std::map<size_t, size_t>> overlap(groups.size());
+    std::vector<bool> matched(previous.size(), false);
+    for (size_t group = 0; group < groups.size(); ++group) {
+        for (int cell : groups[group]) {
+            auto prev = cellEvent.find(cell);
+            if (prev != cellEvent.end()) {
+                ++overlap[group][prev->second];
+                matched[prev->second] = true;
+            }
+        }
+    }
+    if (maxDistance_ > 0.0) {
+        // Groups without common cells continue the nearest unmatched event, if it is close enough
+        for (size_t group = 0; group < groups.size(); ++group) {
+            if (!overlap[group].empty()) {
+                continue;
+            }
+            double nearest = maxDistance_;
+            size_t match   = previous.size();
+            for (size_t prev = 0; prev < previous.size(); ++prev) {
+                const double dist = distance(centroids[group], previous[prev].centroid);
+                if (!matched[prev] && dist <= nearest) {
+                    nearest = dist;
+                    match   = prev;
+                }
+            }
+            if (match < previous.size()) {
+                overlap[group][match] = 0;
+                matched[match]        = true;
+            }
+        }
+    }
+
+    // Each previous event continues in the current group it overlaps most, the first one on a tie
+    std::vector<size_t> successor(previous.size(), groups.size());
+    std::vector<size_t> successors(previous.size(), 0);
+    for (size_t group = 0; group < groups.size(); ++group) {
+        for (const auto& prev : overlap[group]) {
+            const size_t current = successor[prev.first];
+            if (current == groups.size() || prev.second > overlap[current].at(prev.first)) {
+                successor[prev.first] = group;
+            }
+            ++successors[prev.first];
+        }
+    }
+
+    std::vector<Track> tracks;
+    std::vector<Tracked> current;
+    for (size_t group = 0; group < groups.size(); ++group) {
+        Track track{0, State::Born, {}, {}};
+        // The previous events continuing in this group, the one overlapping most gives its identifier
+        std::vector<size_t> continued;
+        size_t parent = previous.size();
+        for (const auto& prev : overlap[group]) {
+            if (successor[prev.first] == group) {
+                continued.push_back(prev.first);
+            }
+            if (parent == previous.size() || prev.second > overlap[group].at(parent)) {
+                parent = prev.first;
+            }
+        }
+        if (!continued.empty()) {
+            size_t main = continued.front();
+            for (size_t prev : continued) {
+                if (overlap[group].at(prev) > overlap[group].at(main)) {
+                    main = prev;
+                }
+            }
+            track.id = previous[main].id;
+            for (size_t prev : continued) {
+                if (prev != main) {
+                    track.related.push_back(previous[prev].id);
+                }
+            }
+            track.state = continued.size() > 1 ? State::Merged : successors[main] > 1 ? State::Split : State::Moved;
+        }
+        else {
+            track.id = nextId_;
+            nextId_ += idStride_;
+            if (parent < previous.size()) {
+                track.state = State::Split;
+                track.related.push_back(previous[parent].id);
+            }
+        }
+        current.push_back({track.id, groups[group], centroids[group]});
+        tracks.push_back(std::move(track));
+    }
+
+    for (size_t prev = 0; prev < previous.size(); ++prev) {
+        if (!matched[prev]) {
+            died.push_back({previous[prev].id, State::Died, {}, previous[prev].cells});
+        }
+    }
+    previous_[instance].swap(current);
+    return tracks;
+}
+
+std::string EventTracker::stateName(State state) {
+    switch (state) {
+        case State::Born:
+            return "born";
+        case State::Moved:
+            return "moved";
+        case State::Merged:
+            return "merged";
+        case State::Split:
+            return "split";
+        case State::Died:
+            return "died";
+    }
+    return "";
+}
+
+std::string EventTracker::toJson(const Track& track) {
+    std::ostringstream json;
+    json << "{\"id\":" << track.id << ",\"state\":\"" << stateName(track.state) << "\",\"related\":[";
+    for (size_t idx = 0; idx < track.related.size(); ++idx) {
+        json << (idx > 0 ? "," : "") << track.related[idx];
+    }
+    json << "]}";
+    return json.str();
+}
+
+}  // namespace ExtremeEventPlugin
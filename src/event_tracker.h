@@ -0,0 +1,104 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "atlas/util/Point.h"
+
+namespace ExtremeEventPlugin {
+
+/**
+ * @class EventTracker
+ * @brief Follows the contiguous firing cells of each event instance from one step to the next.
+ *
+ * Each group of contiguous cells of a step is matched to the groups of the previous step of the same instance that
+ * share cells with it, found through an index from cell to group. A group without any common cell can optionally be
+ * matched to the nearest unmatched group of the previous step, within a maximum distance between their centroids,
+ * for events moving faster than a cell per step.
+ *
+ * Matched groups keep the identifier of the previous group they overlap most, so consumers can recognise an event
+ * they already processed. A previous group continues in the current group it overlaps most, the other current groups
+ * it overlaps are new events split from it. Identifiers are unique across the ranks and the instances.
+ *
+ * Each partition only tracks the groups of its own cells, the groups are not exchanged between the ranks. An event
+ * lying across a partition boundary is therefore tracked as one event per partition, each with its own identifier,
+ * and an event moving from one partition to another dies on the first and is born on the second. Consumers needing
+ * events across the whole domain have to join the tracks of neighbouring partitions themselves.
+ */
+class EventTracker {
+public:
+    /// Lifecycle state of a tracked event at a step.
+    enum class State
+    {
+        Born,    ///< No previous event matched
+        Moved,   ///< Continues a single previous event
+        Merged,  ///< Continues several previous events, the others are listed in `related`
+        Split,   ///< Continues or was split from a previous event that split, listed in `related` if new
+        Died     ///< No current event continues it, the cells are its last ones
+    };
+
+    /// Identifier and state of an event at a step.
+    struct Track {
+        uint64_t id;
+        State state;
+        std::vector<uint64_t> related;  ///< Events merged into this one, or the event this one split from
+        std::vector<int> cells;         ///< Last firing cells, for the events that died only
+    };
+
+    /**
+     * @param maxDistance The maximum distance between the centroids of two groups without common cells for them to be
+     *                    matched, in km. 0 only matches groups with common cells.
+     * @param rank The rank of the partition, the identifiers it assigns are congruent to it modulo `size`.
+     * @param size The number of ranks, so that the identifiers assigned by different ranks never collide.
+     *
+     * @throws eckit::BadParameter if the distance is negative.
+     */
+    EventTracker(double maxDistance, size_t rank, size_t size);
+
+    /**
+     * @brief Matches the groups of contiguous cells of an instance at this step to those of the previous step.
+     *
+     * @param instance The index of the instance, across all the events.
+     * @param groups The sorted firing cells of each contiguous group of the instance.
+     * @param centroids The centroid of each group.
+     * @param died The events of the instance that ended at the previous step are appended to it.
+     *
+     * @return The track of each group, in the order of the groups.
+     */
+    std::vector<Track> update(size_t instance, const std::vector<std::vector<int>>& groups,
+                              const std::vector<atlas::PointLonLat>& centroids, std::vector<Track>& died);
+
+    /// Whether events of the instance were alive at the previous step, so that their death can be reported.
+    bool tracking(size_t instance) const { return instance < previous_.size() && !previous_[instance].empty(); }
+
+    /// Returns the lifecycle state as a lowercase string, e.g. `moved`.
+    static std::string stateName(State state);
+
+    /// Formats a track as a JSON object for the notification payload.
+    static std::string toJson(const Track& track);
+
+private:
+    struct Tracked {
+        uint64_t id;
+        std::vector<int> cells;
+        atlas::PointLonLat centroid;
+    };
+
+    double maxDistance_;
+    uint64_t nextId_;
+    uint64_t idStride_;
+    std::vector<std::vector<Tracked>> previous_;  ///< Events of each instance at the previous step
+};
+
+}  // namespace ExtremeEventPlugin
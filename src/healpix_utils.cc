@@ -8,12 +8,19 @@
  * granted to it by virtue of its status as an intergovernmental organisation nor
  * does it submit to any jurisdiction.
  */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <string>
+
 #include "atlas/functionspace.h"
 #include "atlas/library.h"
 #include "atlas/mesh.h"
 #include "atlas/parallel/mpi/mpi.h"
 #include "atlas/runtime/Log.h"
 #include "atlas/util/KDTree.h"
+#include "eckit/exception/Exceptions.h"
 
 #include "healpix_utils.h"
 
@@ -24,25 +31,91 @@ namespace HEALPixUtils {
 
 void mapLonLatToHEALPixCell(int resolution, const atlas::FunctionSpace& modelFS, std::vector<int>& mappingVector,
                             std::vector<std::vector<atlas::PointLonLat>>& cellVertices) {
-    /* Generate a HEALPix mesh
-    The resolution is expected to be coarse enough to avoid the need for
-    partitioning the mesh. Each partition has access to the global indices of the
-    HEALPix mesh.
-    /!\ If this were to change, the mesh needs to change to include a halo of 1,
-    otherwise there might be an edge case where the search tree isn't populated
-    with all the necessary cells to produce the mapping.
+    CellSearch search;
+    cellVertices.clear();
+    mapLonLatToHEALPixCell(resolution, modelFS, mappingVector, cellVertices, search);
+}
+
+void mapLonLatToHEALPixCell(int resolution, const atlas::FunctionSpace& modelFS, std::vector<int>& mappingVector,
+                            std::vector<std::vector<atlas::PointLonLat>>& cellVertices, CellSearch& search) {
+    if (cellVertices.empty()) {
+        /* Generate a HEALPix mesh
+        The resolution is expected to be coarse enough to avoid the need for
+        partitioning the mesh. Each partition has access to the global indices of the
+        HEALPix mesh.
+        /!\ If this were to change, the mesh needs to change to include a halo of 1,
+        otherwise there might be an edge case where the search tree isn't populated
+        with all the necessary cells to produce the mapping.
+        */
+        atlas::Grid grid("H" + std::to_string(resolution));
+        atlas::util::Config healpix_config;
+        healpix_config.set("pole_elements", "pentagons");
+        healpix_config.set("mpi_comm", "self");
+        atlas::Mesh HPmesh(grid, healpix_config);
+        atlas::functionspace::CellColumns healpix_cell_fs(HPmesh);
+
+        // Create and populate a KDTree search to find closest HP cell from the lonlat coordinates of the cell centres
+        auto healpix_lonlat = atlas::array::make_view<double, 2>(healpix_cell_fs.lonlat());
+        search              = CellSearch();
+        search.reserve(healpix_lonlat.shape(0));
+        for (atlas::idx_t jcell = 0; jcell < healpix_lonlat.shape(0); ++jcell) {
+            atlas::PointLonLat p{healpix_lonlat(jcell, 0), healpix_lonlat(jcell, 1)};
+            search.insert(p, jcell);
+        }
+        search.build();
+
+        // Now map the vertices lonlat coordinates of each cell
+        auto healpix_nodes_lonlat = atlas::array::make_view<double, 2>(HPmesh.nodes().lonlat());
+        auto& cell2node           = HPmesh.cells().node_connectivity();
+        std::vector<atlas::idx_t> nodes(cell2node.maxcols());
+        cellVertices.resize(HPmesh.cells().size());
+        for (atlas::idx_t jcell = 0; jcell < HPmesh.cells().size(); ++jcell) {
+            atlas::idx_t nb_nodes_per_cell = cell2node.cols(jcell);
+            for (atlas::idx_t jnode = 0; jnode < nb_nodes_per_cell; ++jnode) {
+                nodes[jnode] = cell2node(jcell, jnode);
+                // store the lonlat of the nodes in cellVertices
+                cellVertices[jcell].push_back(
+                    atlas::PointLonLat{healpix_nodes_lonlat(nodes[jnode], 0), healpix_nodes_lonlat(nodes[jnode], 1)});
+            }
+        }
+    }
+
+    auto model_lonlat = atlas::array::make_view<double, 2>(modelFS.lonlat());
+    // Halo: value 0 everywhere except in halo cells
+    auto model_ghost = atlas::array::make_view<int, 1>(modelFS.ghost());
+    // Resize the mapping vector to the size of model grid points
+    mappingVector.resize(modelFS.size());
+    // Search for the closest cell in the HEALPix mesh
+    for (atlas::idx_t j = 0; j < model_lonlat.shape(0); ++j) {
+        // Skip grid points in halo as their detection is run in another partition
+        if (model_ghost[j]) {
+            // Cell global indexing starts with 1 but we use 0 to map to the vector
+            // containing the cell vertices, so using -1 as invalid value for halo
+            // points
+            mappingVector[j] = -1;
+            continue;
+        }
+        atlas::PointLonLat p{model_lonlat(j, 0), model_lonlat(j, 1)};
+        auto closest     = search.closestPoint(p);
+        mappingVector[j] = closest.payload();
+    }
+}
+
+void mapLonLatToLocalHEALPixCells(int resolution, const atlas::FunctionSpace& modelFS, std::vector<int>& mappingVector,
+                                  CellVertexMap& cellVertices) {
+    /* Generate the part of the HEALPix mesh matching the model partition
+    The HEALPix cells are distributed like the model grid points, so each partition only generates the cells around
+    its own points. The closest cell centre to a point near the partition boundary can belong to the neighbouring
+    partition, so the search also includes a halo of one cell.
     */
     atlas::Grid grid("H" + std::to_string(resolution));
     atlas::util::Config healpix_config;
     healpix_config.set("pole_elements", "pentagons");
-    healpix_config.set("mpi_comm", "self");
-    atlas::Mesh HPmesh(grid, healpix_config);
-    atlas::functionspace::CellColumns healpix_cell_fs(HPmesh);
+    atlas::Mesh HPmesh(grid, atlas::grid::MatchingPartitioner(modelFS), healpix_config);
+    atlas::functionspace::CellColumns healpix_cell_fs(HPmesh, atlas::option::halo(1));
 
-    // Get the lonlat coordinates and global indices of the HP mesh cell centres
     auto healpix_lonlat = atlas::array::make_view<double, 2>(healpix_cell_fs.lonlat());
     auto healpix_gidx   = atlas::array::make_view<atlas::gidx_t, 1>(healpix_cell_fs.global_index());
-    // Create and populate a KDTree search to find closest HP cell
     atlas::util::IndexKDTree search;
     search.reserve(healpix_lonlat.shape(0));
     for (atlas::idx_t jcell = 0; jcell < healpix_lonlat.shape(0); ++jcell) {
@@ -51,59 +124,310 @@ void mapLonLatToHEALPixCell(int resolution, const atlas::FunctionSpace& modelFS,
     }
     search.build();
 
-    auto model_lonlat = atlas::array::make_view<double, 2>(modelFS.lonlat());
-    // Halo: value 0 everywhere except in halo cells
-    auto model_ghost = atlas::array::make_view<int, 1>(modelFS.ghost());
-    // Resize the mapping vector to the size of model grid points
+    auto model_lonlat         = atlas::array::make_view<double, 2>(modelFS.lonlat());
+    auto model_ghost          = atlas::array::make_view<int, 1>(modelFS.ghost());
+    auto healpix_nodes_lonlat = atlas::array::make_view<double, 2>(HPmesh.nodes().lonlat());
+    auto& cell2node           = HPmesh.cells().node_connectivity();
     mappingVector.resize(modelFS.size());
-    // Search for the closest cell in the HEALPix mesh
+    cellVertices.clear();
     for (atlas::idx_t j = 0; j < model_lonlat.shape(0); ++j) {
-        // Skip grid points in halo as their detection is run in another partition
         if (model_ghost[j]) {
-            // Cell global indexing starts with 1 but we use 0 to map to the vector
-            // containing the cell vertices, so using -1 as invalid value for halo
-            // points
             mappingVector[j] = -1;
             continue;
         }
         atlas::PointLonLat p{model_lonlat(j, 0), model_lonlat(j, 1)};
-        auto closest     = search.closestPoint(p);
-        mappingVector[j] = closest.payload();
+        atlas::idx_t jcell = search.closestPoint(p).payload();
+        // Global cell indexing starts with 1, the global index is kept so that the cells are the same on all ranks
+        int cell         = static_cast<int>(healpix_gidx(jcell)) - 1;
+        mappingVector[j] = cell;
+        // Only the vertices of the cells containing owned points are kept
+        auto inserted = cellVertices.emplace(cell, std::vector<atlas::PointLonLat>{});
+        if (inserted.second) {
+            for (atlas::idx_t jnode = 0; jnode < cell2node.cols(jcell); ++jnode) {
+                atlas::idx_t node = cell2node(jcell, jnode);
+                inserted.first->second.push_back(
+                    atlas::PointLonLat{healpix_nodes_lonlat(node, 0), healpix_nodes_lonlat(node, 1)});
+            }
+        }
     }
+}
+
+int parentCell(int cell, int resolution, int coarseResolution) {
+    int shift = 0;
+    while (shift < 30 && (coarseResolution << shift) < resolution) {
+        ++shift;
+    }
+    if (coarseResolution <= 0 || (coarseResolution << shift) != resolution) {
+        throw eckit::BadParameter("The HEALPix resolution " + std::to_string(coarseResolution) +
+                                      " is not the resolution " + std::to_string(resolution) +
+                                      " divided by a power of two",
+                                  Here());
+    }
+    // Ring and column of the first cell of each base face, in units of the resolution (Gorski et al. 2005)
+    static const int jrll[12] = {2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4};
+    static const int jpll[12] = {1, 3, 5, 7, 0, 2, 4, 6, 1, 3, 5, 7};
+    auto isqrt                = [](int64_t value) {
+        auto root = static_cast<int64_t>(std::sqrt(static_cast<double>(value)));
+        while (root * root > value) {
+            --root;
+        }
+        while ((root + 1) * (root + 1) <= value) {
+            ++root;
+        }
+        return root;
+    };
+
+    // Ring index to the (x, y) coordinates of the cell within its base face
+    const int64_t nside = resolution;
+    const int64_t ncap  = 2 * nside * (nside - 1);
+    const int64_t npix  = 12 * nside * nside;
+    const int64_t pix   = cell;
+    int64_t iring, iphi, kshift, nr, face;
+    if (pix < ncap) {  // North polar cap
+        iring  = (1 + isqrt(1 + 2 * pix)) >> 1;
+        iphi   = (pix + 1) - 2 * iring * (iring - 1);
+        kshift = 0;
+        nr     = iring;
+        face   = (iphi - 1) / nr;
+    }
+    else if (pix < npix - ncap) {  // Equatorial belt
+        const int64_t ip  = pix - ncap;
+        const int64_t tmp = ip / (4 * nside);
+        iring             = tmp + nside;
+        iphi              = ip - tmp * 4 * nside + 1;
+        kshift            = (iring + nside) & 1;
+        nr                = nside;
+        const int64_t ire = tmp + 1;
+        const int64_t irm = 2 * nside + 2 - ire;
+        const int64_t ifm = (iphi - ire / 2 + nside - 1) / nside;
+        const int64_t ifp = (iphi - irm / 2 + nside - 1) / nside;
+        face              = ifp == ifm ? (ifp | 4) : (ifp < ifm ? ifp : ifm + 8);
+    }
+    else {  // South polar cap
+        const int64_t ip = npix - pix;
+        iring            = (1 + isqrt(2 * ip - 1)) >> 1;
+        iphi             = 4 * iring + 1 - (ip - 2 * iring * (iring - 1));
+        kshift           = 0;
+        nr               = iring;
+        iring            = 4 * nside - iring;
+        face             = (iphi - 1) / nr + 8;
+    }
+    const int64_t irt = iring - jrll[face] * nside + 1;
+    int64_t ipt       = 2 * iphi - jpll[face] * nr - kshift - 1;
+    if (ipt >= 2 * nside) {
+        ipt -= 8 * nside;
+    }
+    const int64_t ix = ((ipt - irt) >> 1) >> shift;
+    const int64_t iy = ((-ipt - irt) >> 1) >> shift;
+
+    // Coordinates of the coarse cell within the same face to its ring index
+    const int64_t cside = coarseResolution;
+    const int64_t jr    = jrll[face] * cside - ix - iy - 1;
+    const int64_t cpix  = 12 * cside * cside;
+    const int64_t cncap = 2 * cside * (cside - 1);
+    int64_t before;
+    if (jr < cside) {
+        nr     = jr;
+        before = 2 * nr * (nr - 1);
+        kshift = 0;
+    }
+    else if (jr > 3 * cside) {
+        nr     = 4 * cside - jr;
+        before = cpix - 2 * (nr + 1) * nr;
+        kshift = 0;
+    }
+    else {
+        nr     = cside;
+        before = cncap + (jr - cside) * 4 * cside;
+        kshift = (jr - cside) & 1;
+    }
+    int64_t jp = (jpll[face] * nr + ix - iy + 1 + kshift) / 2;
+    if (jp > 4 * cside) {
+        jp -= 4 * cside;
+    }
+    else if (jp < 1) {
+        jp += 4 * cside;
+    }
+    return static_cast<int>(before + jp - 1);
+}
 
-    // Now map the vertices lonlat coordinates of each cell
+void mapHEALPixCellsToCoarserCells(int resolution, int fineResolution, std::vector<int>& mappingVector,
+                                   std::vector<std::vector<atlas::PointLonLat>>& cellVertices) {
+    // Only the fine cells are mapped, not the model grid points
+    mappingVector.resize(12 * static_cast<size_t>(fineResolution) * fineResolution);
+    for (size_t cell = 0; cell < mappingVector.size(); ++cell) {
+        mappingVector[cell] = parentCell(static_cast<int>(cell), fineResolution, resolution);
+    }
+
+    // The coarse mesh is generated globally on each rank for its vertices, like the finer one
+    atlas::Grid grid("H" + std::to_string(resolution));
+    atlas::util::Config healpix_config;
+    healpix_config.set("pole_elements", "pentagons");
+    healpix_config.set("mpi_comm", "self");
+    atlas::Mesh HPmesh(grid, healpix_config);
     auto healpix_nodes_lonlat = atlas::array::make_view<double, 2>(HPmesh.nodes().lonlat());
     auto& cell2node           = HPmesh.cells().node_connectivity();
-    std::vector<atlas::idx_t> nodes(cell2node.maxcols());
-    cellVertices.resize(HPmesh.cells().size());
+    cellVertices.assign(HPmesh.cells().size(), {});
     for (atlas::idx_t jcell = 0; jcell < HPmesh.cells().size(); ++jcell) {
-        atlas::idx_t nb_nodes_per_cell = cell2node.cols(jcell);
-        for (atlas::idx_t jnode = 0; jnode < nb_nodes_per_cell; ++jnode) {
-            nodes[jnode] = cell2node(jcell, jnode);
-            // store the lonlat of the nodes in cellVertices
+        for (atlas::idx_t jnode = 0; jnode < cell2node.cols(jcell); ++jnode) {
+            atlas::idx_t node = cell2node(jcell, jnode);
             cellVertices[jcell].push_back(
-                atlas::PointLonLat{healpix_nodes_lonlat(nodes[jnode], 0), healpix_nodes_lonlat(nodes[jnode], 1)});
+                atlas::PointLonLat{healpix_nodes_lonlat(node, 0), healpix_nodes_lonlat(node, 1)});
         }
     }
 }
 
-std::vector<std::vector<atlas::PointLonLat>> cellToPolygons(std::vector<int>& eeIndices, std::vector<int>& mapping,
-                                                            std::vector<std::vector<atlas::PointLonLat>>& vertices) {
-    std::vector<std::vector<atlas::PointLonLat>> ee_polygons;
-    // 1. Find HealPix cells from EE points indices
-    std::set<int> ee_cells;
+void mapLocalHEALPixCellsToCoarserCells(int resolution, int fineResolution, const atlas::FunctionSpace& modelFS,
+                                        const std::vector<int>& fineCells, std::unordered_map<int, int>& mapping,
+                                        CellVertexMap& cellVertices) {
+    // The parents of the fine cells of the partition contain its points, so lie within the halo of its coarse cells
+    atlas::Grid grid("H" + std::to_string(resolution));
+    atlas::util::Config healpix_config;
+    healpix_config.set("pole_elements", "pentagons");
+    atlas::Mesh HPmesh(grid, atlas::grid::MatchingPartitioner(modelFS), healpix_config);
+    atlas::functionspace::CellColumns healpix_cell_fs(HPmesh, atlas::option::halo(1));
+
+    auto healpix_gidx = atlas::array::make_view<atlas::gidx_t, 1>(healpix_cell_fs.global_index());
+    std::unordered_map<int, atlas::idx_t> local;
+    for (atlas::idx_t jcell = 0; jcell < healpix_gidx.shape(0); ++jcell) {
+        // Global cell indexing starts with 1, like for the finer cells
+        local.emplace(static_cast<int>(healpix_gidx(jcell)) - 1, jcell);
+    }
+
+    auto healpix_nodes_lonlat = atlas::array::make_view<double, 2>(HPmesh.nodes().lonlat());
+    auto& cell2node           = HPmesh.cells().node_connectivity();
+    for (int fine : fineCells) {
+        if (fine < 0 || mapping.count(fine)) {
+            continue;
+        }
+        const int cell = parentCell(fine, fineResolution, resolution);
+        mapping[fine]  = cell;
+        auto inserted  = cellVertices.emplace(cell, std::vector<atlas::PointLonLat>{});
+        if (!inserted.second) {
+            continue;
+        }
+        auto jcell = local.find(cell);
+        if (jcell == local.end()) {
+            throw eckit::SeriousBug("The HEALPix cell " + std::to_string(cell) + " at resolution " +
+                                        std::to_string(resolution) + " is not around the partition",
+                                    Here());
+        }
+        for (atlas::idx_t jnode = 0; jnode < cell2node.cols(jcell->second); ++jnode) {
+            atlas::idx_t node = cell2node(jcell->second, jnode);
+            inserted.first->second.push_back(
+                atlas::PointLonLat{healpix_nodes_lonlat(node, 0), healpix_nodes_lonlat(node, 1)});
+        }
+    }
+}
+
+std::vector<int> coarserCells(const std::vector<int>& cells, const std::vector<int>& mapping) {
+    std::vector<int> coarse;
+    coarse.reserve(cells.size());
+    for (int cell : cells) {
+        coarse.push_back(mapping[cell]);
+    }
+    std::sort(coarse.begin(), coarse.end());
+    coarse.erase(std::unique(coarse.begin(), coarse.end()), coarse.end());
+    return coarse;
+}
+
+std::vector<int> coarserCells(const std::vector<int>& cells, const std::unordered_map<int, int>& mapping) {
+    std::vector<int> coarse;
+    coarse.reserve(cells.size());
+    for (int cell : cells) {
+        coarse.push_back(mapping.at(cell));
+    }
+    std::sort(coarse.begin(), coarse.end());
+    coarse.erase(std::unique(coarse.begin(), coarse.end()), coarse.end());
+    return coarse;
+}
+
+std::vector<int> pointsToCells(const std::vector<int>& eeIndices, const std::vector<int>& mapping) {
+    std::vector<int> ee_cells;
+    ee_cells.reserve(eeIndices.size());
     for (const int& point_idx : eeIndices) {
-        ee_cells.insert(mapping[point_idx]);
+        ee_cells.push_back(mapping[point_idx]);
+    }
+    std::sort(ee_cells.begin(), ee_cells.end());
+    ee_cells.erase(std::unique(ee_cells.begin(), ee_cells.end()), ee_cells.end());
+    return ee_cells;
+}
+
+namespace {
+
+const std::vector<atlas::PointLonLat>& verticesOf(const std::vector<std::vector<atlas::PointLonLat>>& vertices,
+                                                  int cell) {
+    return vertices[cell];
+}
+
+const std::vector<atlas::PointLonLat>& verticesOf(const CellVertexMap& vertices, int cell) {
+    return vertices.at(cell);
+}
+
+template <typename Vertices>
+std::vector<std::vector<int>> groupContiguousCells(const std::vector<int>& ee_cells, const Vertices& vertices) {
+    // Union-find over the cells, two cells sharing a vertex belong to the same group
+    std::vector<size_t> parent(ee_cells.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto root = [&parent](size_t idx) {
+        while (parent[idx] != idx) {
+            parent[idx] = parent[parent[idx]];
+            idx         = parent[idx];
+        }
+        return idx;
+    };
+    std::map<atlas::PointLonLat, size_t> vertexCell;
+    for (size_t idx = 0; idx < ee_cells.size(); ++idx) {
+        for (const auto& vertex : verticesOf(vertices, ee_cells[idx])) {
+            auto known = vertexCell.emplace(vertex, idx);
+            if (!known.second) {
+                parent[root(idx)] = root(known.first->second);
+            }
+        }
     }
-    // 2. separate contiguous events and remove inner vertices
+    // Groups are ordered by their first cell, and keep the order of the cells
+    std::vector<std::vector<int>> groups;
+    std::unordered_map<size_t, size_t> groupOfRoot;
+    for (size_t idx = 0; idx < ee_cells.size(); ++idx) {
+        auto group = groupOfRoot.emplace(root(idx), groups.size());
+        if (group.second) {
+            groups.emplace_back();
+        }
+        groups[group.first->second].push_back(ee_cells[idx]);
+    }
+    return groups;
+}
+
+template <typename Vertices>
+atlas::PointLonLat centroidOfCells(const std::vector<int>& ee_cells, const Vertices& vertices) {
+    // Mean of the vertices on the unit sphere, which is not affected by the date line
+    const double toRad = M_PI / 180.0;
+    double x           = 0.0;
+    double y           = 0.0;
+    double z           = 0.0;
+    for (int cell : ee_cells) {
+        for (const auto& vertex : verticesOf(vertices, cell)) {
+            x += std::cos(vertex.lat() * toRad) * std::cos(vertex.lon() * toRad);
+            y += std::cos(vertex.lat() * toRad) * std::sin(vertex.lon() * toRad);
+            z += std::sin(vertex.lat() * toRad);
+        }
+    }
+    return atlas::PointLonLat(std::atan2(y, x) / toRad, std::atan2(z, std::hypot(x, y)) / toRad);
+}
+
+template <typename Vertices>
+std::vector<std::vector<atlas::PointLonLat>> polygonsFromCells(const std::vector<int>& ee_cells,
+                                                               const Vertices& vertices) {
+    std::vector<std::vector<atlas::PointLonLat>> ee_polygons;
+    // 1. separate contiguous events and remove inner vertices
     // TODO: edge case: a region with holes has been detected
     // currently will end up with two separate events: hole and borders
     std::map<std::pair<atlas::PointLonLat, atlas::PointLonLat>, int> count_edges;
     for (const int& cell_idx : ee_cells) {
-        for (size_t vidx = 0; vidx < vertices[cell_idx].size(); ++vidx) {
+        const auto& cell = verticesOf(vertices, cell_idx);
+        for (size_t vidx = 0; vidx < cell.size(); ++vidx) {
             // Add all cell edges, handles quads and pents pole elements
-            std::pair<atlas::PointLonLat, atlas::PointLonLat> ee_edge = {
-                vertices[cell_idx][vidx], vertices[cell_idx][(vidx + 1) % vertices[cell_idx].size()]};
+            std::pair<atlas::PointLonLat, atlas::PointLonLat> ee_edge = {cell[vidx], cell[(vidx + 1) % cell.size()]};
             if (count_edges.find(ee_edge) != count_edges.end()) {
                 ++count_edges[ee_edge];
             }
@@ -179,4 +503,40 @@ std::vector<std::vector<atlas::PointLonLat>> cellToPolygons(std::vector<int>& ee
     return ee_polygons;
 }
 
+}  // namespace
+
+std::vector<std::vector<atlas::PointLonLat>> cellsToPolygons(
+    const std::vector<int>& ee_cells, const std::vector<std::vector<atlas::PointLonLat>>& vertices) {
+    return polygonsFromCells(ee_cells, vertices);
+}
+
+std::vector<std::vector<atlas::PointLonLat>> cellsToPolygons(const std::vector<int>& ee_cells,
+                                                             const CellVertexMap& vertices) {
+    return polygonsFromCells(ee_cells, vertices);
+}
+
+std::vector<std::vector<int>> contiguousCells(const std::vector<int>& ee_cells,
+                                              const std::vector<std::vector<atlas::PointLonLat>>& vertices) {
+    return groupContiguousCells(ee_cells, vertices);
+}
+
+std::vector<std::vector<int>> contiguousCells(const std::vector<int>& ee_cells, const CellVertexMap& vertices) {
+    return groupContiguousCells(ee_cells, vertices);
+}
+
+atlas::PointLonLat cellsCentroid(const std::vector<int>& ee_cells,
+                                 const std::vector<std::vector<atlas::PointLonLat>>& vertices) {
+    return centroidOfCells(ee_cells, vertices);
+}
+
+atlas::PointLonLat cellsCentroid(const std::vector<int>& ee_cells, const CellVertexMap& vertices) {
+    return centroidOfCells(ee_cells, vertices);
+}
+
+std::vector<std::vector<atlas::PointLonLat>> cellToPolygons(
+    const std::vector<int>& eeIndices, const std::vector<int>& mapping,
+    const std::vector<std::vector<atlas::PointLonLat>>& vertices) {
+    return cellsToPolygons(pointsToCells(eeIndices, mapping), vertices);
+}
+
 }  // namespace HEALPixUtils
\ No newline at end of file
@@ -8,11 +8,20 @@
  * granted to it by virtue of its status as an intergovernmental organisation nor
  * does it submit to any jurisdiction.
  */
+#include <unordered_map>
+
 #include "atlas/functionspace.h"
 #include "atlas/grid.h"
+#include "atlas/util/KDTree.h"
 
 namespace HEALPixUtils {
 
+/// Vertices of a subset of the HEALPix cells, keyed by global cell index (starting at 0).
+using CellVertexMap = std::unordered_map<int, std::vector<atlas::PointLonLat>>;
+
+/// Search tree of the cell centres of a global HEALPix mesh, the payload of each centre is the index of its cell.
+using CellSearch = atlas::util::IndexKDTree;
+
 /**
  * @brief Creates a mapping of grid points from a given function space to the HEALPix cell they belong to.
  * 
@@ -29,22 +38,176 @@ void mapLonLatToHEALPixCell(int resolution, const atlas::FunctionSpace& modelFS,
                             std::vector<std::vector<atlas::PointLonLat>>& cellVertices);
 
 /**
- * @brief Extracts HEALPix polygons from given firing points.
+ * @brief Creates the same mapping as above, reusing the global HEALPix mesh of a previous call.
+ *
+ * The mesh does not depend on the function space, so it is only generated when `cellVertices` is empty. Its vertices
+ * and the search tree of its cell centres are then kept in `cellVertices` and `search`, and the following calls with
+ * the same arguments only search the points of their function space.
+ *
+ * @param[in] resolution The HEALPix resolution to use for the HEALPix mesh.
+ * @param[in] modelFS The function space to map to HEALPix cells.
+ * @param[out] mappingVector The vector mapping grid point remote indices to global HEALPix cell indices.
+ * @param[in,out] cellVertices The vertices of each cell of the mesh, filled by the first call.
+ * @param[in,out] search The search tree of the cell centres of the mesh, filled by the first call.
+ */
+void mapLonLatToHEALPixCell(int resolution, const atlas::FunctionSpace& modelFS, std::vector<int>& mappingVector,
+                            std::vector<std::vector<atlas::PointLonLat>>& cellVertices, CellSearch& search);
+
+/**
+ * @brief Creates the same mapping as `mapLonLatToHEALPixCell`, from the part of the HEALPix mesh around the partition.
+ *
+ * The HEALPix mesh is distributed to match the partitioning of the model function space, with a halo of one cell,
+ * instead of being generated globally on every rank, and only the vertices of the cells containing owned points are
+ * kept. The memory and setup time then scale with the size of the partition rather than with the HEALPix resolution.
+ * Points are mapped to the global index of their cell, so the polygons are the same as with the global mesh.
+ *
+ * This is a collective operation over the model communicator.
+ *
+ * @param[in] resolution The HEALPix resolution to use for the HEALPix mesh.
+ * @param[in] modelFS The function space to map to HEALPix cells.
+ * @param[out] mappingVector The vector mapping grid point remote indices to global HEALPix cell indices.
+ * @param[out] cellVertices The vertex coordinates of the cells containing at least one owned point.
+ */
+void mapLonLatToLocalHEALPixCells(int resolution, const atlas::FunctionSpace& modelFS, std::vector<int>& mappingVector,
+                                  CellVertexMap& cellVertices);
+
+/**
+ * @brief Returns the cell of a coarser HEALPix mesh containing a cell of a finer one, both indexed in ring order.
+ *
+ * The HEALPix cells are nested: within each of the 12 base faces, the cell (x, y) at resolution `N` lies in the cell
+ * (x >> k, y >> k) at resolution `N >> k`. The ring index is converted to the (x, y, face) coordinates of the cell,
+ * shifted, and converted back to a ring index, so the parent is exact whatever the shape of the cells.
+ *
+ * @param cell The ring index of the fine cell.
+ * @param resolution The resolution of the finer HEALPix mesh.
+ * @param coarseResolution The resolution of the coarser HEALPix mesh.
+ * @return The ring index of the coarse cell containing the fine cell.
+ * @throws eckit::BadParameter if the coarse resolution is not the fine one divided by a power of two.
+ */
+int parentCell(int cell, int resolution, int coarseResolution);
+
+/**
+ * @brief Maps the cells of a HEALPix mesh to the cells of a coarser HEALPix mesh containing them.
+ *
+ * This derives a coarser resolution from the mapping of the model grid points at a finer one, without searching the
+ * grid points again: each fine cell goes to its parent cell, see `parentCell`.
+ *
+ * @param[in] resolution The resolution of the coarser HEALPix mesh.
+ * @param[in] fineResolution The resolution of the finer HEALPix mesh, the coarser one times a power of two.
+ * @param[out] mappingVector The index of the coarse cell of each fine cell.
+ * @param[out] cellVertices The vector mapping a coarse cell index to its vertex coordinates.
+ */
+void mapHEALPixCellsToCoarserCells(int resolution, int fineResolution, std::vector<int>& mappingVector,
+                                   std::vector<std::vector<atlas::PointLonLat>>& cellVertices);
+
+/**
+ * @brief Creates the same mapping as `mapHEALPixCellsToCoarserCells`, from the part of the coarse mesh around the
+ *        points of a function space.
+ *
+ * The coarse HEALPix mesh is distributed like the model function space with a halo of one cell, and only the vertices
+ * of the parents of the fine cells of the function space are kept. The mapping and the vertices are added to those of
+ * the previous calls, so that the fine cells of several function spaces, each distributed its own way, get their
+ * parents from the mesh distributed like them. This is a collective operation over the model communicator.
+ *
+ * @param[in] resolution The resolution of the coarser HEALPix mesh.
+ * @param[in] fineResolution The resolution of the finer HEALPix mesh, the coarser one times a power of two.
+ * @param[in] modelFS The function space the coarse mesh is distributed like.
+ * @param[in] fineCells The fine cell of each point of the function space, -1 for the halo.
+ * @param[in,out] mapping The global index of the coarse cell of each fine cell.
+ * @param[in,out] cellVertices The vertex coordinates of the coarse cells containing fine cells of the partition.
+ * @throws eckit::SeriousBug if the parent of a fine cell lies outside the coarse cells around the partition.
+ */
+void mapLocalHEALPixCellsToCoarserCells(int resolution, int fineResolution, const atlas::FunctionSpace& modelFS,
+                                        const std::vector<int>& fineCells, std::unordered_map<int, int>& mapping,
+                                        CellVertexMap& cellVertices);
+
+/**
+ * @brief Finds the HEALPix cells containing given firing points.
+ *
+ * @param eeIndices The indices of the firing points on the model function space.
+ * @param mapping The grid point to HEALPix cell mapping vector.
+ *
+ * @return The sorted indices of the cells containing at least one of the firing points, without duplicates.
+ */
+std::vector<int> pointsToCells(const std::vector<int>& eeIndices, const std::vector<int>& mapping);
+
+/**
+ * @brief Finds the coarser HEALPix cells containing given cells.
+ *
+ * @param cells The indices of the cells at the finer resolution.
+ * @param mapping The fine cell to coarse cell mapping, from `mapHEALPixCellsToCoarserCells`.
+ *
+ * @return The sorted indices of the coarse cells, without duplicates.
+ */
+std::vector<int> coarserCells(const std::vector<int>& cells, const std::vector<int>& mapping);
+
+/// Same as above, with the mapping of the cells known to the partition only.
+std::vector<int> coarserCells(const std::vector<int>& cells, const std::unordered_map<int, int>& mapping);
+
+/**
+ * @brief Extracts HEALPix polygons from given firing cells.
  * 
  * This extraction function uses a map of the edges of the cells to determine contigous events, remove inner edges
  * which are not on a polygon boundary, and traverse vertices in a counter clockwise manner to ensure points are
  * populated in an order that correctly defines a polygon.
  * 
- * @param eeIndices The indices of the firing points on the model function space.
- * @param mapping The grid point to HEALPix cell mapping vector.
+ * @param cells The indices of the firing HEALPix cells.
  * @param vertices The HEALPix cell to its vertices coordinates mapping vector.
  * 
- * @return A vector containing all the polygons extracted from the firing points.
+ * @return A vector containing all the polygons extracted from the firing cells.
  * 
  * @warning All edge cases are not handled: - polygons with holes (holes are misclassified as single events)
  *                                          - global HEALPix mesh firing (the event is discarded)
  */
-std::vector<std::vector<atlas::PointLonLat>> cellToPolygons(std::vector<int>& eeIndices, std::vector<int>& mapping,
-                                                            std::vector<std::vector<atlas::PointLonLat>>& vertices);
+std::vector<std::vector<atlas::PointLonLat>> cellsToPolygons(
+    const std::vector<int>& cells, const std::vector<std::vector<atlas::PointLonLat>>& vertices);
+
+/// Same as above, with the vertices of the cells known to the partition only.
+std::vector<std::vector<atlas::PointLonLat>> cellsToPolygons(const std::vector<int>& cells,
+                                                             const CellVertexMap& vertices);
+
+/**
+ * @brief Groups firing cells into contiguous events, cells being contiguous if they share a vertex.
+ *
+ * Each group gives the same polygons with `cellsToPolygons` as it does within all the cells, which allows tagging
+ * each polygon with the statistics of its own cells.
+ *
+ * @param cells The indices of the firing HEALPix cells.
+ * @param vertices The HEALPix cell to its vertices coordinates mapping vector.
+ *
+ * @return The cells of each contiguous event, ordered by their first cell.
+ */
+std::vector<std::vector<int>> contiguousCells(const std::vector<int>& cells,
+                                              const std::vector<std::vector<atlas::PointLonLat>>& vertices);
+
+/// Same as above, with the vertices of the cells known to the partition only.
+std::vector<std::vector<int>> contiguousCells(const std::vector<int>& cells, const CellVertexMap& vertices);
+
+/**
+ * @brief Computes the centroid of a group of cells, from the mean of their vertices on the sphere.
+ *
+ * @param cells The indices of the HEALPix cells.
+ * @param vertices The HEALPix cell to its vertices coordinates mapping vector.
+ */
+atlas::PointLonLat cellsCentroid(const std::vector<int>& cells,
+                                 const std::vector<std::vector<atlas::PointLonLat>>& vertices);
+
+/// Same as above, with the vertices of the cells known to the partition only.
+atlas::PointLonLat cellsCentroid(const std::vector<int>& cells, const CellVertexMap& vertices);
+
+/**
+ * @brief Extracts HEALPix polygons from given firing points.
+ * 
+ * Shorthand for `cellsToPolygons(pointsToCells(eeIndices, mapping), vertices)`.
+ * 
+ * @param eeIndices The indices of the firing points on the model function space.
+ * @param mapping The grid point to HEALPix cell mapping vector.
+ * @param vertices The HEALPix cell to its vertices coordinates mapping vector.
+ * 
+ * @return A vector containing all the polygons extracted from the firing points.
+ */
+std::vector<std::vector<atlas::PointLonLat>> cellToPolygons(
+    const std::vector<int>& eeIndices, const std::vector<int>& mapping,
+    const std::vector<std::vector<atlas::PointLonLat>>& vertices);
 
 }  // namespace HEALPixUtils
\ No newline at end of file
@@ -24,7 +24,7 @@ AvisoNotificationHandler::AvisoNotificationHandler(const std::string& base, cons
     setSchemaData();
 }
 
-std::string AvisoNotificationHandler::urlEncode(const std::string polygon) {
+std::string AvisoNotificationHandler::urlEncode(const std::string polygon, const std::string& endpointUrl) const {
     std::ostringstream urlStream;
 
     urlStream << "?";
@@ -35,16 +35,17 @@ std::string AvisoNotificationHandler::urlEncode(const std::string polygon) {
     }
     urlStream << "polygon=" << polygon;
 
-    return urlNotify_ + urlStream.str();
+    return endpointUrl + urlStream.str();
 }
 
-std::string AvisoNotificationHandler::urlEncode(const std::vector<atlas::PointLonLat>& polygon) {
+std::string AvisoNotificationHandler::urlEncode(const std::vector<atlas::PointLonLat>& polygon,
+                                                const std::string& endpointUrl) const {
     std::ostringstream polygonStr;
     for (size_t i = 0; i < polygon.size() - 1; ++i) {
         polygonStr << polygon[i].lat() << "," << polygon[i].lon() << ",";
     }
     polygonStr << polygon.back().lat() << "," << polygon.back().lon();
-    return urlEncode(polygonStr.str());
+    return urlEncode(polygonStr.str(), endpointUrl);
 }
 
 void AvisoNotificationHandler::setSchemaData() {
@@ -62,19 +63,25 @@ void AvisoNotificationHandler::setSchemaData() {
 }
 
 int AvisoNotificationHandler::send(const std::string payload, const std::vector<atlas::PointLonLat>& polygon) {
+    return post(urlEncode(polygon, urlNotify_), payload);
+}
+
+int AvisoNotificationHandler::post(const std::string& url, const std::string& payload) const {
     EasyCURLHeaders headers;
     headers["content-type"] = "application/json";
 
     auto curl = EasyCURL();
     curl.headers(headers);
 
-    if (atoi(std::getenv("PLUME_PLUGIN_DEV"))) {
+    const char* devMode = std::getenv("PLUME_PLUGIN_DEV");
+    if (devMode && atoi(devMode)) {
         // For convenience to avoid sending Aviso notifications while developing
-        std::cout << urlEncode(polygon) << " " << payload << std::endl;
-        return 999;
+        // No flush on each notification, the standard output is flushed by the model as usual
+        std::cout << url << " " << payload << "\n";
+        return devModeCode;
     }
     else {
-        auto response = curl.POST(urlEncode(polygon), payload);
+        auto response = curl.POST(url, payload);
         return response.code();
     }
 }
@@ -8,6 +8,8 @@
  * granted to it by virtue of its status as an intergovernmental organisation nor
  * does it submit to any jurisdiction.
  */
+#pragma once
+
 #include <map>
 #include <string>
 #include <vector>
@@ -60,8 +62,9 @@ private:
      * describes a polygon that Aviso can support.
      *
      * @param polygon The string describing the polygon as value for the `polygon` Aviso key.
+     * @param endpointUrl The url of the notification endpoint.
      */
-    std::string urlEncode(const std::string polygon);
+    std::string urlEncode(const std::string polygon, const std::string& endpointUrl) const;
 
     /**
      * @brief Preprocess the vector of Atlas points describing a polygon, then encodes using the above method.
@@ -72,10 +75,14 @@ private:
      * might be directly passed to the `polygon` key.
      *
      * @param polygon The verticies of the polygon as an Atlas point vector.
+     * @param endpointUrl The url of the notification endpoint.
      */
-    std::string urlEncode(const std::vector<atlas::PointLonLat>& polygon);
+    std::string urlEncode(const std::vector<atlas::PointLonLat>& polygon, const std::string& endpointUrl) const;
 
 public:
+    /// Response code returned instead of posting notifications when the dev mode is active
+    static constexpr int devModeCode = 999;
+
     /// Default constructor
     AvisoNotificationHandler() = default;
 
@@ -110,6 +117,34 @@ public:
      * @param polygon The polygon where the extreme event signal has been detected as Atlas points.
      */
     int send(const std::string payload, const std::vector<atlas::PointLonLat>& polygon);
+
+    /// Returns the notification url for the given polygon, i.e. the endpoint with the schema and polygon keys.
+    std::string notificationUrl(const std::vector<atlas::PointLonLat>& polygon) const {
+        return urlEncode(polygon, urlNotify_);
+    }
+
+    /// Returns the notification url for the given polygon at another endpoint of the same Aviso server.
+    std::string notificationUrl(const std::vector<atlas::PointLonLat>& polygon, const std::string& endpoint) const {
+        return urlEncode(polygon, urlBase_ + endpoint);
+    }
+
+    /**
+     * @brief Posts a notification to an url built by `notificationUrl`.
+     *
+     * This allows the notifications to be built when the events are detected and posted later, e.g. by a
+     * background thread or after being read back from a journal.
+     *
+     * @param url The notification url.
+     * @param payload The payload of the notification.
+     *
+     * @return The HTTP response code, or `devModeCode` if the dev mode is active.
+     *
+     * @throws eckit::Exception if the request cannot be performed, e.g. if the server cannot be reached.
+     */
+    int post(const std::string& url, const std::string& payload) const;
+
+    /// Returns whether a response code returned by `send` or `post` means the notification was delivered.
+    static bool delivered(int code) { return (code >= 200 && code < 300) || code == devModeCode; }
 };
 
 }  // namespace ExtremeEventPlugin
@@ -0,0 +1,227 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <algorithm>
+#include <cmath>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+
+#include "notification_dispatcher.h"
+
+namespace ExtremeEventPlugin {
+
+RetryPolicy::RetryPolicy(const eckit::Configuration& conf) {
+    initialBackoff   = conf.getDouble("initial_backoff", initialBackoff);
+    maxBackoff       = conf.getDouble("max_backoff", maxBackoff);
+    failureThreshold = conf.getInt("failure_threshold", failureThreshold);
+    cooldown         = conf.getDouble("cooldown", cooldown);
+    shutdownGrace    = conf.getDouble("shutdown_grace", shutdownGrace);
+    if (initialBackoff <= 0 || maxBackoff < initialBackoff || failureThreshold < 1 || cooldown < 0 ||
+        shutdownGrace < 0) {
+        throw eckit::BadParameter("Invalid notification retry policy, expected 0 < initial_backoff <= max_backoff, "
+                                  "failure_threshold >= 1 and non negative cooldown and shutdown_grace",
+                                  Here());
+    }
+}
+
+NotificationDispatcher::NotificationDispatcher(const AvisoNotificationHandler& handler,
+                                               const std::string& journalPath, const RetryPolicy& policy) :
+    handler_(handler), policy_(policy), journal_(journalPath), random_(std::random_device{}()) {
+    // Notifications left undelivered by a previous run are replayed first
+    const auto now = Clock::now();
+    for (const auto& entry : journal_.pending()) {
+        retries_.emplace(now, Notification{entry.url, entry.payload, entry.id, 0});
+    }
+    stats_.replayed = journal_.pending().size();
+    if (stats_.replayed > 0) {
+        eckit::Log::info() << "Replaying " << stats_.replayed << " undelivered Aviso notifications from '"
+                           << journalPath << "'" << std::endl;
+    }
+    thread_ = std::thread(&NotificationDispatcher::deliver, this);
+}
+
+NotificationDispatcher::~NotificationDispatcher() {
+    {
+        // Give each new notification one delivery attempt, all of them are already journaled
+        std::unique_lock<std::mutex> lock(mutex_);
+        drained_.wait_for(lock, std::chrono::duration<double>(policy_.shutdownGrace),
+                          [this] { return queue_.empty() && !inFlight_; });
+        stop_ = true;
+    }
+    wakeUp_.notify_all();
+    thread_.join();
+
+    // The delivery thread is stopped, the remaining notifications are kept for the next run, including those whose
+    // journaling failed when they were posted
+    for (auto& retry : retries_) {
+        journal(retry.second);
+    }
+    for (auto& notification : queue_) {
+        journal(notification);
+    }
+    const size_t undelivered = retries_.size() + queue_.size();
+    if (undelivered > 0) {
+        eckit::Log::warning() << undelivered << " Aviso notifications could not be delivered, they are kept in the "
+                              << "notification journal to be replayed by the next run" << std::endl;
+    }
+}
+
+void NotificationDispatcher::post(const std::string& payload, const std::vector<atlas::PointLonLat>& polygon,
+                                  const std::string& endpoint) {
+    Notification notification{
+        endpoint.empty() ? handler_.notificationUrl(polygon) : handler_.notificationUrl(polygon, endpoint), payload};
+    // Journaled before it is queued, the file system sync is left to the failed deliveries
+    const bool journaled = journal(notification, false);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.journaled += journaled ? 1 : 0;
+        queue_.push_back(std::move(notification));
+    }
+    wakeUp_.notify_one();
+}
+
+bool NotificationDispatcher::drain(double timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return drained_.wait_for(lock, std::chrono::duration<double>(timeout),
+                             [this] { return queue_.empty() && retries_.empty() && !inFlight_; });
+}
+
+NotificationDispatcher::Stats NotificationDispatcher::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats       = stats_;
+    stats.outstanding = queue_.size() + retries_.size() + (inFlight_ ? 1 : 0);
+    stats.circuitOpen = Clock::now() < circuitOpenUntil_;
+    return stats;
+}
+
+void NotificationDispatcher::deliver() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        // New notifications go first, then the retries that are due, unless the circuit is open
+        Notification notification;
+        bool circuitOpen;
+        while (true) {
+            if (stop_) {
+                return;
+            }
+            const auto now = Clock::now();
+            circuitOpen    = now < circuitOpenUntil_;
+            if (!queue_.empty()) {
+                notification = std::move(queue_.front());
+                queue_.pop_front();
+                break;
+            }
+            if (!retries_.empty() && !circuitOpen && retries_.begin()->first <= now) {
+                notification = std::move(retries_.begin()->second);
+                retries_.erase(retries_.begin());
+                break;
+            }
+            if (retries_.empty()) {
+                wakeUp_.wait(lock);
+            }
+            else {
+                wakeUp_.wait_until(lock, std::max(retries_.begin()->first, circuitOpenUntil_));
+            }
+        }
+        inFlight_ = true;
+        lock.unlock();
+
+        // The server and the journal are accessed without holding the lock, `post` only waits on the journal for its
+        // own append
+        bool delivered = false;
+        if (!circuitOpen) {
+            try {
+                delivered = AvisoNotificationHandler::delivered(handler_.post(notification.url, notification.payload));
+            }
+            catch (const std::exception&) {
+                // Unreachable server, treated as any other failed delivery
+            }
+        }
+        bool journaled = false;
+        if (delivered && notification.journalId != 0) {
+            try {
+                journal_.markDelivered(notification.journalId);
+            }
+            catch (const std::exception& e) {
+                eckit::Log::warning() << "Could not update the notification journal: " << e.what() << std::endl;
+            }
+        }
+        else if (!delivered) {
+            journaled = journal(notification);
+        }
+
+        lock.lock();
+        inFlight_ = false;
+        stats_.journaled += journaled ? 1 : 0;
+        const auto now = Clock::now();
+        if (circuitOpen) {
+            // Not sent, it waits for the end of the cooldown with the other retries
+            retries_.emplace(circuitOpenUntil_, std::move(notification));
+        }
+        else if (delivered) {
+            ++stats_.delivered;
+            if (consecutiveFailures_ >= policy_.failureThreshold) {
+                // The probe went through, the backlog is replayed without waiting for the individual backoffs
+                eckit::Log::info() << "Aviso server reachable again, replaying " << retries_.size()
+                                   << " notifications" << std::endl;
+                std::multimap<Clock::time_point, Notification> replay;
+                for (auto& retry : retries_) {
+                    replay.emplace(now, std::move(retry.second));
+                }
+                retries_.swap(replay);
+            }
+            consecutiveFailures_ = 0;
+        }
+        else {
+            ++stats_.failures;
+            ++notification.attempts;
+            if (++consecutiveFailures_ >= policy_.failureThreshold) {
+                circuitOpenUntil_ = now + std::chrono::duration_cast<Clock::duration>(
+                                              std::chrono::duration<double>(policy_.cooldown));
+                if (consecutiveFailures_ == policy_.failureThreshold) {
+                    eckit::Log::warning() << "Aviso notifications failing, " << consecutiveFailures_
+                                          << " consecutive failures: pausing deliveries for " << policy_.cooldown
+                                          << " s and journaling the new notifications" << std::endl;
+                }
+            }
+            retries_.emplace(now + backoff(notification.attempts), std::move(notification));
+        }
+        drained_.notify_all();
+    }
+}
+
+NotificationDispatcher::Clock::duration NotificationDispatcher::backoff(int attempts) {
+    const double delay =
+        std::min(policy_.initialBackoff * std::pow(2.0, std::min(attempts - 1, 30)), policy_.maxBackoff);
+    // Jitter so that the partitions do not all retry at the same time after an outage
+    const double jittered = std::uniform_real_distribution<double>(0.5 * delay, delay)(random_);
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(jittered));
+}
+
+bool NotificationDispatcher::journal(Notification& notification, bool sync) {
+    bool appended = false;
+    try {
+        if (notification.journalId == 0) {
+            notification.journalId = journal_.append(notification.url, notification.payload);
+            appended               = true;
+        }
+        if (sync) {
+            journal_.sync();
+        }
+    }
+    catch (const std::exception& e) {
+        // The notification is still delivered or retried while the run lasts, it is only lost if the run stops
+        eckit::Log::error() << "Could not journal an Aviso notification: " << e.what() << std::endl;
+    }
+    return appended;
+}
+
+}  // namespace ExtremeEventPlugin
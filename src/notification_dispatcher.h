@@ -0,0 +1,163 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "atlas/util/Point.h"
+#include "eckit/config/Configuration.h"
+
+#include "notification.h"
+#include "notification_journal.h"
+
+namespace ExtremeEventPlugin {
+
+/// Retry behaviour of the notification dispatcher, all durations are in seconds.
+struct RetryPolicy {
+    double initialBackoff = 1.0;    ///< Delay before the first retry of a notification
+    double maxBackoff     = 300.0;  ///< Upper bound of the delay between two retries of a notification
+    int failureThreshold  = 5;      ///< Consecutive failed deliveries opening the circuit breaker
+    double cooldown       = 60.0;   ///< Time the circuit stays open before a single delivery is attempted again
+    double shutdownGrace  = 10.0;   ///< Time given to deliver the outstanding notifications at shutdown
+
+    RetryPolicy() = default;
+
+    /// Reads the policy from a configuration, keys are the snake case member names. Missing keys keep the defaults.
+    explicit RetryPolicy(const eckit::Configuration& conf);
+};
+
+/**
+ * @class NotificationDispatcher
+ * @brief Delivers the Aviso notifications from a background thread, retrying the failed ones.
+ *
+ * `post` appends the notification to a write-ahead journal and queues it, so the model step never waits on the
+ * Aviso server and a crash of the run does not lose it. The background thread sends the notifications in order,
+ * marks them as delivered in the journal and, when a delivery fails (error response or unreachable server), retries
+ * it with an exponential backoff (with jitter). After `failureThreshold` consecutive failures the circuit breaker
+ * opens: new notifications wait in the journal without being sent until the cooldown expires, then one notification
+ * is sent as a probe. A successful probe closes the circuit and the journaled notifications are replayed straight
+ * away, a failed one opens it for another cooldown.
+ *
+ * The notifications still undelivered when the dispatcher is destroyed stay in the journal and are replayed by the
+ * next dispatcher opening the same journal, e.g. when the run is restarted.
+ */
+class NotificationDispatcher {
+public:
+    /// Delivery counters, for logging and tests.
+    struct Stats {
+        size_t delivered   = 0;  ///< Notifications delivered, including the replayed ones
+        size_t failures    = 0;  ///< Failed delivery attempts
+        size_t journaled   = 0;  ///< Notifications appended to the journal
+        size_t replayed    = 0;  ///< Notifications loaded from the journal of a previous run
+        size_t outstanding = 0;  ///< Notifications queued or waiting for a retry
+        bool circuitOpen   = false;
+    };
+
+    /**
+     * @brief Opens the journal, queues its undelivered notifications and starts the delivery thread.
+     *
+     * @param handler The handler posting the notifications to the Aviso server.
+     * @param journalPath The path of the journal of the undelivered notifications.
+     * @param policy The retry behaviour.
+     *
+     * @throws eckit::CantOpenFile if the journal cannot be opened.
+     */
+    NotificationDispatcher(const AvisoNotificationHandler& handler, const std::string& journalPath,
+                           const RetryPolicy& policy = RetryPolicy());
+
+    /**
+     * @brief Gives the queued notifications `shutdownGrace` seconds to be delivered, then stops the delivery thread.
+     *
+     * This blocks the teardown of the plugin for up to `shutdownGrace` seconds while the Aviso server is slow or
+     * unreachable. The notifications are already in the journal, so a zero grace does not lose them, it only leaves
+     * them to the next run.
+     */
+    ~NotificationDispatcher();
+
+    NotificationDispatcher(const NotificationDispatcher&)            = delete;
+    NotificationDispatcher& operator=(const NotificationDispatcher&) = delete;
+
+    /**
+     * @brief Journals and queues a notification for the given polygon, without waiting for its delivery.
+     *
+     * @param endpoint The notification endpoint on the Aviso server, the endpoint of the handler if empty.
+     */
+    void post(const std::string& payload, const std::vector<atlas::PointLonLat>& polygon,
+              const std::string& endpoint = "");
+
+    /**
+     * @brief Waits until all the notifications queued so far are delivered, or for the given time at most.
+     *
+     * @param timeout The maximum time to wait, in seconds.
+     *
+     * @return Whether all the notifications were delivered.
+     */
+    bool drain(double timeout);
+
+    /// Returns the delivery counters.
+    Stats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Notification {
+        std::string url;
+        std::string payload;
+        uint64_t journalId = 0;  ///< Id in the journal, 0 if not journaled yet
+        int attempts       = 0;
+    };
+
+    AvisoNotificationHandler handler_;
+    RetryPolicy policy_;
+    /// Appended to by `post` and the delivery thread, only updated and synced by the delivery thread
+    NotificationJournal journal_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeUp_;   ///< Signals new notifications and stop requests to the delivery thread
+    std::condition_variable drained_;  ///< Signals that no notification is outstanding anymore
+
+    std::deque<Notification> queue_;  ///< New notifications, in order
+    /// Failed notifications, by time of their next attempt
+    std::multimap<Clock::time_point, Notification> retries_;
+    bool inFlight_           = false;  ///< Whether a notification is being sent
+    bool stop_               = false;
+    int consecutiveFailures_ = 0;
+    Clock::time_point circuitOpenUntil_;
+    Stats stats_;
+
+    std::mt19937 random_;
+    std::thread thread_;
+
+    /// Delivery thread loop.
+    void deliver();
+
+    /// Returns the delay before the next retry of a notification which failed `attempts` times.
+    Clock::duration backoff(int attempts);
+
+    /**
+     * @brief Appends the notification to the journal if it is not there yet, returns whether it was appended.
+     *
+     * @param sync Whether to wait for the file system to store the journal, e.g. for a failed notification.
+     */
+    bool journal(Notification& notification, bool sync = true);
+};
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,213 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+#include "eckit/exception/Exceptions.h"
+
+#include "binary_records.h"
+#include "notification_journal.h"
+
+namespace ExtremeEventPlugin {
+
+namespace {
+
+const char magic[4]          = {'E', 'E', 'N', 'J'};
+const uint32_t formatVersion = 1;
+
+/// Delivered notifications kept in the file before it is compacted, if they outnumber the outstanding ones
+const size_t compactionThreshold = 1024;
+
+std::string notificationRecord(const JournalEntry& entry) {
+    RecordEncoder record;
+    record.put(entry.id);
+    record.put(entry.url);
+    record.put(entry.payload);
+    return record.record('N');
+}
+
+void writeAll(std::FILE* file, const std::string& data, const std::string& path) {
+    if (std::fwrite(data.data(), 1, data.size(), file) != data.size()) {
+        throw eckit::WriteError(path, Here());
+    }
+}
+
+}  // namespace
+
+NotificationJournal::NotificationJournal(const std::string& path) : path_(path) {
+    pending_ = read(path_);
+    if (!pending_.empty()) {
+        nextId_ = pending_.back().id + 1;
+    }
+    for (const auto& entry : pending_) {
+        outstanding_[entry.id] = entry;
+    }
+    rewrite();
+}
+
+NotificationJournal::~NotificationJournal() {
+    if (file_) {
+        std::fflush(file_);
+        ::fsync(::fileno(file_));
+        std::fclose(file_);
+    }
+}
+
+uint64_t NotificationJournal::append(const std::string& url, const std::string& payload) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::FILE* journal = file();
+    JournalEntry entry{nextId_, url, payload};
+    writeAll(journal, notificationRecord(entry), path_);
+    if (std::fflush(journal) != 0) {
+        throw eckit::WriteError(path_, Here());
+    }
+    const uint64_t id = nextId_++;
+    outstanding_[id]  = std::move(entry);
+    return id;
+}
+
+void NotificationJournal::markDelivered(uint64_t id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::FILE* journal  = file();
+        const size_t erased = outstanding_.erase(id);
+        ASSERT(erased == 1);
+        ++delivered_;
+        // Recorded even if the journal is compacted next, so that a failed compaction loses nothing
+        RecordEncoder record;
+        record.put(id);
+        writeAll(journal, record.record('D'), path_);
+        if (delivered_ < compactionThreshold || delivered_ <= outstanding_.size()) {
+            return;
+        }
+    }
+    // Start again from the outstanding notifications rather than letting the journal grow
+    rewrite();
+}
+
+void NotificationJournal::sync() {
+    int descriptor;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::FILE* journal = file();
+        if (std::fflush(journal) != 0) {
+            throw eckit::WriteError(path_, Here());
+        }
+        descriptor = ::fileno(journal);
+    }
+    // Only `rewrite` replaces the file, and it is not called concurrently with `sync`
+    if (::fsync(descriptor) != 0) {
+        throw eckit::WriteError(path_, Here());
+    }
+}
+
+size_t NotificationJournal::outstanding() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return outstanding_.size();
+}
+
+std::FILE* NotificationJournal::file() const {
+    if (!file_) {
+        throw eckit::WriteError(path_ + " is not open", Here());
+    }
+    return file_;
+}
+
+std::vector<JournalEntry> NotificationJournal::read(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return {};
+    }
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (content.empty()) {
+        return {};
+    }
+    if (!hasFileHeader(content, magic, formatVersion)) {
+        throw eckit::BadValue("'" + path + "' is not a notification journal or has an unsupported version", Here());
+    }
+
+    std::map<uint64_t, JournalEntry> entries;
+    forEachRecord(content, [&entries](char type, RecordDecoder& payload) {
+        if (type == 'N') {
+            JournalEntry entry;
+            entry.id          = payload.get<uint64_t>();
+            entry.url         = payload.getString();
+            entry.payload     = payload.getString();
+            entries[entry.id] = std::move(entry);
+        }
+        else if (type == 'D') {
+            entries.erase(payload.get<uint64_t>());
+        }
+    });
+
+    std::vector<JournalEntry> pending;
+    pending.reserve(entries.size());
+    for (auto& entry : entries) {
+        pending.push_back(std::move(entry.second));
+    }
+    return pending;
+}
+
+void NotificationJournal::rewrite() {
+    std::map<uint64_t, JournalEntry> snapshot;
+    uint64_t snapshotEnd;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        snapshot    = outstanding_;
+        snapshotEnd = nextId_;
+    }
+    // Write a complete new journal next to the current one, so that a crash leaves either of them in place
+    const std::string tmpPath = path_ + ".tmp";
+    std::FILE* tmp            = std::fopen(tmpPath.c_str(), "wb");
+    if (!tmp) {
+        throw eckit::CantOpenFile(tmpPath, Here());
+    }
+    auto discard = [&tmp, &tmpPath]() {
+        std::fclose(tmp);
+        std::remove(tmpPath.c_str());
+    };
+    try {
+        writeAll(tmp, fileHeader(magic, formatVersion), tmpPath);
+        for (const auto& entry : snapshot) {
+            writeAll(tmp, notificationRecord(entry.second), tmpPath);
+        }
+        if (std::fflush(tmp) != 0 || ::fsync(::fileno(tmp)) != 0) {
+            throw eckit::WriteError(tmpPath, Here());
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        // The notifications appended while the new journal was written, handed to the operating system like `append`
+        for (auto entry = outstanding_.lower_bound(snapshotEnd); entry != outstanding_.end(); ++entry) {
+            writeAll(tmp, notificationRecord(entry->second), tmpPath);
+        }
+        if (std::fflush(tmp) != 0) {
+            throw eckit::WriteError(tmpPath, Here());
+        }
+        if (std::rename(tmpPath.c_str(), path_.c_str()) != 0) {
+            throw eckit::WriteError(path_, Here());
+        }
+        // The new file is appended to through the handle it was written with
+        if (file_) {
+            std::fclose(file_);
+        }
+        file_      = tmp;
+        delivered_ = 0;
+    }
+    catch (...) {
+        discard();
+        throw;
+    }
+}
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,125 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ExtremeEventPlugin {
+
+/// A notification stored in the journal, ready to be posted.
+struct JournalEntry {
+    uint64_t id;
+    std::string url;
+    std::string payload;
+};
+
+/**
+ * @class NotificationJournal
+ * @brief Write-ahead journal of the notifications to deliver to the Aviso server.
+ *
+ * Notifications are appended to the journal before they are sent, and marked as delivered once the server accepted
+ * them. The notifications still in the journal when a run stops, or crashes, are returned by `pending` on the next
+ * run, so that they can be replayed. A notification delivered just before a crash may be replayed once more. The
+ * file follows the layout described in `binary_records.h`, with the magic `EENJ` and the records:
+ *      - `N` (notification): id (uint64), url, payload (strings).
+ *      - `D` (delivered): id (uint64) of a notification previously appended.
+ *
+ * The journal is compacted when it is opened and when the delivered notifications make up most of a large file. The
+ * compaction only holds the lock of the journal to replace the file, so `append` can be called from one thread while
+ * another calls the other methods, e.g. from the model and from the delivery thread. The methods other than `append`
+ * must not be called concurrently.
+ */
+class NotificationJournal {
+public:
+    /**
+     * @brief Opens the journal, loading and compacting the notifications left undelivered by a previous run.
+     *
+     * @param path The path of the journal file, created if it does not exist.
+     *
+     * @throws eckit::CantOpenFile if the file cannot be opened.
+     * @throws eckit::BadValue if the file exists but is not a notification journal.
+     */
+    explicit NotificationJournal(const std::string& path);
+
+    /// Writes the buffered records and closes the file.
+    ~NotificationJournal();
+
+    NotificationJournal(const NotificationJournal&)            = delete;
+    NotificationJournal& operator=(const NotificationJournal&) = delete;
+
+    /// Returns the notifications left undelivered by previous runs when the journal was opened, oldest first.
+    const std::vector<JournalEntry>& pending() const { return pending_; }
+
+    /**
+     * @brief Appends a notification to the journal and returns its id.
+     *
+     * The record is handed to the operating system straight away, so it survives a crash of the process. It survives
+     * a crash of the system after the next `sync`.
+     *
+     * @throws eckit::WriteError if the record cannot be written.
+     */
+    uint64_t append(const std::string& url, const std::string& payload);
+
+    /**
+     * @brief Records that a notification of the journal was delivered, compacting the journal when worthwhile.
+     *
+     * @throws eckit::WriteError if the record cannot be written or the journal cannot be compacted.
+     */
+    void markDelivered(uint64_t id);
+
+    /**
+     * @brief Writes the records appended so far to the file and waits for the file system to store them.
+     *
+     * @throws eckit::WriteError if the records cannot be written.
+     */
+    void sync();
+
+    /// Returns the number of notifications of the journal not delivered yet.
+    size_t outstanding() const;
+
+    /**
+     * @brief Reads the undelivered notifications of a journal file without modifying it.
+     *
+     * @param path The path of the journal file.
+     *
+     * @return The undelivered notifications, oldest first. Empty if the file does not exist.
+     *
+     * @throws eckit::BadValue if the file is not a notification journal.
+     */
+    static std::vector<JournalEntry> read(const std::string& path);
+
+private:
+    std::string path_;
+    std::vector<JournalEntry> pending_;
+    mutable std::mutex mutex_;  ///< Protects the members below
+    std::FILE* file_ = nullptr;
+    std::map<uint64_t, JournalEntry> outstanding_;  ///< Notifications of the file not delivered yet, by id
+    uint64_t nextId_  = 1;
+    size_t delivered_ = 0;  ///< Delivered notifications still in the file
+
+    /// Returns the file, throws if a previous compaction left the journal without one.
+    std::FILE* file() const;
+
+    /**
+     * @brief Rewrites the file with only the outstanding notifications, replacing it atomically.
+     *
+     * The new file is written and synced without holding the lock, the notifications appended meanwhile are added
+     * to it before it replaces the current one. The current file is kept if anything fails.
+     */
+    void rewrite();
+};
+
+}  // namespace ExtremeEventPlugin
@@ -10,9 +10,38 @@
  */
 #pragma once
 
+#include "atlas/array/DataType.h"
+#include "atlas/field/Field.h"
+#include "eckit/exception/Exceptions.h"
 
-#ifdef WITH_EE_PLUGIN_SINGLE_PRECISION
-#define FIELD_TYPE_REAL float
-#else
-#define FIELD_TYPE_REAL double
-#endif
\ No newline at end of file
+/**
+ * @brief Calls a generic functor with a value of the C++ floating point type matching the datatype of an Atlas field.
+ *
+ * The model can be run in single or double precision, and the plugin does not know which one until it receives the
+ * fields. Detection kernels are therefore templated on their value type, and this function selects the instantiation
+ * at runtime, e.g.:
+ *
+ * @code
+ * dispatchFieldType(field, [&](auto tag) { kernel<decltype(tag)>(field); });
+ * @endcode
+ *
+ * @param field The Atlas field whose datatype selects the instantiation.
+ * @param func The generic functor to call, it receives a value-initialised `float` or `double`.
+ *
+ * @return Whatever `func` returns.
+ *
+ * @throws eckit::BadValue if the field is neither a single nor a double precision real field.
+ */
+template <typename Functor>
+decltype(auto) dispatchFieldType(const atlas::Field& field, Functor&& func) {
+    switch (field.datatype().kind()) {
+        case atlas::array::DataType::KIND_REAL32:
+            return func(float{});
+        case atlas::array::DataType::KIND_REAL64:
+            return func(double{});
+        default:
+            throw eckit::BadValue("Field '" + field.name() + "' has datatype '" + field.datatype().str() +
+                                      "', only real32 and real64 fields are supported.",
+                                  Here());
+    }
+}
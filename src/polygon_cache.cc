@@ -0,0 +1,67 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include "polygon_cache.h"
+
+namespace ExtremeEventPlugin {
+
+const PolygonCache::Polygons& PolygonCache::polygons(const std::vector<int>& cells,
+                                                     const std::function<Polygons()>& extract, int level) {
+    if (capacity_ == 0) {
+        ++misses_;
+        uncached_ = extract();
+        return uncached_;
+    }
+    const uint64_t key = hash(cells) + static_cast<uint64_t>(level) * 0x9e3779b97f4a7c15ULL;
+    auto range         = index_.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        // Different sets can share a hash, the cells are compared before reusing the polygons
+        if (it->second->level == level && it->second->cells == cells) {
+            ++hits_;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return entries_.front().polygons;
+        }
+    }
+    ++misses_;
+    entries_.push_front({key, level, cells, extract()});
+    index_.emplace(key, entries_.begin());
+    if (entries_.size() > capacity_) {
+        auto last    = std::prev(entries_.end());
+        auto indexed = index_.equal_range(last->hash);
+        for (auto it = indexed.first; it != indexed.second; ++it) {
+            if (it->second == last) {
+                index_.erase(it);
+                break;
+            }
+        }
+        entries_.pop_back();
+    }
+    return entries_.front().polygons;
+}
+
+void PolygonCache::clear() {
+    entries_.clear();
+    index_.clear();
+}
+
+uint64_t PolygonCache::hash(const std::vector<int>& cells) {
+    // FNV-1a over the cell indices, followed by a final mix of the bits
+    uint64_t h = 14695981039346656037ULL;
+    for (int cell : cells) {
+        h ^= static_cast<uint32_t>(cell);
+        h *= 1099511628211ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+}  // namespace ExtremeEventPlugin
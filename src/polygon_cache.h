@@ -0,0 +1,80 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "atlas/util/Point.h"
+
+namespace ExtremeEventPlugin {
+
+/**
+ * @class PolygonCache
+ * @brief Keeps the polygons of the most recently seen sets of firing cells.
+ *
+ * Instances with close thresholds often fire on the same coarse cells, and a stationary event fires on the same cells
+ * over consecutive steps, so the same polygons would be extracted again and again. The cache is keyed by a hash of the
+ * sorted cell indices, and a hit is only returned if the cells are identical. The least recently used sets are
+ * dropped beyond the capacity.
+ *
+ * @note The polygons only depend on the cells as long as the cell vertices do not change, the cache must be cleared
+ *       when they do.
+ */
+class PolygonCache {
+public:
+    using Polygons = std::vector<std::vector<atlas::PointLonLat>>;
+
+    /// @param capacity The maximum number of cell sets kept, 0 disables the cache.
+    explicit PolygonCache(size_t capacity) : capacity_(capacity) {}
+
+    /**
+     * @brief Returns the polygons of a set of cells, extracted by `extract` if they are not cached.
+     *
+     * @param cells The sorted indices of the cells.
+     * @param extract Extracts the polygons of the cells.
+     * @param level The HEALPix level of the cells, the same indices are different cells at different levels.
+     *
+     * @return The polygons, valid until the next call.
+     */
+    const Polygons& polygons(const std::vector<int>& cells, const std::function<Polygons()>& extract, int level = 0);
+
+    /// Drops all the cached polygons.
+    void clear();
+
+    size_t size() const { return entries_.size(); }
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+
+    /// Returns the hash of a set of cells.
+    static uint64_t hash(const std::vector<int>& cells);
+
+private:
+    struct Entry {
+        uint64_t hash;
+        int level;
+        std::vector<int> cells;
+        Polygons polygons;
+    };
+
+    size_t capacity_;
+    std::list<Entry> entries_;  ///< Most recently used first
+    std::unordered_multimap<uint64_t, std::list<Entry>::iterator> index_;
+    Polygons uncached_;  ///< Polygons of the last call when the cache is disabled
+    size_t hits_   = 0;
+    size_t misses_ = 0;
+};
+
+}  // namespace ExtremeEventPlugin
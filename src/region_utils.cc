@@ -0,0 +1,226 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "atlas/array.h"
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/exception/Exceptions.h"
+
+#include "region_utils.h"
+
+namespace RegionUtils {
+
+namespace {
+
+/// Returns true if the point lies within the polygon by the crossing number test, in the (lon, lat) plane.
+bool inPlanePolygon(const std::vector<atlas::PointLonLat>& polygon, const atlas::PointLonLat& point) {
+    bool inside = false;
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        const auto& a = polygon[i];
+        const auto& b = polygon[j];
+        if ((a.lat() > point.lat()) != (b.lat() > point.lat())) {
+            const double crossLon = a.lon() + (point.lat() - a.lat()) * (b.lon() - a.lon()) / (b.lat() - a.lat());
+            if (point.lon() < crossLon) {
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+/// Returns the side of the line (a, b) the point c lies on, positive on the left and 0 on the line.
+double side(const atlas::PointLonLat& a, const atlas::PointLonLat& b, const atlas::PointLonLat& c) {
+    return (b.lon() - a.lon()) * (c.lat() - a.lat()) - (b.lat() - a.lat()) * (c.lon() - a.lon());
+}
+
+/// Returns true if the segments (a, b) and (c, d) cross or touch, in the (lon, lat) plane.
+bool segmentsMeet(const atlas::PointLonLat& a, const atlas::PointLonLat& b, const atlas::PointLonLat& c,
+                  const atlas::PointLonLat& d) {
+    const double c1 = side(a, b, c);
+    const double c2 = side(a, b, d);
+    const double c3 = side(c, d, a);
+    const double c4 = side(c, d, b);
+    if (((c1 > 0) != (c2 > 0) || c1 == 0 || c2 == 0) && ((c3 > 0) != (c4 > 0) || c3 == 0 || c4 == 0)) {
+        // Collinear segments only meet if their extents overlap
+        if (c1 == 0 && c2 == 0) {
+            return std::max(std::min(a.lon(), b.lon()), std::min(c.lon(), d.lon())) <=
+                       std::min(std::max(a.lon(), b.lon()), std::max(c.lon(), d.lon())) &&
+                   std::max(std::min(a.lat(), b.lat()), std::min(c.lat(), d.lat())) <=
+                       std::min(std::max(a.lat(), b.lat()), std::max(c.lat(), d.lat()));
+        }
+        return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+Region::Region(const eckit::Configuration& config) {
+    if (config.has("area") == config.has("polygon")) {
+        throw eckit::BadParameter("A region requires exactly one of the 'area' or 'polygon' keys", Here());
+    }
+    if (config.has("area")) {
+        auto area = config.getDoubleVector("area");
+        if (area.size() != 4 || area[0] < area[2]) {
+            throw eckit::BadParameter("A region 'area' must be [north, west, south, east] with north >= south", Here());
+        }
+        north_ = area[0];
+        south_ = area[2];
+        west_  = area[1];
+        // Boxes crossing the antimeridian have west > east, the span is taken eastward from west
+        double span = area[3] - area[1];
+        while (span < 0) {
+            span += 360.0;
+        }
+        east_ = west_ + std::min(span, 360.0);
+        return;
+    }
+
+    auto coords = config.getDoubleVector("polygon");
+    if (coords.size() % 2 != 0 || coords.size() < 6) {
+        throw eckit::BadParameter("A region 'polygon' must be a list of at least 3 (lat, lon) pairs", Here());
+    }
+    for (size_t i = 0; i < coords.size(); i += 2) {
+        double lon = coords[i + 1];
+        if (!polygon_.empty()) {
+            // Keep consecutive vertices within 180 degrees so that polygons crossing the antimeridian stay connected
+            const double previous = polygon_.back().lon();
+            while (lon - previous > 180.0) {
+                lon -= 360.0;
+            }
+            while (lon - previous < -180.0) {
+                lon += 360.0;
+            }
+        }
+        polygon_.emplace_back(lon, coords[i]);
+    }
+    auto lonCmp = [](const atlas::PointLonLat& a, const atlas::PointLonLat& b) { return a.lon() < b.lon(); };
+    auto latCmp = [](const atlas::PointLonLat& a, const atlas::PointLonLat& b) { return a.lat() < b.lat(); };
+    west_       = std::min_element(polygon_.begin(), polygon_.end(), lonCmp)->lon();
+    east_       = std::max_element(polygon_.begin(), polygon_.end(), lonCmp)->lon();
+    south_      = std::min_element(polygon_.begin(), polygon_.end(), latCmp)->lat();
+    north_      = std::max_element(polygon_.begin(), polygon_.end(), latCmp)->lat();
+}
+
+double Region::unwrap(double lon) const {
+    double offset = std::fmod(lon - west_, 360.0);
+    if (offset < 0) {
+        offset += 360.0;
+    }
+    return west_ + offset;
+}
+
+bool Region::contains(const atlas::PointLonLat& point) const {
+    if (point.lat() < south_ || point.lat() > north_) {
+        return false;
+    }
+    const double lon = unwrap(point.lon());
+    if (lon > east_) {
+        return false;
+    }
+    if (polygon_.empty()) {
+        return true;
+    }
+    // Crossing number test in the unwrapped (lon, lat) plane
+    return inPlanePolygon(polygon_, atlas::PointLonLat{lon, point.lat()});
+}
+
+bool Region::intersects(const std::vector<atlas::PointLonLat>& polygon) const {
+    if (polygon.empty()) {
+        return false;
+    }
+    // The outline of the region and the polygon are compared in the unwrapped longitudes of the region
+    std::vector<atlas::PointLonLat> outline = polygon_;
+    if (outline.empty()) {
+        outline = {{west_, south_}, {east_, south_}, {east_, north_}, {west_, north_}};
+    }
+    std::vector<atlas::PointLonLat> unwrapped = {{unwrap(polygon[0].lon()), polygon[0].lat()}};
+    for (size_t i = 1; i < polygon.size(); ++i) {
+        double lon = polygon[i].lon();
+        while (lon - unwrapped.back().lon() > 180.0) {
+            lon -= 360.0;
+        }
+        while (lon - unwrapped.back().lon() < -180.0) {
+            lon += 360.0;
+        }
+        unwrapped.emplace_back(lon, polygon[i].lat());
+    }
+
+    // The polygon can stick out of either end of the unwrapped longitudes, it is also tried one turn away
+    for (double shift : {-360.0, 0.0, 360.0}) {
+        std::vector<atlas::PointLonLat> shifted;
+        double west  = std::numeric_limits<double>::max();
+        double east  = std::numeric_limits<double>::lowest();
+        double south = west;
+        double north = east;
+        for (const auto& vertex : unwrapped) {
+            shifted.emplace_back(vertex.lon() + shift, vertex.lat());
+            west  = std::min(west, shifted.back().lon());
+            east  = std::max(east, shifted.back().lon());
+            south = std::min(south, vertex.lat());
+            north = std::max(north, vertex.lat());
+        }
+        if (east < west_ || west > east_ || north < south_ || south > north_) {
+            continue;
+        }
+        for (const auto& vertex : shifted) {
+            if (inPlanePolygon(outline, vertex)) {
+                return true;
+            }
+        }
+        for (const auto& vertex : outline) {
+            if (inPlanePolygon(shifted, vertex)) {
+                return true;
+            }
+        }
+        for (size_t i = 0, j = shifted.size() - 1; i < shifted.size(); j = i++) {
+            for (size_t k = 0, l = outline.size() - 1; k < outline.size(); l = k++) {
+                if (segmentsMeet(shifted[j], shifted[i], outline[l], outline[k])) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+std::vector<Region> regionsFromConfig(const eckit::Configuration& config, const std::string& key) {
+    std::vector<Region> regions;
+    if (config.has(key)) {
+        for (const auto& regionConfig : config.getSubConfigurations(key)) {
+            regions.emplace_back(regionConfig);
+        }
+    }
+    return regions;
+}
+
+std::vector<atlas::idx_t> ownedPointsInRegions(const atlas::FunctionSpace& fs, const std::vector<Region>& regions) {
+    auto lonlat = atlas::array::make_view<double, 2>(fs.lonlat());
+    auto ghost  = atlas::array::make_view<int, 1>(fs.ghost());
+
+    std::vector<atlas::idx_t> points;
+    for (atlas::idx_t idx = 0; idx < fs.size(); ++idx) {
+        // Skip the halo, its detection is run in another partition
+        if (ghost(idx)) {
+            continue;
+        }
+        atlas::PointLonLat p{lonlat(idx, 0), lonlat(idx, 1)};
+        if (regions.empty() ||
+            std::any_of(regions.begin(), regions.end(), [&p](const Region& r) { return r.contains(p); })) {
+            points.push_back(idx);
+        }
+    }
+    return points;
+}
+
+}  // namespace RegionUtils
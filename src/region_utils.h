@@ -0,0 +1,83 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <vector>
+
+#include "atlas/functionspace.h"
+#include "atlas/util/Point.h"
+#include "eckit/config/Configuration.h"
+
+namespace RegionUtils {
+
+/**
+ * @class Region
+ * @brief A geographical area of interest, either a lat/lon box or a polygon.
+ *
+ * Regions are configured with one of the following keys:
+ *      - `area: [north, west, south, east]`, the MARS convention for boxes. The box crosses the antimeridian if
+ *        `west > east`.
+ *      - `polygon: [lat1, lon1, lat2, lon2, ...]`, the same convention as the Aviso polygons. The polygon is closed
+ *        implicitly and must not span more than 180 degrees of longitude between two consecutive vertices.
+ */
+class Region {
+public:
+    /**
+     * @brief Constructs a region from its configuration.
+     *
+     * @throws eckit::BadParameter if neither or both of `area` and `polygon` are provided, or if they are malformed.
+     */
+    explicit Region(const eckit::Configuration& config);
+
+    /// Returns true if the point lies within the region (boundaries included for boxes).
+    bool contains(const atlas::PointLonLat& point) const;
+
+    /**
+     * @brief Returns true if the region and a polygon overlap, e.g. a HEALPix cell, even if neither holds a vertex
+     *        of the other.
+     *
+     * @param polygon The vertices of the polygon, closed implicitly, two consecutive vertices within 180 degrees of
+     *                longitude of each other.
+     */
+    bool intersects(const std::vector<atlas::PointLonLat>& polygon) const;
+
+private:
+    double north_, south_, west_, east_;       ///< Bounding box, `east_` is in `[west_, west_ + 360]`
+    std::vector<atlas::PointLonLat> polygon_;  ///< Unwrapped polygon vertices, empty for boxes
+
+    /// Returns the longitude shifted into `[west_, west_ + 360)`.
+    double unwrap(double lon) const;
+};
+
+/**
+ * @brief Creates the regions listed under a configuration key.
+ *
+ * @param config The configuration holding the list.
+ * @param key The key of the list of regions.
+ *
+ * @return The regions, empty if the key is not present.
+ */
+std::vector<Region> regionsFromConfig(const eckit::Configuration& config, const std::string& key = "regions");
+
+/**
+ * @brief Lists the points of a function space that are owned by the partition and belong to any of the regions.
+ *
+ * Halo points are always excluded as their detection is run in another partition. If no region is given, all owned
+ * points are listed.
+ *
+ * @param fs The function space of the fields to run detection on.
+ * @param regions The regions of interest.
+ *
+ * @return The sorted local indices of the selected points.
+ */
+std::vector<atlas::idx_t> ownedPointsInRegions(const atlas::FunctionSpace& fs, const std::vector<Region>& regions);
+
+}  // namespace RegionUtils
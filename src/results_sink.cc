@@ -0,0 +1,190 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+
+#include "binary_records.h"
+#include "results_sink.h"
+
+namespace ExtremeEventPlugin {
+
+namespace {
+
+const char magic[4]          = {'E', 'E', 'R', 'S'};
+const uint32_t formatVersion = 1;
+
+/**
+ * @brief Truncates a results file after its last complete record.
+ *
+ * A run interrupted while writing leaves a truncated last record, whose size would make the reader take the records
+ * appended by the next run as its payload. Only the record prefixes are read, the payloads are skipped.
+ *
+ * @return The path, so that the file can be repaired before it is opened by the writer.
+ */
+const std::string& dropTruncatedRecord(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return path;
+    }
+    const auto fileSize      = static_cast<uint64_t>(in.tellg());
+    const std::string header = fileHeader(magic, formatVersion);
+    std::string start(std::min<uint64_t>(fileSize, header.size()), '\0');
+    in.seekg(0);
+    in.read(&start[0], start.size());
+    if (header.compare(0, start.size(), start) != 0) {
+        // Not a results file, left untouched for the reader to reject
+        return path;
+    }
+
+    uint64_t complete = 0;
+    if (start.size() == header.size()) {
+        const size_t prefixSize = sizeof(char) + sizeof(uint32_t);
+        char prefix[prefixSize];
+        complete = header.size();
+        while (complete + prefixSize <= fileSize && in.read(prefix, prefixSize)) {
+            RecordDecoder decoder(prefix, prefixSize);
+            decoder.get<char>();
+            const auto size = decoder.get<uint32_t>();
+            if (complete + prefixSize + size > fileSize) {
+                break;
+            }
+            complete += prefixSize + size;
+            in.seekg(complete);
+        }
+    }
+    in.close();
+
+    if (complete < fileSize) {
+        eckit::Log::warning() << "Results file '" << path << "' ends with a truncated record, dropping its last "
+                              << fileSize - complete << " bytes" << std::endl;
+        SYSCALL(::truncate(path.c_str(), static_cast<off_t>(complete)));
+    }
+    return path;
+}
+
+}  // namespace
+
+ResultsSink::ResultsSink(const std::string& path) : writer_(dropTruncatedRecord(path)) {
+    if (writer_.startedEmpty()) {
+        writer_.write(fileHeader(magic, formatVersion));
+    }
+}
+
+void ResultsSink::write(const ResultsRecord& record) {
+    if (knownInstances_.insert({record.event, record.instance}).second) {
+        RecordEncoder instance;
+        instance.put(record.event);
+        instance.put(record.instance);
+        instance.put(record.description);
+        instance.put(record.param);
+        instance.put(record.levtype);
+        instance.put(record.levelist);
+        writer_.write(instance.record('I'));
+    }
+
+    // Firing cells are sorted and often contiguous, so they are stored as ranges
+    std::vector<std::pair<int32_t, int32_t>> ranges;
+    for (const int cell : record.cells) {
+        if (!ranges.empty() && ranges.back().second + 1 == cell) {
+            ranges.back().second = cell;
+        }
+        else {
+            ranges.push_back({cell, cell});
+        }
+    }
+
+    RecordEncoder result;
+    result.put(record.step);
+    result.put(record.event);
+    result.put(record.instance);
+    result.put(static_cast<uint32_t>(ranges.size()));
+    for (const auto& range : ranges) {
+        result.put(range.first);
+        result.put(range.second);
+    }
+    result.put(static_cast<uint32_t>(record.polygons.size()));
+    for (const auto& polygon : record.polygons) {
+        result.put(static_cast<uint32_t>(polygon.size()));
+        for (const auto& vertex : polygon) {
+            result.put(vertex.lon());
+            result.put(vertex.lat());
+        }
+    }
+    writer_.write(result.record('R'));
+}
+
+std::vector<ResultsRecord> ResultsSink::read(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw eckit::CantOpenFile(path, Here());
+    }
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!hasFileHeader(content, magic, formatVersion)) {
+        throw eckit::BadValue("'" + path + "' is not an extreme event results file or has an unsupported version",
+                              Here());
+    }
+
+    std::map<std::pair<uint32_t, uint32_t>, ResultsRecord> instances;
+    std::vector<ResultsRecord> records;
+    forEachRecord(content, [&](char type, RecordDecoder& payload) {
+        if (type == 'I') {
+            ResultsRecord instance;
+            instance.event       = payload.get<uint32_t>();
+            instance.instance    = payload.get<uint32_t>();
+            instance.description = payload.getString();
+            instance.param       = payload.getString();
+            instance.levtype     = payload.getString();
+            instance.levelist    = payload.getString();
+
+            instances[{instance.event, instance.instance}] = instance;
+        }
+        else if (type == 'R') {
+            const std::string step = payload.getString();
+            const auto event       = payload.get<uint32_t>();
+            const auto instanceIdx = payload.get<uint32_t>();
+            auto it                = instances.find({event, instanceIdx});
+            if (it == instances.end()) {
+                throw eckit::BadValue("Result found before the description of its instance", Here());
+            }
+            ResultsRecord record = it->second;
+            record.step          = step;
+            const auto nbRanges  = payload.get<uint32_t>();
+            for (uint32_t r = 0; r < nbRanges; ++r) {
+                const auto first = payload.get<int32_t>();
+                const auto last  = payload.get<int32_t>();
+                for (int32_t cell = first; cell <= last; ++cell) {
+                    record.cells.push_back(cell);
+                }
+            }
+            const auto nbPolygons = payload.get<uint32_t>();
+            record.polygons.resize(nbPolygons);
+            for (auto& polygon : record.polygons) {
+                const auto nbVertices = payload.get<uint32_t>();
+                for (uint32_t v = 0; v < nbVertices; ++v) {
+                    const auto lon = payload.get<double>();
+                    const auto lat = payload.get<double>();
+                    polygon.emplace_back(lon, lat);
+                }
+            }
+            records.push_back(std::move(record));
+        }
+        // Unknown record types are skipped for forward compatibility
+    });
+    return records;
+}
+
+}  // namespace ExtremeEventPlugin
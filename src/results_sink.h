@@ -0,0 +1,90 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "atlas/util/Point.h"
+
+#include "async_writer.h"
+
+namespace ExtremeEventPlugin {
+
+/**
+ * @brief The detection result of a single event instance at a single step, as stored by the results sink.
+ */
+struct ResultsRecord {
+    std::string step;
+    uint32_t event;     ///< Index of the event in the plugin
+    uint32_t instance;  ///< Index of the instance (detection data) within the event
+    std::string description, param, levtype, levelist;
+    std::vector<int> cells;                                 ///< Sorted firing HEALPix cells
+    std::vector<std::vector<atlas::PointLonLat>> polygons;  ///< Polygons extracted from the firing cells
+};
+
+/**
+ * @class ResultsSink
+ * @brief Append-only binary file storing the detection results, as an alternative to Aviso notifications.
+ *
+ * The file starts with the magic `EERS` and a format version. It is then a sequence of records, each made of a
+ * one byte type, the payload size in bytes (uint32) and the payload:
+ *      - `I` (instance): event, instance (uint32), description, param, levtype, levelist (strings). It is written
+ *        once, before the first result of the instance, so that results do not repeat the strings.
+ *      - `R` (result): step (string), event, instance (uint32), number of cell ranges (uint32) followed by the
+ *        inclusive `[first, last]` ranges (int32 pairs), number of polygons (uint32) followed by, for each polygon,
+ *        its number of vertices (uint32) and the vertices as `(lon, lat)` double pairs.
+ *
+ * Strings are stored as their length (uint32) followed by their characters. Values use the native byte order.
+ * Records are buffered in memory and written by a background thread when `flush` is called. A truncated last
+ * record, e.g. after a crash, is ignored by the reader, and dropped when the file is opened again for appending.
+ */
+class ResultsSink {
+public:
+    /**
+     * @brief Opens the results file in append mode, after truncating it to its last complete record.
+     *
+     * @param path The path of the results file.
+     *
+     * @throws eckit::CantOpenFile if the file cannot be opened.
+     */
+    explicit ResultsSink(const std::string& path);
+
+    /// Buffers a detection result, it is written at the next `flush`.
+    void write(const ResultsRecord& record);
+
+    /// Hands the buffered results over to the background thread without waiting for them to be written.
+    void flush() { writer_.flush(); }
+
+    /// Blocks until all the buffered results are written to the file.
+    void sync() { writer_.sync(); }
+
+    /**
+     * @brief Reads all the results stored in a results file.
+     *
+     * @param path The path of the results file.
+     *
+     * @return The results, in the order they were written, with the instance strings filled in.
+     *
+     * @throws eckit::CantOpenFile if the file cannot be opened.
+     * @throws eckit::BadValue if the file is not a results file.
+     */
+    static std::vector<ResultsRecord> read(const std::string& path);
+
+private:
+    AsyncFileWriter writer_;
+    std::set<std::pair<uint32_t, uint32_t>> knownInstances_;  ///< Instances whose `I` record was written
+};
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,164 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "atlas/array.h"
+#include "atlas/parallel/mpi/mpi.h"
+#include "atlas/util/KDTree.h"
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+
+#include "plugin_types.h"
+#include "site_output.h"
+
+namespace ExtremeEventPlugin {
+
+SiteWindOutput::SiteWindOutput(const eckit::Configuration& config) {
+    u_        = config.getString("u", "");
+    v_        = config.getString("v", "");
+    output_   = config.getString("output", "ee_sites.csv");
+    levelIdx_ = std::max(config.getInt("model_level", 0) - 1, 0);
+    if (u_.empty() && v_.empty()) {
+        throw eckit::BadParameter("Site output requires at least one of the 'u' and 'v' wind fields", Here());
+    }
+
+    if (config.has("locations")) {
+        for (const auto& location : config.getSubConfigurations("locations")) {
+            sites_.push_back({location.getString("name"), location.getDouble("lat"), location.getDouble("lon")});
+        }
+    }
+    if (config.has("file")) {
+        std::ifstream in(config.getString("file"));
+        if (!in) {
+            throw eckit::CantOpenFile(config.getString("file"), Here());
+        }
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream row(line);
+            std::string name, lat, lon;
+            if (!std::getline(row, name, ',') || !std::getline(row, lat, ',') || !std::getline(row, lon, ',')) {
+                throw eckit::BadValue("Malformed site '" + line + "', expected 'name,lat,lon'", Here());
+            }
+            sites_.push_back({name, std::stod(lat), std::stod(lon)});
+        }
+    }
+    if (sites_.empty()) {
+        throw eckit::BadParameter("Site output requires 'locations' or a sites 'file'", Here());
+    }
+}
+
+std::vector<std::string> SiteWindOutput::requiredFields() const {
+    std::vector<std::string> fields;
+    for (const auto& field : {u_, v_}) {
+        if (!field.empty()) {
+            fields.push_back(field);
+        }
+    }
+    return fields;
+}
+
+void SiteWindOutput::setup(plume::data::ModelData& modelData, const std::string& suffix) {
+    auto fs     = modelData.getAtlasFieldShared(requiredFields()[0]).functionspace();
+    auto lonlat = atlas::array::make_view<double, 2>(fs.lonlat());
+    auto ghost  = atlas::array::make_view<int, 1>(fs.ghost());
+
+    // Nearest owned point of each site in this partition
+    atlas::util::IndexKDTree search;
+    search.reserve(fs.size());
+    size_t nbOwned = 0;
+    for (atlas::idx_t idx = 0; idx < fs.size(); ++idx) {
+        if (!ghost(idx)) {
+            search.insert(atlas::PointLonLat{lonlat(idx, 0), lonlat(idx, 1)}, idx);
+            ++nbOwned;
+        }
+    }
+    std::vector<double> distance(sites_.size(), std::numeric_limits<double>::max());
+    std::vector<atlas::idx_t> nearest(sites_.size(), -1);
+    if (nbOwned > 0) {
+        search.build();
+        for (size_t s = 0; s < sites_.size(); ++s) {
+            auto closest = search.closestPoint(atlas::PointLonLat{sites_[s].lon, sites_[s].lat});
+            distance[s]  = closest.distance();
+            nearest[s]   = closest.payload();
+        }
+    }
+
+    // The site belongs to the partition with the nearest point, ties go to the lowest rank
+    const auto& comm = atlas::mpi::comm();
+    const int rank   = static_cast<int>(comm.rank());
+    std::vector<double> minDistance(distance);
+    comm.allReduceInPlace(minDistance.begin(), minDistance.end(), eckit::mpi::min());
+    std::vector<int> owner(sites_.size());
+    for (size_t s = 0; s < sites_.size(); ++s) {
+        owner[s] = nearest[s] >= 0 && distance[s] == minDistance[s] ? rank : static_cast<int>(comm.size());
+    }
+    comm.allReduceInPlace(owner.begin(), owner.end(), eckit::mpi::min());
+
+    ownedSites_.clear();
+    sitePoints_.clear();
+    for (size_t s = 0; s < sites_.size(); ++s) {
+        if (owner[s] == rank) {
+            ownedSites_.push_back(s);
+            sitePoints_.push_back(nearest[s]);
+        }
+    }
+    eckit::Log::info() << "Site output: " << ownedSites_.size() << " of " << sites_.size()
+                       << " sites extracted on this partition" << std::endl;
+
+    std::string path = output_ + suffix;
+    if (comm.size() > 1) {
+        path += "." + std::to_string(rank);
+    }
+    writer_ = std::make_unique<AsyncFileWriter>(path);
+    if (writer_->startedEmpty()) {
+        writer_->write("step,site,lat,lon,u,v,speed\n");
+    }
+}
+
+void SiteWindOutput::write(plume::data::ModelData& modelData, const std::string& step) {
+    ASSERT_MSG(writer_, "Site output requires to be set up before writing");
+    dispatchFieldType(modelData.getAtlasFieldShared(requiredFields()[0]),
+                      [&](auto tag) { writeWithType<decltype(tag)>(modelData, step); });
+    // Hand the step over to the writing thread, the model does not wait for the file system
+    writer_->flush();
+}
+
+template <typename T>
+void SiteWindOutput::writeWithType(plume::data::ModelData& modelData, const std::string& step) {
+    std::unique_ptr<atlas::array::ArrayView<const T, 2>> u, v;
+    if (!u_.empty()) {
+        u = std::make_unique<atlas::array::ArrayView<const T, 2>>(
+            atlas::array::make_view<const T, 2>(modelData.getAtlasFieldShared(u_)));
+    }
+    if (!v_.empty()) {
+        v = std::make_unique<atlas::array::ArrayView<const T, 2>>(
+            atlas::array::make_view<const T, 2>(modelData.getAtlasFieldShared(v_)));
+    }
+
+    std::ostringstream rows;
+    for (size_t k = 0; k < ownedSites_.size(); ++k) {
+        const auto& site = sites_[ownedSites_[k]];
+        const T valU     = u ? (*u)(sitePoints_[k], levelIdx_) : T(0);
+        const T valV     = v ? (*v)(sitePoints_[k], levelIdx_) : T(0);
+        rows << step << "," << site.name << "," << site.lat << "," << site.lon << "," << valU << "," << valV << ","
+             << std::sqrt(valU * valU + valV * valV) << "\n";
+    }
+    writer_->write(rows.str());
+}
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,92 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "atlas/functionspace.h"
+#include "eckit/config/Configuration.h"
+#include "plume/data/ModelData.h"
+
+#include "async_writer.h"
+
+namespace ExtremeEventPlugin {
+
+/**
+ * @class SiteWindOutput
+ * @brief Extracts the wind at a list of sites (e.g. wind turbines or farms) at every model step.
+ *
+ * Each site is assigned at setup to the partition that owns the grid point nearest to it, so every site is written
+ * exactly once across all ranks. At each step, each rank appends one CSV row per site it owns to its own file:
+ * `step,site,lat,lon,u,v,speed`. Rows are buffered and written by a background thread to keep the file system out
+ * of the model time step.
+ *
+ * Configuration (`sites` key of the plugin core configuration):
+ *      - `output`: the path of the CSV file, suffixed with `.<rank>` when running on more than one rank.
+ *      - `u`, `v`: the wind component fields, at least one is required.
+ *      - `model_level`: the model level to extract for non surface fields (default: surface).
+ *      - `locations`: a list of `{name, lat, lon}` sites, and/or
+ *      - `file`: a CSV file with one `name,lat,lon` site per line (lines starting with `#` are ignored).
+ *
+ * @note The value at the nearest grid point is used, no interpolation is performed.
+ */
+class SiteWindOutput {
+public:
+    /**
+     * @brief Constructs the site output from its configuration.
+     *
+     * @throws eckit::BadParameter if no wind component or no site is configured.
+     */
+    explicit SiteWindOutput(const eckit::Configuration& config);
+
+    /**
+     * @brief Assigns each site to the partition owning its nearest grid point and opens the output file.
+     *
+     * This is a collective operation over the model communicator.
+     *
+     * @param modelData The model data that contains the wind fields.
+     * @param suffix Appended to the output path before the rank, e.g. to separate the files of ensemble members.
+     */
+    void setup(plume::data::ModelData& modelData, const std::string& suffix = "");
+
+    /**
+     * @brief Appends the wind at the sites owned by this partition for the current step.
+     *
+     * @param modelData The model data that contains the wind fields.
+     * @param step The model step string, as sent in the notifications.
+     */
+    void write(plume::data::ModelData& modelData, const std::string& step);
+
+    /// Returns the fields that must be offered by the model for the extraction.
+    std::vector<std::string> requiredFields() const;
+
+private:
+    struct Site {
+        std::string name;
+        double lat, lon;
+    };
+
+    std::vector<Site> sites_;
+    std::string u_, v_, output_;
+    int levelIdx_;
+
+    std::vector<size_t> ownedSites_;        ///< Indices of the sites owned by this partition
+    std::vector<atlas::idx_t> sitePoints_;  ///< Nearest grid point of each owned site
+    std::unique_ptr<AsyncFileWriter> writer_;
+
+    /// Appends the rows of the current step with fields of value type `T`.
+    template <typename T>
+    void writeWithType(plume::data::ModelData& modelData, const std::string& step);
+};
+
+}  // namespace ExtremeEventPlugin
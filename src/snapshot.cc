@@ -0,0 +1,180 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <cstring>
+
+#include "atlas/array.h"
+#include "atlas/parallel/mpi/mpi.h"
+#include "eckit/exception/Exceptions.h"
+
+#include "binary_records.h"
+#include "plugin_types.h"
+#include "snapshot.h"
+
+namespace ExtremeEventPlugin {
+
+namespace {
+
+const char magic[4]          = {'E', 'E', 'S', 'N'};
+const uint32_t formatVersion = 1;
+
+}  // namespace
+
+SnapshotWriter::SnapshotWriter(const std::string& path, plume::data::ModelData& modelData,
+                               const std::vector<std::string>& fields) :
+    writer_(path, false), fields_(fields) {
+    ASSERT_MSG(!fields_.empty(), "A snapshot requires at least one field");
+    writer_.write(fileHeader(magic, formatVersion));
+
+    auto fs     = modelData.getAtlasFieldShared(fields_[0]).functionspace();
+    auto lonlat = atlas::array::make_view<double, 2>(fs.lonlat());
+    auto ghost  = atlas::array::make_view<int, 1>(fs.ghost());
+    auto gidx   = atlas::array::make_view<atlas::gidx_t, 1>(fs.global_index());
+    RecordEncoder geometry;
+    geometry.put(static_cast<uint64_t>(fs.size()));
+    for (atlas::idx_t j = 0; j < fs.size(); ++j) {
+        geometry.put(lonlat(j, 0));
+        geometry.put(lonlat(j, 1));
+    }
+    for (atlas::idx_t j = 0; j < fs.size(); ++j) {
+        geometry.put(static_cast<int32_t>(ghost(j)));
+    }
+    for (atlas::idx_t j = 0; j < fs.size(); ++j) {
+        geometry.put(static_cast<int64_t>(gidx(j)));
+    }
+    geometry.put(static_cast<int32_t>(modelData.getInt("NFLEVG")));
+    geometry.put(static_cast<uint32_t>(fields_.size()));
+    for (const auto& name : fields_) {
+        const auto& field = modelData.getAtlasFieldShared(name);
+        if (field.shape(0) != fs.size()) {
+            throw eckit::BadValue("Field '" + name + "' is not on the function space of field '" + fields_[0] +
+                                      "', it cannot be recorded in the same snapshot",
+                                  Here());
+        }
+        geometry.put(name);
+        geometry.put(static_cast<uint8_t>(dispatchFieldType(field, [](auto tag) { return sizeof(tag) == 8; })));
+        geometry.put(static_cast<uint32_t>(field.shape(1)));
+    }
+    writer_.write(geometry.record('G'));
+}
+
+void SnapshotWriter::write(plume::data::ModelData& modelData) {
+    RecordEncoder step;
+    step.put(static_cast<int32_t>(modelData.getInt("NSTEP")));
+    step.put(modelData.getDouble("TSTEP"));
+    writer_.write(step.record('S'));
+    for (uint32_t idx = 0; idx < fields_.size(); ++idx) {
+        const auto& field = modelData.getAtlasFieldShared(fields_[idx]);
+        dispatchFieldType(field, [&](auto tag) {
+            using T    = decltype(tag);
+            auto view  = atlas::array::make_view<const T, 2>(field);
+            auto bytes = static_cast<size_t>(view.size()) * sizeof(T);
+            // The values are appended as they are, without going through an encoder
+            writer_.write(recordPrefix('F', sizeof(idx) + bytes));
+            writer_.writeValue(idx);
+            writer_.write(view.data(), bytes);
+        });
+    }
+}
+
+std::string snapshotPath(const std::string& path, int member) {
+    std::string rankPath = member >= 0 ? path + ".member" + std::to_string(member) : path;
+    const auto& comm     = atlas::mpi::comm();
+    if (comm.size() > 1) {
+        rankPath += "." + std::to_string(comm.rank());
+    }
+    return rankPath;
+}
+
+SnapshotReader::SnapshotReader(const std::string& path) : file_(std::fopen(path.c_str(), "rb")) {
+    if (!file_) {
+        throw eckit::CantOpenFile(path, Here());
+    }
+    std::string header(fileHeader(magic, formatVersion).size(), '\0');
+    if (std::fread(&header[0], 1, header.size(), file_) != header.size() ||
+        !hasFileHeader(header, magic, formatVersion) || readRecord() != 'G') {
+        std::fclose(file_);
+        throw eckit::BadValue("'" + path + "' is not an extreme event snapshot file or has an unsupported version",
+                              Here());
+    }
+
+    RecordDecoder geometry(payload_.data(), payload_.size());
+    const auto points = geometry.get<uint64_t>();
+    geometry_.lonlat.resize(2 * points);
+    for (auto& coordinate : geometry_.lonlat) {
+        coordinate = geometry.get<double>();
+    }
+    geometry_.ghost.resize(points);
+    for (auto& ghost : geometry_.ghost) {
+        ghost = geometry.get<int32_t>();
+    }
+    geometry_.globalIndex.resize(points);
+    for (auto& gidx : geometry_.globalIndex) {
+        gidx = geometry.get<int64_t>();
+    }
+    geometry_.nflevg = geometry.get<int32_t>();
+    geometry_.fields.resize(geometry.get<uint32_t>());
+    for (auto& field : geometry_.fields) {
+        field.name            = geometry.getString();
+        field.doublePrecision = geometry.get<uint8_t>() != 0;
+        field.levels          = geometry.get<uint32_t>();
+    }
+}
+
+SnapshotReader::~SnapshotReader() {
+    std::fclose(file_);
+}
+
+bool SnapshotReader::next(int& nstep, double& tstep, std::vector<atlas::Field>& fields) {
+    ASSERT(fields.size() == geometry_.fields.size());
+    if (readRecord() != 'S') {
+        return false;
+    }
+    RecordDecoder step(payload_.data(), payload_.size());
+    nstep = step.get<int32_t>();
+    tstep = step.get<double>();
+    for (size_t read = 0; read < fields.size(); ++read) {
+        if (readRecord() != 'F') {
+            return false;
+        }
+        RecordDecoder prefix(payload_.data(), sizeof(uint32_t));
+        const auto idx = prefix.get<uint32_t>();
+        if (idx >= fields.size()) {
+            throw eckit::BadValue("Corrupted record in binary file", Here());
+        }
+        dispatchFieldType(fields[idx], [&](auto tag) {
+            using T   = decltype(tag);
+            auto view = atlas::array::make_view<T, 2>(fields[idx]);
+            if (payload_.size() != sizeof(uint32_t) + static_cast<size_t>(view.size()) * sizeof(T)) {
+                throw eckit::BadValue("Field '" + geometry_.fields[idx].name +
+                                          "' does not match the shape or precision of the snapshot",
+                                      Here());
+            }
+            std::memcpy(view.data(), payload_.data() + sizeof(uint32_t), payload_.size() - sizeof(uint32_t));
+        });
+    }
+    return true;
+}
+
+char SnapshotReader::readRecord() {
+    char type;
+    uint32_t size;
+    if (std::fread(&type, sizeof(type), 1, file_) != 1 || std::fread(&size, sizeof(size), 1, file_) != 1) {
+        return 0;
+    }
+    payload_.resize(size);
+    if (std::fread(payload_.data(), 1, size, file_) != size) {
+        // Truncated last record, e.g. the recording run was interrupted
+        return 0;
+    }
+    return type;
+}
+
+}  // namespace ExtremeEventPlugin
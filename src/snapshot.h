@@ -0,0 +1,139 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "atlas/field/Field.h"
+#include "atlas/functionspace.h"
+#include "plume/data/ModelData.h"
+
+#include "async_writer.h"
+
+namespace ExtremeEventPlugin {
+
+/**
+ * @brief The partition and fields description stored at the beginning of a snapshot file.
+ */
+struct SnapshotGeometry {
+    struct FieldInfo {
+        std::string name;
+        bool doublePrecision;
+        uint32_t levels;
+    };
+
+    std::vector<double> lonlat;        ///< Longitude and latitude of each point of the partition, halo included
+    std::vector<int32_t> ghost;        ///< Whether each point is in the halo
+    std::vector<int64_t> globalIndex;  ///< Global index of each point in the model grid, from 1
+    int32_t nflevg = 0;                ///< Number of model levels, offered to the plugin as `NFLEVG`
+    std::vector<FieldInfo> fields;
+
+    size_t points() const { return ghost.size(); }
+};
+
+/**
+ * @class SnapshotWriter
+ * @brief Records the model data received by the plugin, so that the steps can be replayed without the model.
+ *
+ * The file starts with the magic `EESN` and a format version, followed by records (see `binary_records.h`):
+ *      - `G` (geometry), once: number of points (uint64), `(lon, lat)` of each point (double pairs), ghost flag of
+ *        each point (int32), global index of each point (int64), `NFLEVG` (int32), number of fields (uint32) and,
+ *        for each field, its name (string), precision (uint8, 1 for double) and number of levels (uint32).
+ *      - `S` (step): `NSTEP` (int32) and `TSTEP` (double), followed by one `F` record per field.
+ *      - `F` (field): field index (uint32) followed by the values of the field at this step, point-major as in the
+ *        Atlas field, in the field precision.
+ *
+ * Values use the native byte order. The data is written by a background thread when `flush` is called. There is one
+ * file per partition, and the fields are recorded with their halo, so that the replay sees the same partition.
+ */
+class SnapshotWriter {
+public:
+    /**
+     * @brief Opens the snapshot file, truncating it, and records the geometry of the partition.
+     *
+     * @param path The path of the snapshot file.
+     * @param modelData The model data, providing `NFLEVG` and the fields.
+     * @param fields The names of the fields to record, all on the same function space.
+     *
+     * @throws eckit::CantOpenFile if the file cannot be opened.
+     */
+    SnapshotWriter(const std::string& path, plume::data::ModelData& modelData, const std::vector<std::string>& fields);
+
+    /// Buffers the parameters and fields of the current step, they are written at the next `flush`.
+    void write(plume::data::ModelData& modelData);
+
+    /// Hands the buffered steps over to the background thread without waiting for them to be written.
+    void flush() { writer_.flush(); }
+
+    /// Blocks until all the buffered steps are written to the file.
+    void sync() { writer_.sync(); }
+
+private:
+    AsyncFileWriter writer_;
+    std::vector<std::string> fields_;
+};
+
+/**
+ * @brief Returns the path of the snapshot file of this rank, shared by the recording and the replay.
+ *
+ * The configured path is suffixed with the ensemble member, if any, then with the rank of the model communicator when
+ * running on more than one rank.
+ *
+ * @param path The configured `record` path.
+ * @param member The index of the ensemble member, negative outside ensemble mode.
+ */
+std::string snapshotPath(const std::string& path, int member = -1);
+
+/**
+ * @class SnapshotReader
+ * @brief Reads back the steps of a snapshot file written by `SnapshotWriter`, one at a time.
+ */
+class SnapshotReader {
+public:
+    /**
+     * @brief Opens the snapshot file and reads its geometry.
+     *
+     * @throws eckit::CantOpenFile if the file cannot be opened.
+     * @throws eckit::BadValue if it is not a snapshot file or its geometry is corrupted.
+     */
+    explicit SnapshotReader(const std::string& path);
+
+    ~SnapshotReader();
+
+    SnapshotReader(const SnapshotReader&)            = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    const SnapshotGeometry& geometry() const { return geometry_; }
+
+    /**
+     * @brief Reads the next step into the fields.
+     *
+     * @param[out] nstep The recorded `NSTEP`.
+     * @param[out] tstep The recorded `TSTEP`.
+     * @param[in,out] fields The fields to fill, in the order of the geometry, with the recorded precision and shape.
+     *
+     * @return Whether a complete step was read, `false` at the end of the file or at a truncated step.
+     */
+    bool next(int& nstep, double& tstep, std::vector<atlas::Field>& fields);
+
+private:
+    std::FILE* file_;
+    SnapshotGeometry geometry_;
+    std::vector<char> payload_;  ///< Payload of the last record read, reused between records
+
+    /// Reads the next record, returns its type, or 0 at the end of the file or at a truncated record.
+    char readRecord();
+};
+
+}  // namespace ExtremeEventPlugin
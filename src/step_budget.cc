@@ -0,0 +1,128 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+
+#include "step_budget.h"
+
+namespace ExtremeEventPlugin {
+
+StepBudget::StepBudget(const eckit::LocalConfiguration& config, Clock clock, Reduce reduce) :
+    clock_(std::move(clock)),
+    reduce_(std::move(reduce)),
+    milliseconds_(config.getDouble("milliseconds", 0.0)),
+    fraction_(config.getDouble("fraction", 0.0)),
+    maxPolygons_(0),
+    relaxSteps_(config.getInt("relax_steps", 3)) {
+    if (!clock_) {
+        clock_ = []() {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        };
+    }
+    if (!config.has("milliseconds") && !config.has("fraction")) {
+        throw eckit::BadParameter("The 'step_budget' requires 'milliseconds' or a 'fraction' of the model step time",
+                                  Here());
+    }
+    const int maxPolygons = config.getInt("max_polygons", 16);
+    if ((config.has("milliseconds") && milliseconds_ <= 0.0) || (config.has("fraction") && fraction_ <= 0.0) ||
+        maxPolygons < 1 || relaxSteps_ < 1) {
+        throw eckit::BadParameter(
+            "The 'step_budget' options 'milliseconds', 'fraction', 'max_polygons' and 'relax_steps' must be positive",
+            Here());
+    }
+    maxPolygons_ = static_cast<size_t>(maxPolygons);
+}
+
+void StepBudget::startStep() {
+    stepStart_ = clock_();
+    lastMark_  = stepStart_;
+    phases_.fill(0.0);
+    deferred_ = 0;
+    capped_   = 0;
+
+    budget_ = milliseconds_ * 1e-3;
+    if (fraction_ > 0.0 && stepEnd_ >= 0.0) {
+        const double relative = fraction_ * (stepStart_ - stepEnd_);
+        budget_               = budget_ > 0.0 ? std::min(budget_, relative) : relative;
+    }
+}
+
+void StepBudget::mark(Phase phase) {
+    const double now = clock_();
+    phases_[static_cast<size_t>(phase)] += now - lastMark_;
+    lastMark_ = now;
+}
+
+double StepBudget::overshoot(double spent) const {
+    // Every rank takes part in the reduction, also the ranks without a budget yet
+    const double local = budget_ > 0.0 ? spent - budget_ : -1.0;
+    return reduce_ ? reduce_(local) : local;
+}
+
+bool StepBudget::exhausted() const {
+    return overshoot(clock_() - stepStart_) > 0.0;
+}
+
+size_t StepBudget::polygonCap() const {
+    return capping_ ? maxPolygons_ : std::numeric_limits<size_t>::max();
+}
+
+std::string StepBudget::endStep(const std::string& step) {
+    stepEnd_              = clock_();
+    const double spent    = stepEnd_ - stepStart_;
+    const bool over       = overshoot(spent) > 0.0;
+    const bool wasCapping = capping_;
+    if (over) {
+        capping_       = true;
+        stepsInBudget_ = 0;
+    }
+    else if (capping_ && ++stepsInBudget_ >= relaxSteps_) {
+        capping_ = false;
+    }
+    if (!over && !wasCapping && deferred_ == 0) {
+        return "";
+    }
+
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(1) << "Step budget at step " << step << ": " << spent * 1e3
+           << " ms spent for a budget of " << budget_ * 1e3 << " ms (detection "
+           << phases_[static_cast<size_t>(Phase::Detection)] * 1e3 << " ms, tracking "
+           << phases_[static_cast<size_t>(Phase::Tracking)] * 1e3 << " ms, output "
+           << phases_[static_cast<size_t>(Phase::Output)] * 1e3 << " ms)";
+    if (deferred_ > 0) {
+        report << ", " << deferred_ << " instance output(s) deferred to a later step";
+    }
+    if (wasCapping) {
+        report << ", " << capped_ << " group(s) of cells left without polygons by the cap of " << maxPolygons_
+               << " per instance";
+    }
+    if (capping_ && !wasCapping) {
+        report << ", polygons capped to " << maxPolygons_ << " per instance from the next step";
+    }
+    else if (!capping_ && wasCapping) {
+        report << ", polygon cap lifted after " << relaxSteps_ << " step(s) in budget";
+    }
+    if (over || deferred_ > 0) {
+        eckit::Log::warning() << report.str() << std::endl;
+    }
+    else {
+        eckit::Log::info() << report.str() << std::endl;
+    }
+    return report.str();
+}
+
+}  // namespace ExtremeEventPlugin
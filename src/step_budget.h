@@ -0,0 +1,124 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+#include "eckit/config/LocalConfiguration.h"
+
+namespace ExtremeEventPlugin {
+
+/**
+ * @class StepBudget
+ * @brief Measures the time the plugin spends in each step, and decides how to degrade its output to fit a budget.
+ *
+ * The budget of a step is an absolute time (`milliseconds`), a fraction (`fraction`) of the time the model spent on
+ * its own since the previous step of the plugin, or the smaller of both. The plugin asks the budget two questions:
+ * - during a step, whether the budget is `exhausted`, in which case the polygons of the remaining instances are
+ *   deferred to a later step;
+ * - at the start of a step, how many polygons an instance may send (`polygonCap`). After a step over budget, the
+ *   instances are capped to `max_polygons` polygons, the largest groups of cells first, until `relax_steps`
+ *   consecutive steps fit in the budget again. The polygons of the groups beyond the cap are not extracted.
+ *
+ * Each decision is logged at the end of the step with the time spent in each phase. Both decisions are taken on the
+ * largest overshoot of the ranks sharing the budget, so that all the partitions defer and cap the same outputs.
+ */
+class StepBudget {
+public:
+    /// Phases of a step whose time is reported
+    enum class Phase
+    {
+        Detection,  ///< Detection of the events and firing cells, including the ensemble reduction
+        Tracking,   ///< Grouping of the firing cells, tracking and statistics
+        Output,     ///< Polygons, notifications and results file
+        Count
+    };
+
+    /// Returns the current time in seconds, from an arbitrary origin.
+    using Clock = std::function<double()>;
+
+    /// Returns the maximum of a value over the ranks sharing the budget.
+    using Reduce = std::function<double(double)>;
+
+    /**
+     * @brief Reads the budget options.
+     *
+     * @param config The `step_budget` options: `milliseconds`, `fraction`, `max_polygons` (16 by default) and
+     *               `relax_steps` (3 by default).
+     * @param clock The clock measuring the phases, a monotonic wall clock by default.
+     * @param reduce The reduction of the overshoots over the ranks, none by default (a single rank).
+     *
+     * @throws eckit::BadParameter if neither `milliseconds` nor `fraction` is given, or if an option is not positive.
+     */
+    explicit StepBudget(const eckit::LocalConfiguration& config, Clock clock = Clock(), Reduce reduce = Reduce());
+
+    /// Starts measuring a step, the time since the end of the previous step is the time of the model.
+    void startStep();
+
+    /// Attributes the time since the previous mark of the step to a phase.
+    void mark(Phase phase);
+
+    /// Returns whether the time spent since the start of the step exceeds the budget of the step on any rank.
+    bool exhausted() const;
+
+    /// Returns the number of polygons an instance may send at this step, unlimited if the output is not capped.
+    size_t polygonCap() const;
+
+    /// Records that the output of an instance was deferred to a later step.
+    void deferred() { ++deferred_; }
+
+    /// Records groups of cells (or ended events) left without polygons by the cap.
+    void capped(size_t groups) { capped_ += groups; }
+
+    /**
+     * @brief Ends the step, decides the degradation of the next steps and logs the decisions.
+     *
+     * The next steps are capped if the step was over budget on any rank.
+     *
+     * @param step The name of the step in the logs.
+     *
+     * @return The report of the step if a degradation was in effect or decided, empty otherwise.
+     */
+    std::string endStep(const std::string& step);
+
+    /// Returns the budget of the current step in seconds, 0 if it is unknown (the first step with a fraction only).
+    double budget() const { return budget_; }
+
+    /// Returns whether the output is capped at this step.
+    bool capping() const { return capping_; }
+
+private:
+    /// Returns the largest overshoot of the budget over the ranks, negative if no rank is over its budget.
+    double overshoot(double spent) const;
+
+    Clock clock_;
+    Reduce reduce_;
+    double milliseconds_;
+    double fraction_;
+    size_t maxPolygons_;
+    int relaxSteps_;
+
+    double stepStart_ = 0.0;
+    double lastMark_  = 0.0;
+    double stepEnd_   = -1.0;  ///< End of the previous step, negative before the first step
+    double budget_    = 0.0;
+    std::array<double, static_cast<size_t>(Phase::Count)> phases_{};
+
+    bool capping_      = false;
+    int stepsInBudget_ = 0;  ///< Consecutive steps in budget while capping
+    size_t deferred_   = 0;  ///< Instance outputs deferred during the step
+    size_t capped_     = 0;  ///< Groups of cells left without polygons by the cap during the step
+};
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,169 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+#include "eckit/config/YAMLConfiguration.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/PathName.h"
+
+#include "subscription_index.h"
+
+namespace ExtremeEventPlugin {
+
+SubscriptionIndex::SubscriptionIndex(const eckit::LocalConfiguration& config) {
+    std::vector<eckit::LocalConfiguration> entries;
+    if (config.has("subscribers")) {
+        entries = config.getSubConfigurations("subscribers");
+    }
+    if (config.has("file")) {
+        eckit::YAMLConfiguration file{eckit::PathName(config.getString("file"))};
+        for (const auto& entry : file.getSubConfigurations("subscribers")) {
+            entries.push_back(entry);
+        }
+    }
+
+    std::unordered_set<std::string> names;
+    for (const auto& entry : entries) {
+        Subscriber subscriber;
+        subscriber.name     = entry.getString("name", "");
+        subscriber.endpoint = entry.getString("endpoint", "");
+        subscriber.regions  = RegionUtils::regionsFromConfig(entry);
+        if (entry.has("cells")) {
+            subscriber.cells = entry.getIntVector("cells");
+        }
+        if (subscriber.name.empty() || !names.insert(subscriber.name).second) {
+            throw eckit::BadParameter("Each subscriber requires a unique 'name'", Here());
+        }
+        if (subscriber.regions.empty() && subscriber.cells.empty()) {
+            throw eckit::BadParameter("The subscriber '" + subscriber.name + "' has no 'regions' nor 'cells'", Here());
+        }
+        subscribers_.push_back(std::move(subscriber));
+    }
+    words_ = (subscribers_.size() + 63) / 64;
+
+    const std::string mainEndpoint = config.getString("main_endpoint", "all");
+    if (mainEndpoint == "all") {
+        mainEndpoint_ = MainEndpoint::All;
+    }
+    else if (mainEndpoint == "subscribed") {
+        mainEndpoint_ = MainEndpoint::Subscribed;
+    }
+    else if (mainEndpoint == "none") {
+        mainEndpoint_ = MainEndpoint::None;
+    }
+    else {
+        throw eckit::BadValue("Unknown subscriptions 'main_endpoint' '" + mainEndpoint +
+                                  "', expected 'all', 'subscribed' or 'none'",
+                              Here());
+    }
+}
+
+void SubscriptionIndex::mark(int cell, size_t subscriber) {
+    auto row = cellRow_.emplace(cell, cellRow_.size());
+    if (row.second) {
+        bitmaps_.resize(bitmaps_.size() + words_, 0);
+    }
+    bitmaps_[row.first->second * words_ + subscriber / 64] |= uint64_t(1) << (subscriber % 64);
+}
+
+void SubscriptionIndex::markRegions(const std::set<int>& cells, const CellVertices& cellVertices) {
+    for (size_t idx = 0; idx < subscribers_.size(); ++idx) {
+        const auto& regions = subscribers_[idx].regions;
+        for (int cell : cells) {
+            const auto& vertices = cellVertices(cell);
+            if (std::any_of(regions.begin(), regions.end(),
+                            [&vertices](const RegionUtils::Region& region) { return region.intersects(vertices); })) {
+                mark(cell, idx);
+            }
+        }
+    }
+}
+
+void SubscriptionIndex::addFunctionSpace(const std::vector<int>& pointToCell, const CellVertices& cellVertices) {
+    if (!configuredCells_) {
+        for (size_t idx = 0; idx < subscribers_.size(); ++idx) {
+            for (int cell : subscribers_[idx].cells) {
+                mark(cell, idx);
+            }
+        }
+        configuredCells_ = true;
+    }
+    // Only the cells not indexed by another function space
+    std::set<int> cells;
+    for (int cell : pointToCell) {
+        if (cell >= 0 && cells_.insert(cell).second) {
+            cells.insert(cell);
+        }
+    }
+    markRegions(cells, cellVertices);
+}
+
+SubscriptionIndex SubscriptionIndex::coarsened(const std::function<int(int)>& coarseCell,
+                                               const CellVertices& coarseVertices) const {
+    SubscriptionIndex coarse(*this);
+    coarse.cellRow_.clear();
+    coarse.bitmaps_.clear();
+    coarse.cells_.clear();
+    for (size_t idx = 0; idx < subscribers_.size(); ++idx) {
+        for (int cell : subscribers_[idx].cells) {
+            const int coarseIdx = coarseCell(cell);
+            if (coarseIdx >= 0) {
+                coarse.mark(coarseIdx, idx);
+            }
+        }
+    }
+    for (int cell : cells_) {
+        const int coarseIdx = coarseCell(cell);
+        if (coarseIdx >= 0) {
+            coarse.cells_.insert(coarseIdx);
+        }
+    }
+    coarse.markRegions(coarse.cells_, coarseVertices);
+    return coarse;
+}
+
+std::vector<size_t> SubscriptionIndex::subscribersOf(const std::vector<int>& cells) const {
+    std::vector<uint64_t> bitmap(words_, 0);
+    for (int cell : cells) {
+        auto row = cellRow_.find(cell);
+        if (row == cellRow_.end()) {
+            continue;
+        }
+        const uint64_t* bits = bitmaps_.data() + row->second * words_;
+        for (size_t word = 0; word < words_; ++word) {
+            bitmap[word] |= bits[word];
+        }
+    }
+    std::vector<size_t> subscribers;
+    for (size_t word = 0; word < words_; ++word) {
+        size_t bit = 0;
+        for (uint64_t bits = bitmap[word]; bits != 0; bits >>= 1, ++bit) {
+            if (bits & 1) {
+                subscribers.push_back(word * 64 + bit);
+            }
+        }
+    }
+    return subscribers;
+}
+
+std::string SubscriptionIndex::namesToJson(const std::vector<size_t>& subscribers) const {
+    std::ostringstream json;
+    json << "[";
+    for (size_t k = 0; k < subscribers.size(); ++k) {
+        json << (k > 0 ? "," : "") << "\"" << subscribers_[subscribers[k]].name << "\"";
+    }
+    json << "]";
+    return json.str();
+}
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,123 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "atlas/util/Point.h"
+#include "eckit/config/LocalConfiguration.h"
+
+#include "region_utils.h"
+
+namespace ExtremeEventPlugin {
+
+/**
+ * @class SubscriptionIndex
+ * @brief Finds the subscribers whose areas of interest intersect a group of firing HEALPix cells.
+ *
+ * Each subscriber has a `name`, optionally its own notification `endpoint`, and areas of interest given as `regions`
+ * (lat/lon boxes or polygons, see `RegionUtils::Region`) and/or HEALPix `cells` at the resolution of the plugin. The
+ * subscribers are listed under `subscribers`, or in the YAML `file` with the same list.
+ *
+ * At setup, the areas are resolved into the HEALPix cells of the partition whose polygons intersect them, and each of
+ * these cells gets a bitmap of its subscribers. An area smaller than the grid spacing still gets the cells it lies in,
+ * and the partitions sharing a cell tag it alike, since none depends on the grid points of the area. Finding the
+ * subscribers of a group of cells then costs one lookup and one bitwise or per cell, whatever the shape of the areas.
+ */
+class SubscriptionIndex {
+public:
+    /// Which notifications are sent to the notification endpoint of the plugin
+    enum class MainEndpoint
+    {
+        All,         ///< All of them, tagged with their subscribers
+        Subscribed,  ///< Only those with at least one subscriber
+        None         ///< None, the notifications only go to the endpoints of their subscribers
+    };
+
+    struct Subscriber {
+        std::string name;
+        std::string endpoint;  ///< Notification endpoint of the subscriber, empty if it only filters the main one
+        std::vector<RegionUtils::Region> regions;
+        std::vector<int> cells;  ///< HEALPix cells listed in the configuration
+    };
+
+    /**
+     * @brief Reads the subscribers.
+     *
+     * @param config The `subscriptions` options: `subscribers` and/or `file`, and `main_endpoint` (`all` by default,
+     *               `subscribed` or `none`).
+     *
+     * @throws eckit::BadParameter if a subscriber has no name or no area, or if two subscribers share a name.
+     * @throws eckit::BadValue if `main_endpoint` is unknown.
+     */
+    explicit SubscriptionIndex(const eckit::LocalConfiguration& config);
+
+    /// Returns the vertices of a HEALPix cell.
+    using CellVertices = std::function<const std::vector<atlas::PointLonLat>&(int)>;
+
+    /**
+     * @brief Indexes the cells of the owned points of a function space whose polygons intersect the areas of each
+     *        subscriber.
+     *
+     * This is called once per function space mapped to HEALPix cells, the cells listed in the configuration are
+     * indexed by the first call.
+     *
+     * @param pointToCell The HEALPix cell of each point of the function space, -1 for the halo.
+     * @param cellVertices Returns the vertices of the cells of `pointToCell`.
+     */
+    void addFunctionSpace(const std::vector<int>& pointToCell, const CellVertices& cellVertices);
+
+    /**
+     * @brief Returns the same subscribers, indexed on the cells of a coarser HEALPix level.
+     *
+     * The coarse cells of the partition are intersected with the areas again, so that a coarse cell lying across
+     * partitions gets the same subscribers on all of them. The cells listed in the configuration tag the coarse cells
+     * containing them.
+     *
+     * @param coarseCell Returns the coarse cell of a cell, -1 if it has none.
+     * @param coarseVertices Returns the vertices of a coarse cell of the partition.
+     */
+    SubscriptionIndex coarsened(const std::function<int(int)>& coarseCell, const CellVertices& coarseVertices) const;
+
+    /// Returns the indices of the subscribers of any of the cells, in the order of the configuration.
+    std::vector<size_t> subscribersOf(const std::vector<int>& cells) const;
+
+    /// Returns the JSON list of the names of the given subscribers.
+    std::string namesToJson(const std::vector<size_t>& subscribers) const;
+
+    const Subscriber& subscriber(size_t idx) const { return subscribers_[idx]; }
+    size_t size() const { return subscribers_.size(); }
+    size_t indexedCells() const { return cellRow_.size(); }
+    MainEndpoint mainEndpoint() const { return mainEndpoint_; }
+
+private:
+    std::vector<Subscriber> subscribers_;
+    MainEndpoint mainEndpoint_ = MainEndpoint::All;
+    bool configuredCells_      = false;  ///< Whether the cells of the configuration are indexed
+
+    size_t words_;                             ///< Number of 64 bit words of a bitmap
+    std::unordered_map<int, size_t> cellRow_;  ///< Row of the bitmap of each indexed cell
+    std::vector<uint64_t> bitmaps_;            ///< Bitmaps of the indexed cells, `words_` per row
+    std::set<int> cells_;                      ///< Cells of the owned points of the partition
+
+    /// Marks a subscriber on a cell.
+    void mark(int cell, size_t subscriber);
+
+    /// Marks the subscribers whose regions intersect each of the cells.
+    void markRegions(const std::set<int>& cells, const CellVertices& cellVertices);
+};
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,142 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+
+#include "atlas/array.h"
+#include "eckit/exception/Exceptions.h"
+
+#include "threshold_field.h"
+
+namespace ThresholdUtils {
+
+namespace {
+
+const char magic[4]          = {'E', 'E', 'T', 'H'};
+const uint32_t formatVersion = 1;
+
+/// Layout of the file header, the thresholds start right after it
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t levels;
+    uint32_t padding;  ///< Keeps `points` 8-byte aligned
+    uint64_t points;
+};
+static_assert(sizeof(Header) == 24, "Unexpected threshold file header size");
+
+}  // namespace
+
+ThresholdField::ThresholdField(const std::string& path) : path_(path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw eckit::CantOpenFile(path, Here());
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw eckit::CantOpenFile(path, Here());
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ < sizeof(Header)) {
+        ::close(fd);
+        throw eckit::BadValue("'" + path + "' is not a threshold file", Here());
+    }
+    mapping_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid once the descriptor is closed
+    ::close(fd);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        throw eckit::CantOpenFile(path, Here());
+    }
+
+    Header header;
+    std::memcpy(&header, mapping_, sizeof(Header));
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != formatVersion) {
+        ::munmap(mapping_, size_);
+        throw eckit::BadValue("'" + path + "' is not a threshold file or has an unsupported version", Here());
+    }
+    levels_ = header.levels;
+    points_ = header.points;
+    if (size_ != sizeof(Header) + levels_ * points_ * sizeof(float)) {
+        ::munmap(mapping_, size_);
+        throw eckit::BadValue("'" + path + "' is truncated or its size does not match its header", Here());
+    }
+    values_ = reinterpret_cast<const float*>(static_cast<const char*>(mapping_) + sizeof(Header));
+}
+
+ThresholdField::~ThresholdField() {
+    if (mapping_) {
+        ::munmap(mapping_, size_);
+    }
+}
+
+std::vector<float> ThresholdField::slice(const std::vector<atlas::gidx_t>& globalIndices, size_t level) const {
+    if (level >= levels_) {
+        throw eckit::BadValue("Level " + std::to_string(level + 1) + " is not in the threshold file '" + path_ +
+                                  "', which has " + std::to_string(levels_) + " levels",
+                              Here());
+    }
+    const float* levelValues = values_ + level * points_;
+    std::vector<float> thresholds(globalIndices.size());
+    for (size_t k = 0; k < globalIndices.size(); ++k) {
+        const atlas::gidx_t idx = globalIndices[k] - 1;
+        if (idx < 0 || static_cast<size_t>(idx) >= points_) {
+            throw eckit::BadValue("The threshold file '" + path_ + "' has " + std::to_string(points_) +
+                                      " points and does not cover the global index " +
+                                      std::to_string(globalIndices[k]) + ", was it made for another grid?",
+                                  Here());
+        }
+        thresholds[k] = levelValues[idx];
+    }
+    return thresholds;
+}
+
+std::vector<float> ThresholdField::slice(const atlas::FunctionSpace& fs, const std::vector<atlas::idx_t>& points,
+                                         size_t level) const {
+    auto globalIndex = atlas::array::make_view<atlas::gidx_t, 1>(fs.global_index());
+    std::vector<atlas::gidx_t> globalIndices(points.size());
+    for (size_t k = 0; k < points.size(); ++k) {
+        globalIndices[k] = globalIndex(points[k]);
+    }
+    return slice(globalIndices, level);
+}
+
+void ThresholdField::write(const std::string& path, uint32_t levels, uint64_t points,
+                           const std::vector<float>& values) {
+    if (values.size() != levels * points) {
+        throw eckit::BadValue("A threshold file of " + std::to_string(levels) + " levels and " +
+                                  std::to_string(points) + " points requires " + std::to_string(levels * points) +
+                                  " values, got " + std::to_string(values.size()),
+                              Here());
+    }
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = formatVersion;
+    header.levels  = levels;
+    header.points  = points;
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        throw eckit::CantOpenFile(path, Here());
+    }
+    const bool written = std::fwrite(&header, sizeof(Header), 1, file) == 1 &&
+                         std::fwrite(values.data(), sizeof(float), values.size(), file) == values.size();
+    if (std::fclose(file) != 0 || !written) {
+        throw eckit::WriteError(path, Here());
+    }
+}
+
+}  // namespace ThresholdUtils
@@ -0,0 +1,107 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "atlas/functionspace.h"
+#include "atlas/library/config.h"
+
+namespace ThresholdUtils {
+
+/**
+ * @class ThresholdField
+ * @brief Read-only, memory-mapped file of per-point thresholds on the global model grid, e.g. a climatological
+ *        percentile of the wind at each grid point and level.
+ *
+ * The file starts with the magic `EETH`, the format version (uint32), the number of levels (uint32), 4 bytes of
+ * padding and the number of grid points (uint64). The thresholds follow as float32 values, level by level, each level
+ * holding the values of all the grid points ordered by global index. Values use the native byte order, and NaN values
+ * mean that there is no threshold at the point (the point never fires).
+ *
+ * The file is mapped rather than read, so that each partition only loads the pages holding its own points when the
+ * thresholds are sliced at setup. The mapping can be released once the slices are taken.
+ */
+class ThresholdField {
+public:
+    /**
+     * @brief Maps a threshold file and validates its header.
+     *
+     * @param path The path of the threshold file.
+     *
+     * @throws eckit::CantOpenFile if the file cannot be opened or mapped.
+     * @throws eckit::BadValue if the file is not a threshold file or its size does not match its header.
+     */
+    explicit ThresholdField(const std::string& path);
+
+    /// Unmaps the file.
+    ~ThresholdField();
+
+    ThresholdField(const ThresholdField&)            = delete;
+    ThresholdField& operator=(const ThresholdField&) = delete;
+
+    /// Returns the number of levels of the file.
+    size_t levels() const { return levels_; }
+
+    /// Returns the number of grid points of each level.
+    size_t points() const { return points_; }
+
+    /**
+     * @brief Copies the thresholds of a level at the given grid points.
+     *
+     * @param globalIndices The (1-based) global indices of the grid points.
+     * @param level The (0-based) level to read.
+     *
+     * @return The thresholds, `result[k]` being the threshold at `globalIndices[k]`.
+     *
+     * @throws eckit::BadValue if the level or one of the global indices is out of the file range.
+     */
+    std::vector<float> slice(const std::vector<atlas::gidx_t>& globalIndices, size_t level) const;
+
+    /**
+     * @brief Copies the thresholds of a level at points of a function space.
+     *
+     * @param fs The function space of the model fields.
+     * @param points The indices of the points in the function space.
+     * @param level The (0-based) level to read.
+     *
+     * @return The thresholds, `result[k]` being the threshold at `points[k]`.
+     *
+     * @throws eckit::BadValue if the file does not cover the points, e.g. if it was made for another grid.
+     */
+    std::vector<float> slice(const atlas::FunctionSpace& fs, const std::vector<atlas::idx_t>& points,
+                             size_t level) const;
+
+    /**
+     * @brief Writes a threshold file, e.g. to convert a climatology computed offline.
+     *
+     * @param path The path of the file to write.
+     * @param levels The number of levels.
+     * @param points The number of grid points of each level.
+     * @param values The `levels * points` thresholds, level by level, ordered by global index within a level.
+     *
+     * @throws eckit::BadValue if the number of values does not match.
+     * @throws eckit::CantOpenFile if the file cannot be opened.
+     */
+    static void write(const std::string& path, uint32_t levels, uint64_t points, const std::vector<float>& values);
+
+private:
+    std::string path_;
+    void* mapping_       = nullptr;
+    size_t size_         = 0;
+    size_t levels_       = 0;
+    size_t points_       = 0;
+    const float* values_ = nullptr;  ///< First threshold of the first level, within the mapping
+};
+
+}  // namespace ThresholdUtils
@@ -0,0 +1,128 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <sys/stat.h>
+#include <chrono>
+
+#include "eckit/config/YAMLConfiguration.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/log/Log.h"
+
+#include "threshold_overrides.h"
+
+namespace ExtremeEventPlugin {
+
+namespace {
+
+/// Returns a string identifying the version of the file on disk, empty if it does not exist.
+std::string fileStamp(const std::string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return "";
+    }
+#ifdef __APPLE__
+    const auto& mtime = info.st_mtimespec;
+#else
+    const auto& mtime = info.st_mtim;
+#endif
+    return std::to_string(mtime.tv_sec) + "." + std::to_string(mtime.tv_nsec) + ":" + std::to_string(info.st_size);
+}
+
+/// Returns the version of the overrides read from a file stamp, a FNV-1a hash so that it is the same on all the ranks.
+uint64_t stampVersion(const std::string& stamp) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char c : stamp) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+}  // namespace
+
+ThresholdOverrides ThresholdOverrides::read(const std::string& path, uint64_t version) {
+    ThresholdOverrides overrides;
+    overrides.version = version;
+    if (fileStamp(path).empty()) {
+        return overrides;
+    }
+    eckit::YAMLConfiguration file{eckit::PathName(path)};
+    if (!file.has("events")) {
+        return overrides;
+    }
+    for (const auto& event : file.getSubConfigurations("events")) {
+        if (!event.has("name")) {
+            throw eckit::BadValue("An event of the threshold override file '" + path + "' has no name", Here());
+        }
+        auto& instances = overrides.events[event.getString("name")];
+        for (const auto& instance : event.getSubConfigurations("instances")) {
+            if (!instance.has("instance") || instance.getInt("instance") < 0) {
+                throw eckit::BadValue("The overridden instances of '" + event.getString("name") +
+                                          "' require their 'instance' index, from 0",
+                                      Here());
+            }
+            instances.push_back(instance);
+        }
+    }
+    return overrides;
+}
+
+ThresholdOverrideWatcher::ThresholdOverrideWatcher(const std::string& path, double pollInterval) :
+    path_(path), pollInterval_(pollInterval) {
+    if (pollInterval_ <= 0.0) {
+        throw eckit::BadParameter("The threshold override 'poll_interval' must be positive", Here());
+    }
+    // The first read is done before the first step, so the initial overrides apply from the start
+    reload();
+    thread_ = std::thread(&ThresholdOverrideWatcher::watch, this);
+}
+
+ThresholdOverrideWatcher::~ThresholdOverrideWatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wakeUp_.notify_all();
+    thread_.join();
+}
+
+void ThresholdOverrideWatcher::watch() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wakeUp_.wait_for(lock, std::chrono::duration<double>(pollInterval_), [this] { return stop_; });
+        if (stop_) {
+            return;
+        }
+        // The file is read without holding the lock, the model thread never takes it anyway
+        lock.unlock();
+        reload();
+        lock.lock();
+    }
+}
+
+void ThresholdOverrideWatcher::reload() {
+    const std::string stamp = fileStamp(path_);
+    if (stamp == stamp_) {
+        return;
+    }
+    stamp_ = stamp;
+    try {
+        auto overrides = std::make_unique<ThresholdOverrides>(ThresholdOverrides::read(path_, stampVersion(stamp)));
+        eckit::Log::info() << "Threshold overrides read from '" << path_ << "' (version " << overrides->version << ")"
+                           << std::endl;
+        published_.publish(std::move(overrides));
+    }
+    catch (const std::exception& e) {
+        eckit::Log::error() << "Invalid threshold override file '" << path_ << "', the previous overrides are kept: "
+                            << e.what() << std::endl;
+    }
+}
+
+}  // namespace ExtremeEventPlugin
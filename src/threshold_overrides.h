@@ -0,0 +1,99 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+
+#include "epoch_publisher.h"
+
+namespace ExtremeEventPlugin {
+
+/// Instance options overridden while the model runs, read from an override file.
+struct ThresholdOverrides {
+    uint64_t version = 0;  ///< Identifies the file read, the same on all the ranks reading the same file
+    /// Overridden instances of each event, by event name, each with its `instance` index in the configuration
+    std::map<std::string, std::vector<eckit::LocalConfiguration>> events;
+
+    /**
+     * @brief Reads an override file.
+     *
+     * The file is a YAML file with an `events` list, each event having a `name` and an `instances` list of the
+     * options to override, each with the `instance` index (from 0) in the event configuration. A missing file means
+     * that nothing is overridden.
+     *
+     * @throws eckit::BadValue if an event has no name or an instance has no valid `instance` index.
+     */
+    static ThresholdOverrides read(const std::string& path, uint64_t version);
+};
+
+/**
+ * @class ThresholdOverrideWatcher
+ * @brief Watches an override file from a background thread, and hands its content over to the model thread.
+ *
+ * The file is read and parsed by the background thread when its modification time or size changes, so that the
+ * model step never waits for the file system. The parsed overrides are published through an `EpochPublisher`, and
+ * the model thread picks the latest ones up with `latest` without locking. A file that cannot be parsed is logged and
+ * ignored, the previous overrides stay in place until it is fixed. The version of the overrides is derived from the
+ * modification time and size of the file, so that the ranks can check that they read the same file.
+ */
+class ThresholdOverrideWatcher {
+public:
+    /**
+     * @brief Reads the override file once, then starts watching it.
+     *
+     * @param path The path of the override file, which does not need to exist yet.
+     * @param pollInterval The time between two checks of the file, in seconds.
+     *
+     * @throws eckit::BadParameter if the poll interval is not positive.
+     */
+    ThresholdOverrideWatcher(const std::string& path, double pollInterval);
+
+    /// Stops the watching thread.
+    ~ThresholdOverrideWatcher();
+
+    ThresholdOverrideWatcher(const ThresholdOverrideWatcher&)            = delete;
+    ThresholdOverrideWatcher& operator=(const ThresholdOverrideWatcher&) = delete;
+
+    /**
+     * @brief Returns the latest overrides read, `nullptr` if the file was never read successfully.
+     *
+     * The overrides stay valid until the next call. Only one thread, the model thread, may call it.
+     */
+    const ThresholdOverrides* latest() { return published_.acquire(); }
+
+private:
+    std::string path_;
+    double pollInterval_;
+    EpochPublisher<ThresholdOverrides> published_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeUp_;
+    bool stop_ = false;
+
+    std::string stamp_ = "?";  ///< Modification time and size of the file when it was last read, "?" before
+    std::thread thread_;
+
+    /// Watching thread loop.
+    void watch();
+
+    /// Reads and publishes the file if it changed since it was last read.
+    void reload();
+};
+
+}  // namespace ExtremeEventPlugin
@@ -0,0 +1,207 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+#include "atlas/array.h"
+#include "atlas/field.h"
+#include "atlas/functionspace.h"
+#include "atlas/library.h"
+#include "atlas/parallel/mpi/mpi.h"
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/config/YAMLConfiguration.h"
+#include "eckit/exception/Exceptions.h"
+
+#include "ee_plugin.h"
+#include "snapshot.h"
+
+using ExtremeEventPlugin::SnapshotReader;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Returns the plugin core configuration, from a Plume configuration or from a core configuration file.
+eckit::LocalConfiguration coreConfig(const std::string& path) {
+    eckit::YAMLConfiguration yaml{eckit::PathName(path)};
+    if (!yaml.has("plugins")) {
+        return eckit::LocalConfiguration(yaml);
+    }
+    for (const auto& plugin : yaml.getSubConfigurations("plugins")) {
+        if (plugin.getString("name") == "EEPlugin") {
+            return plugin.getSubConfiguration("core-config");
+        }
+    }
+    throw eckit::BadValue("No 'EEPlugin' in the plugins of '" + path + "'", Here());
+}
+
+/// Creates the replay function space from the recorded partition, and the fields in their recorded precision.
+std::vector<atlas::Field> createFields(const ExtremeEventPlugin::SnapshotGeometry& geometry) {
+    const auto points = static_cast<atlas::idx_t>(geometry.points());
+    atlas::Field lonlat("lonlat", atlas::array::make_datatype<double>(), atlas::array::make_shape(points, 2));
+    atlas::Field ghost("ghost", atlas::array::make_datatype<int>(), atlas::array::make_shape(points));
+    auto lonlatView = atlas::array::make_view<double, 2>(lonlat);
+    auto ghostView  = atlas::array::make_view<int, 1>(ghost);
+    for (atlas::idx_t j = 0; j < points; ++j) {
+        lonlatView(j, 0) = geometry.lonlat[2 * j];
+        lonlatView(j, 1) = geometry.lonlat[2 * j + 1];
+        ghostView(j)     = geometry.ghost[j];
+    }
+    atlas::functionspace::PointCloud fs(lonlat, ghost);
+    // The global indices are used by the threshold files and the local HEALPix mesh
+    auto gidx = atlas::array::make_view<atlas::gidx_t, 1>(fs.global_index());
+    for (atlas::idx_t j = 0; j < points; ++j) {
+        gidx(j) = geometry.globalIndex[j];
+    }
+
+    std::vector<atlas::Field> fields;
+    for (const auto& info : geometry.fields) {
+        atlas::util::Config config;
+        config.set("name", info.name).set("levels", static_cast<int>(info.levels));
+        fields.push_back(info.doublePrecision ? fs.createField<double>(config) : fs.createField<float>(config));
+    }
+    return fields;
+}
+
+double maxOverRanks(double value) {
+    atlas::mpi::comm().allReduceInPlace(value, eckit::mpi::max());
+    return value;
+}
+
+}  // namespace
+
+/**
+ * Replays the steps recorded by the plugin when `record` is configured through the plugin core, without the model,
+ * and reports the time and throughput of each step. The detections run as in the model, notifications and results
+ * files included, as configured in the given configuration. The replay must run on as many ranks as the recording,
+ * each rank reading the snapshot file of its partition. An ensemble recording is replayed with all its members under
+ * a single `mpirun`, the world communicator being split into `members` consecutive blocks of ranks like the model does.
+ *
+ * Usage: ee_replay --config=<plume_or_core_config.yml> [--members=<N>] <snapshot_file>
+ *
+ * The snapshot file is the configured `record` path, the member and rank suffixes are added as when recording.
+ */
+int main(int argc, char** argv) {
+    std::string configPath;
+    std::string recordPath;
+    int members = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--config=", 9) == 0) {
+            configPath = argv[i] + 9;
+        }
+        else if (std::strncmp(argv[i], "--members=", 10) == 0) {
+            members = std::atoi(argv[i] + 10);
+        }
+        else {
+            recordPath = argv[i];
+        }
+    }
+    if (configPath.empty() || recordPath.empty() || members < 0) {
+        std::cerr << "Usage: " << argv[0] << " --config=<plume_or_core_config.yml> [--members=<N>] <snapshot_file>"
+                  << std::endl;
+        return 1;
+    }
+
+    atlas::initialize();
+    int status = 0;
+    try {
+        // Each member replays its own snapshots on its own communicator, as the model runs an ensemble
+        int member = -1;
+        if (members > 0) {
+            const auto& world = atlas::mpi::comm("world");
+            if (world.size() % members != 0) {
+                throw eckit::BadValue("The " + std::to_string(world.size()) + " ranks cannot be split into " +
+                                          std::to_string(members) + " members",
+                                      Here());
+            }
+            const auto ranksPerMember = world.size() / members;
+            member                    = static_cast<int>(world.rank() / ranksPerMember);
+            world.split(member, "ee_replay_member");
+            eckit::mpi::setCommDefault("ee_replay_member");
+        }
+        const auto& comm = atlas::mpi::comm();
+        const bool root  = comm.rank() == 0;
+        SnapshotReader reader(ExtremeEventPlugin::snapshotPath(recordPath, member));
+        const auto& geometry = reader.geometry();
+        auto fields          = createFields(geometry);
+
+        // The parameters are read by the plugin through the pointers, they are updated in place at each step
+        int nstep    = 0;
+        double tstep = 0.0;
+        int nflevg   = geometry.nflevg;
+        plume::data::ModelData modelData;
+        modelData.provideInt("NSTEP", &nstep);
+        modelData.provideDouble("TSTEP", &tstep);
+        modelData.provideInt("NFLEVG", &nflevg);
+        for (auto& field : fields) {
+            modelData.provideAtlasFieldShared(field.name(), field);
+        }
+
+        // Owned points processed by all the partitions at each step
+        double points = static_cast<double>(std::count(geometry.ghost.begin(), geometry.ghost.end(), 0));
+        comm.allReduceInPlace(points, eckit::mpi::sum());
+
+        auto config = coreConfig(configPath);
+        // Replaying must not overwrite the snapshots being read
+        config.set("record", "");
+        ExtremeEventPlugin::EEPluginCore core(config);
+        core.grabData(modelData);
+
+        // The first step is read before the setup, like the model data is offered before the plugin setup
+        int hasStep = reader.next(nstep, tstep, fields) ? 1 : 0;
+        comm.allReduceInPlace(hasStep, eckit::mpi::min());
+        auto start = Clock::now();
+        core.setup();
+        double setupTime = maxOverRanks(std::chrono::duration<double>(Clock::now() - start).count());
+        if (root) {
+            std::cout << std::fixed << std::setprecision(3) << "setup: " << setupTime * 1e3 << " ms, "
+                      << static_cast<size_t>(points) << " points, " << fields.size() << " fields, " << comm.size()
+                      << " partitions" << std::endl;
+        }
+
+        size_t steps     = 0;
+        double totalTime = 0.0;
+        double minTime   = std::numeric_limits<double>::max();
+        double maxTime   = 0.0;
+        while (hasStep) {
+            start = Clock::now();
+            core.run();
+            // The slowest partition sets the time of the step in the model
+            const double stepTime = maxOverRanks(std::chrono::duration<double>(Clock::now() - start).count());
+            totalTime += stepTime;
+            minTime = std::min(minTime, stepTime);
+            maxTime = std::max(maxTime, stepTime);
+            ++steps;
+            if (root) {
+                std::cout << "step " << nstep << ": " << stepTime * 1e3 << " ms, " << points / stepTime * 1e-6
+                          << " Mpoints/s" << std::endl;
+            }
+            hasStep = reader.next(nstep, tstep, fields) ? 1 : 0;
+            comm.allReduceInPlace(hasStep, eckit::mpi::min());
+        }
+        if (root && steps > 0) {
+            std::cout << steps << " steps: mean " << totalTime / steps * 1e3 << " ms, min " << minTime * 1e3
+                      << " ms, max " << maxTime * 1e3 << " ms, " << points * steps / totalTime * 1e-6 << " Mpoints/s"
+                      << std::endl;
+        }
+    }
+    catch (const eckit::Exception& e) {
+        std::cerr << e.what() << std::endl;
+        status = 1;
+    }
+    atlas::finalize();
+    return status;
+}
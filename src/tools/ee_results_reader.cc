@@ -0,0 +1,67 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <cstring>
+#include <iostream>
+
+#include "eckit/exception/Exceptions.h"
+
+#include "results_sink.h"
+
+using ExtremeEventPlugin::ResultsSink;
+
+/**
+ * Prints the content of extreme event results files written by the plugin when `results_file` is configured.
+ *
+ * Usage: ee_results_reader [--polygons] <results_file>...
+ */
+int main(int argc, char** argv) {
+    bool printPolygons = false;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--polygons") == 0) {
+            printPolygons = true;
+        }
+        else {
+            paths.emplace_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [--polygons] <results_file>..." << std::endl;
+        return 1;
+    }
+
+    try {
+        for (const auto& path : paths) {
+            for (const auto& record : ResultsSink::read(path)) {
+                std::cout << "step=" << record.step << " event=" << record.event << " instance=" << record.instance
+                          << " param=" << record.param << " levtype=" << record.levtype
+                          << " levelist=" << record.levelist << " cells=" << record.cells.size()
+                          << " polygons=" << record.polygons.size() << " description=\"" << record.description
+                          << "\"\n";
+                if (!printPolygons) {
+                    continue;
+                }
+                for (const auto& polygon : record.polygons) {
+                    std::cout << "  polygon=";
+                    for (size_t v = 0; v < polygon.size(); ++v) {
+                        std::cout << (v ? "," : "") << polygon[v].lat() << "," << polygon[v].lon();
+                    }
+                    std::cout << "\n";
+                }
+            }
+        }
+    }
+    catch (const eckit::Exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
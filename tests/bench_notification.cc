@@ -0,0 +1,189 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "atlas/util/Point.h"
+
+#include "mock_aviso_server.h"
+#include "notification.h"
+#include "notification_dispatcher.h"
+
+/*
+ * Notification load benchmark.
+ *
+ * Drives the Aviso notification path against a local mock server, emulating model steps that each produce a burst
+ * of notifications, and reports the throughput, the latency percentiles of a single notification and the time added
+ * to each model step. It only uses the loopback interface so it can run in CI without network access.
+ *
+ * Options (--key=value): steps, notifications (per step), latency-ms, error-rate, max-rps (server throttling),
+ * max-step-ms (fails if the mean time added to a step exceeds it, 0 to disable), dispatcher (1 to queue the
+ * notifications to the background dispatcher as the plugin does, instead of sending them from the step; the
+ * latencies are then the queuing times, and the run fails unless every notification is eventually delivered).
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double option(int argc, char** argv, const std::string& key, double defaultValue) {
+    const std::string prefix = "--" + key + "=";
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], prefix.c_str(), prefix.size()) == 0) {
+            return std::atof(argv[i] + prefix.size());
+        }
+    }
+    return defaultValue;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t idx = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int steps          = static_cast<int>(option(argc, argv, "steps", 5));
+    const int notifications  = static_cast<int>(option(argc, argv, "notifications", 50));
+    const double maxStepMs   = option(argc, argv, "max-step-ms", 0.0);
+    const bool useDispatcher = option(argc, argv, "dispatcher", 0) != 0;
+    test::MockAvisoServer::Options serverOptions;
+    serverOptions.latencyMs            = option(argc, argv, "latency-ms", 1.0);
+    serverOptions.errorRate            = option(argc, argv, "error-rate", 0.0);
+    serverOptions.maxRequestsPerSecond = option(argc, argv, "max-rps", 0.0);
+
+    std::signal(SIGPIPE, SIG_IGN);
+    // The Aviso schema is read from the environment, and the notifications must actually be posted
+    for (const auto& [key, value] : std::map<std::string, std::string>{
+             {"CLASS", "test"}, {"TYPE", "test"}, {"EXPVER", "0001"}, {"DATE", "20250101"}, {"TIME", "0000"}}) {
+        setenv(key.c_str(), value.c_str(), 0);
+    }
+    setenv("PLUME_PLUGIN_DEV", "0", 1);
+
+    test::MockAvisoServer server(serverOptions);
+    ExtremeEventPlugin::AvisoNotificationHandler handler(server.url(), "/api/v1/notification");
+
+    const std::string payload = R"({"step":"1h","description":"Extremely strong wind","param":"u/v","levtype":"ml"})";
+    const std::vector<atlas::PointLonLat> polygon = {atlas::PointLonLat{250.3, 16.9}, atlas::PointLonLat{247.4, 14.4},
+                                                     atlas::PointLonLat{253.1, 14.4}, atlas::PointLonLat{250.3, 12.0},
+                                                     atlas::PointLonLat{250.3, 16.9}};
+
+    const std::string journalPath = "bench_notification.journal";
+    std::unique_ptr<ExtremeEventPlugin::NotificationDispatcher> dispatcher;
+    if (useDispatcher) {
+        // Short delays so that the failed notifications are retried within the benchmark
+        ExtremeEventPlugin::RetryPolicy policy;
+        policy.initialBackoff = 0.01;
+        policy.maxBackoff     = 0.1;
+        policy.cooldown       = 0.1;
+        std::remove(journalPath.c_str());
+        dispatcher = std::make_unique<ExtremeEventPlugin::NotificationDispatcher>(handler, journalPath, policy);
+    }
+
+    std::vector<double> latencies;
+    std::vector<double> stepTimes;
+    std::map<int, size_t> codes;
+    auto benchStart = Clock::now();
+    for (int step = 0; step < steps; ++step) {
+        auto stepStart = Clock::now();
+        for (int n = 0; n < notifications; ++n) {
+            auto start = Clock::now();
+            if (dispatcher) {
+                dispatcher->post(payload, polygon);
+            }
+            else {
+                int code = 0;
+                try {
+                    code = handler.send(payload, polygon);
+                }
+                catch (const std::exception&) {
+                    code = -1;
+                }
+                ++codes[code];
+            }
+            latencies.push_back(millisecondsSince(start));
+        }
+        stepTimes.push_back(millisecondsSince(stepStart));
+    }
+    const bool drained   = !dispatcher || dispatcher->drain(60.0);
+    const double totalMs = millisecondsSince(benchStart);
+
+    std::sort(latencies.begin(), latencies.end());
+    const double meanStepMs = std::accumulate(stepTimes.begin(), stepTimes.end(), 0.0) / stepTimes.size();
+    const auto counters     = server.counters();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Notification benchmark" << (dispatcher ? " (dispatcher)" : "") << ": " << steps << " steps x "
+              << notifications << " notifications, server latency " << serverOptions.latencyMs << " ms, error rate "
+              << serverOptions.errorRate << ", max rate " << serverOptions.maxRequestsPerSecond << " req/s"
+              << std::endl;
+    std::cout << "  throughput           : " << latencies.size() / (totalMs / 1000.0) << " notifications/s"
+              << std::endl;
+    std::cout << "  latency p50/p90/p99  : " << percentile(latencies, 50) << " / " << percentile(latencies, 90)
+              << " / " << percentile(latencies, 99) << " ms (max " << latencies.back() << " ms)" << std::endl;
+    std::cout << "  added step time      : " << meanStepMs << " ms mean, "
+              << *std::max_element(stepTimes.begin(), stepTimes.end()) << " ms max" << std::endl;
+    if (dispatcher) {
+        const auto stats = dispatcher->stats();
+        std::cout << "  dispatcher           : delivered " << stats.delivered << ", failed attempts " << stats.failures
+                  << ", journaled " << stats.journaled << ", outstanding " << stats.outstanding << std::endl;
+    }
+    else {
+        std::cout << "  response codes       :";
+        for (const auto& [code, count] : codes) {
+            std::cout << " " << code << "=" << count;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "  server               : received " << counters.received << ", ok " << counters.succeeded
+              << ", errors " << counters.failed << ", throttled " << counters.throttled << std::endl;
+
+    int status = 0;
+    if (dispatcher) {
+        // Every notification is delivered in the end, whatever the error rate
+        if (!drained || counters.succeeded != latencies.size()) {
+            std::cerr << "Only " << counters.succeeded << " of " << latencies.size() << " notifications were delivered"
+                      << std::endl;
+            status = 1;
+        }
+        dispatcher.reset();
+        std::remove(journalPath.c_str());
+    }
+    else if (counters.received != latencies.size()) {
+        std::cerr << "The server received " << counters.received << " of " << latencies.size() << " notifications"
+                  << std::endl;
+        status = 1;
+    }
+    if (maxStepMs > 0 && meanStepMs > maxStepMs) {
+        std::cerr << "The mean added step time " << meanStepMs << " ms exceeds " << maxStepMs << " ms" << std::endl;
+        status = 1;
+    }
+    return status;
+}
@@ -0,0 +1,313 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <sys/resource.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "atlas/array.h"
+#include "atlas/field.h"
+#include "atlas/functionspace.h"
+#include "atlas/grid.h"
+#include "atlas/library.h"
+#include "atlas/parallel/mpi/mpi.h"
+#include "eckit/config/LocalConfiguration.h"
+
+#include "ee_plugin.h"
+#include "results_sink.h"
+
+/*
+ * Plugin scaling benchmark.
+ *
+ * Runs the plugin core on synthetic wind fields (moving wind bands, so that the events fire at every step) on a given
+ * grid and on the ranks it is started with, and reports the setup time, the step time and the memory high-water mark
+ * of each rank, and the number of notifications (polygons) the run would send. A line is appended to a CSV report,
+ * so that running it on a matrix of grids and rank counts gives the strong (same grid, more ranks) and weak (grid
+ * growing with the ranks) scaling of the plugin.
+ *
+ * Options (--key=value): grid, steps, levels, healpix-res, healpix-mesh (global or local), report (CSV file to append
+ * to), baseline (CSV report of a reference run), tolerance (fails if the setup time, mean step time or memory exceed
+ * the baseline run on the same grid and ranks by more than this fraction), max-setup-s and max-step-ms (fail if the
+ * slowest rank exceeds them, 0 to disable).
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string option(int argc, char** argv, const std::string& key, const std::string& defaultValue) {
+    const std::string prefix = "--" + key + "=";
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], prefix.c_str(), prefix.size()) == 0) {
+            return argv[i] + prefix.size();
+        }
+    }
+    return defaultValue;
+}
+
+double option(int argc, char** argv, const std::string& key, double defaultValue) {
+    const std::string value = option(argc, argv, key, std::string());
+    return value.empty() ? defaultValue : std::atof(value.c_str());
+}
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/// Memory high-water mark of the process in MiB.
+double memoryHighWaterMark() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+    return usage.ru_maxrss / 1024.0;
+#endif
+}
+
+/// Minimum, mean and maximum of a value over the ranks.
+struct RankStats {
+    double min;
+    double mean;
+    double max;
+};
+
+RankStats overRanks(double value) {
+    const auto& comm = atlas::mpi::comm();
+    std::vector<double> values(comm.size());
+    comm.allGather(value, values.begin(), values.end());
+    return {*std::min_element(values.begin(), values.end()),
+            std::accumulate(values.begin(), values.end(), 0.0) / values.size(),
+            *std::max_element(values.begin(), values.end())};
+}
+
+eckit::LocalConfiguration param(const std::string& name) {
+    eckit::LocalConfiguration conf;
+    conf.set("name", name);
+    conf.set("type", "atlas_field");
+    return conf;
+}
+
+/// Plugin configuration with an `extreme_wind` event at the surface and on a model level, and a `wind_power` event.
+eckit::LocalConfiguration pluginConfig(int healpixRes, const std::string& healpixMesh, const std::string& results) {
+    std::vector<eckit::LocalConfiguration> params = {param("u"), param("v"), param("100u"), param("100v")};
+
+    eckit::LocalConfiguration strongWind;
+    strongWind.set("lower_bound", 25.0);
+    strongWind.set("upper_bound", 0.0);
+    strongWind.set("description", "Strong wind");
+    eckit::LocalConfiguration strongWindLevel(strongWind);
+    strongWindLevel.set("model_levels", std::vector<int>{1});
+    eckit::LocalConfiguration extremeWind;
+    extremeWind.set("name", "extreme_wind");
+    extremeWind.set("required_params", params);
+    extremeWind.set("instances", std::vector<eckit::LocalConfiguration>{strongWind, strongWindLevel});
+
+    eckit::LocalConfiguration curve;
+    curve.set("cut_in", 3.0);
+    curve.set("rated_speed", 12.0);
+    curve.set("cut_out", 25.0);
+    eckit::LocalConfiguration loss;
+    loss.set("power_curve", curve);
+    loss.set("criterion", "capacity_below");
+    loss.set("threshold", 0.05);
+    loss.set("description", "Wind power production loss");
+    eckit::LocalConfiguration windPower;
+    windPower.set("name", "wind_power");
+    windPower.set("required_params", params);
+    windPower.set("instances", std::vector<eckit::LocalConfiguration>{loss});
+
+    eckit::LocalConfiguration conf;
+    conf.set("healpix_res", healpixRes);
+    conf.set("healpix_mesh", healpixMesh);
+    conf.set("enable_notification", false);
+    conf.set("results_file", results);
+    conf.set("events", std::vector<eckit::LocalConfiguration>{extremeWind, windPower});
+    return conf;
+}
+
+/// Wind bands moving eastwards with the steps, reaching about 40 m/s.
+void fillWind(const atlas::FunctionSpace& fs, int step, atlas::Field& u, atlas::Field& v) {
+    auto lonlat = atlas::array::make_view<double, 2>(fs.lonlat());
+    auto uView  = atlas::array::make_view<double, 2>(u);
+    auto vView  = atlas::array::make_view<double, 2>(v);
+    for (atlas::idx_t j = 0; j < fs.size(); ++j) {
+        const double lon = (lonlat(j, 0) + 5.0 * step) * M_PI / 180.0;
+        const double lat = lonlat(j, 1) * M_PI / 180.0;
+        for (atlas::idx_t level = 0; level < uView.shape(1); ++level) {
+            const double scale = 1.0 + 0.1 * level;
+            uView(j, level)    = 30.0 * scale * std::sin(3.0 * lon) * std::cos(lat);
+            vView(j, level)    = 30.0 * scale * std::cos(3.0 * lon) * std::cos(2.0 * lat);
+        }
+    }
+}
+
+/// Returns the baseline run on the same grid and ranks, as the columns of its report line, or nothing.
+std::vector<std::string> baselineRun(const std::string& path, const std::string& grid, size_t ranks) {
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::vector<std::string> columns;
+        std::stringstream columnStream(line);
+        std::string column;
+        while (std::getline(columnStream, column, ',')) {
+            columns.push_back(column);
+        }
+        if (columns.size() >= 10 && columns[0] == grid && columns[1] == std::to_string(ranks)) {
+            return columns;
+        }
+    }
+    return {};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::string gridName    = option(argc, argv, "grid", std::string("N80"));
+    const int steps               = std::max(1, static_cast<int>(option(argc, argv, "steps", 3)));
+    const int levels              = std::max(1, static_cast<int>(option(argc, argv, "levels", 2)));
+    const int healpixRes          = static_cast<int>(option(argc, argv, "healpix-res", 32));
+    const std::string healpixMesh = option(argc, argv, "healpix-mesh", std::string("global"));
+    const std::string report      = option(argc, argv, "report", std::string());
+    const std::string baseline    = option(argc, argv, "baseline", std::string());
+    const double tolerance        = option(argc, argv, "tolerance", 0.25);
+    const double maxSetupS        = option(argc, argv, "max-setup-s", 0.0);
+    const double maxStepMs        = option(argc, argv, "max-step-ms", 0.0);
+
+    atlas::initialize();
+    const auto& comm  = atlas::mpi::comm();
+    const bool root   = comm.rank() == 0;
+    const auto ranks  = comm.size();
+    const auto memory = memoryHighWaterMark();
+
+    // Fields distributed with a halo, like the model fields
+    atlas::Grid grid(gridName);
+    atlas::util::Config halo = atlas::option::halo(1);
+    atlas::functionspace::StructuredColumns fs(grid, halo);
+    atlas::util::Config config;
+    std::vector<atlas::Field> fields;
+    for (const std::string name : {"u", "v", "100u", "100v"}) {
+        // The 100 m wind is a surface field
+        config.set("name", name).set("levels", name.size() == 1 ? levels : 1);
+        fields.push_back(fs.createField<double>(config));
+    }
+
+    int nstep    = 0;
+    double tstep = 450.0;
+    int nflevg   = levels;
+    plume::data::ModelData modelData;
+    modelData.provideInt("NSTEP", &nstep);
+    modelData.provideDouble("TSTEP", &tstep);
+    modelData.provideInt("NFLEVG", &nflevg);
+    for (auto& field : fields) {
+        modelData.provideAtlasFieldShared(field.name(), field);
+    }
+
+    const std::string results     = "ee_scaling_" + gridName + "_" + std::to_string(ranks) + ".bin";
+    const std::string rankResults = ranks > 1 ? results + "." + std::to_string(comm.rank()) : results;
+    std::remove(rankResults.c_str());
+    double setupTime = 0.0;
+    std::vector<double> stepTimes;
+    {
+        ExtremeEventPlugin::EEPluginCore core(pluginConfig(healpixRes, healpixMesh, results));
+        core.grabData(modelData);
+        fillWind(fs, nstep, fields[0], fields[1]);
+        fillWind(fs, nstep, fields[2], fields[3]);
+        comm.barrier();
+        auto start = Clock::now();
+        core.setup();
+        setupTime = secondsSince(start);
+        for (nstep = 1; nstep <= steps; ++nstep) {
+            fillWind(fs, nstep, fields[0], fields[1]);
+            fillWind(fs, nstep, fields[2], fields[3]);
+            comm.barrier();
+            start = Clock::now();
+            core.run();
+            stepTimes.push_back(secondsSince(start));
+        }
+    }
+
+    size_t notifications = 0;
+    for (const auto& record : ExtremeEventPlugin::ResultsSink::read(rankResults)) {
+        notifications += record.polygons.size();
+    }
+    std::remove(rankResults.c_str());
+    comm.allReduceInPlace(notifications, eckit::mpi::sum());
+
+    double owned = static_cast<double>(fs.sizeOwned());
+    comm.allReduceInPlace(owned, eckit::mpi::sum());
+    const auto setup    = overRanks(setupTime);
+    const auto step     = overRanks(std::accumulate(stepTimes.begin(), stepTimes.end(), 0.0) / steps);
+    const auto slowest  = overRanks(*std::max_element(stepTimes.begin(), stepTimes.end()));
+    const auto highMark = overRanks(memoryHighWaterMark());
+    const auto baseMark = overRanks(memory);
+
+    int status = 0;
+    if (root) {
+        std::cout << std::fixed << std::setprecision(3) << gridName << " on " << ranks << " ranks, "
+                  << static_cast<size_t>(owned) << " points, " << steps << " steps\n"
+                  << "  setup: min " << setup.min << " s, mean " << setup.mean << " s, max " << setup.max
+                  << " s\n"
+                  << "  step: min " << step.min * 1e3 << " ms, mean " << step.mean * 1e3 << " ms, max "
+                  << step.max * 1e3 << " ms, slowest step " << slowest.max * 1e3 << " ms\n"
+                  << "  memory: max " << highMark.max << " MiB per rank, " << highMark.max - baseMark.max
+                  << " MiB above the start\n"
+                  << "  notifications: " << notifications << std::endl;
+
+        if (!report.empty()) {
+            const bool newReport = !std::ifstream(report).good();
+            std::ofstream out(report, std::ios::app);
+            // The step time of a rank is its mean over the steps, the report keeps the slowest rank, as for the
+            // setup, and the slowest single step of all the ranks
+            if (newReport) {
+                out << "grid,ranks,points,steps,setup_max_s,setup_mean_s,step_mean_max_ms,step_max_ms,memory_max_mib,"
+                    << "notifications\n";
+            }
+            out << std::fixed << std::setprecision(3) << gridName << "," << ranks << ","
+                << static_cast<size_t>(owned) << "," << steps << "," << setup.max << "," << setup.mean << ","
+                << step.max * 1e3 << "," << slowest.max * 1e3 << "," << highMark.max << "," << notifications
+                << "\n";
+        }
+
+        auto check = [&](const std::string& what, double value, double limit) {
+            if (limit > 0.0 && value > limit) {
+                std::cerr << "Regression: " << what << " " << value << " exceeds " << limit << std::endl;
+                status = 1;
+            }
+        };
+        check("setup time (s)", setup.max, maxSetupS);
+        check("step time (ms)", step.max * 1e3, maxStepMs);
+        if (!baseline.empty()) {
+            auto reference = baselineRun(baseline, gridName, ranks);
+            if (reference.empty()) {
+                std::cout << "No baseline run for " << gridName << " on " << ranks << " ranks" << std::endl;
+            }
+            else {
+                check("setup time (s)", setup.max, std::atof(reference[4].c_str()) * (1.0 + tolerance));
+                check("step time (ms)", step.max * 1e3, std::atof(reference[6].c_str()) * (1.0 + tolerance));
+                check("memory (MiB)", highMark.max, std::atof(reference[8].c_str()) * (1.0 + tolerance));
+            }
+        }
+    }
+    comm.broadcast(status, 0);
+    atlas::finalize();
+    return status;
+}
@@ -0,0 +1,127 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ee_registry/power_curve.h"
+#include "ee_registry/wind_kernels.h"
+
+/*
+ * Wind power kernel benchmark.
+ *
+ * Compares the throughput of the wind magnitude kernel alone (what `extreme_wind` runs) with the magnitude followed
+ * by the power curve lookup and the capacity factor selection (what `wind_power` runs), in single and double
+ * precision, on random winds at a random subset of the points of a single level field.
+ *
+ * Options (--key=value): points, repeats, max-ratio (fails if the wind power kernels are more than this factor slower
+ * than the magnitude kernel alone, 0 to disable).
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double option(int argc, char** argv, const std::string& key, double defaultValue) {
+    const std::string prefix = "--" + key + "=";
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], prefix.c_str(), prefix.size()) == 0) {
+            return std::atof(argv[i] + prefix.size());
+        }
+    }
+    return defaultValue;
+}
+
+/// Returns the best time in nanoseconds per point of a kernel over the repeats.
+template <typename Kernel>
+double bestTime(int repeats, atlas::idx_t points, Kernel&& kernel) {
+    double best = std::numeric_limits<double>::max();
+    for (int r = 0; r < repeats; ++r) {
+        auto start = Clock::now();
+        kernel();
+        best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+    return best / points;
+}
+
+/// Benchmarks the kernels for a value type, returns the slowdown of the wind power kernels.
+template <typename T>
+double run(const std::string& name, atlas::idx_t nbPoints, int repeats) {
+    // Two levels, so that the points are read with a stride as in the model fields
+    const atlas::idx_t stride = 2;
+    std::mt19937 generator(42);
+    std::normal_distribution<T> wind(T(0), T(10));
+    std::vector<T> u(nbPoints * stride), v(nbPoints * stride);
+    for (atlas::idx_t k = 0; k < nbPoints * stride; ++k) {
+        u[k] = wind(generator);
+        v[k] = wind(generator);
+    }
+    // Points of interest of a region, sorted as in the events
+    std::vector<atlas::idx_t> points(nbPoints);
+    std::iota(points.begin(), points.end(), 0);
+    std::shuffle(points.begin(), points.end(), generator);
+    points.resize(nbPoints / 2);
+    std::sort(points.begin(), points.end());
+    const auto size = static_cast<atlas::idx_t>(points.size());
+
+    PowerCurve curve({3.0, 12.0, 25.0, 25.0}, {0.0, 1.0, 1.0, 0.0});
+    std::vector<T> magnitude(size);
+    std::vector<float> capacity(size);
+    std::vector<int> detected;
+    detected.reserve(size);
+
+    double magnitudeTime = bestTime(repeats, size, [&] {
+        WindKernels::windMagnitude(u.data(), v.data(), stride, points.data(), size, magnitude.data());
+    });
+    double curveTime = bestTime(repeats, size, [&] {
+        curve.capacityFactor(magnitude.data(), size, capacity.data());
+    });
+    double powerTime = bestTime(repeats, size, [&] {
+        detected.clear();
+        WindKernels::windMagnitude(u.data(), v.data(), stride, points.data(), size, magnitude.data());
+        curve.capacityFactor(magnitude.data(), size, capacity.data());
+        WindKernels::selectInInterval(capacity.data(), points.data(), size, std::numeric_limits<float>::lowest(),
+                                      0.05f, detected);
+    });
+
+    const double ratio = powerTime / magnitudeTime;
+    std::cout << std::fixed << std::setprecision(3) << name << ": " << size << " points, magnitude "
+              << magnitudeTime << " ns/point, power curve " << curveTime << " ns/point, magnitude + power curve + "
+              << "selection " << powerTime << " ns/point (x" << std::setprecision(2) << ratio << "), "
+              << detected.size() << " points below 5% capacity" << std::endl;
+    return ratio;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const auto nbPoints   = static_cast<atlas::idx_t>(option(argc, argv, "points", 2000000));
+    const int repeats     = std::max(1, static_cast<int>(option(argc, argv, "repeats", 10)));
+    const double maxRatio = option(argc, argv, "max-ratio", 0.0);
+
+    const double floatRatio  = run<float>("float ", nbPoints, repeats);
+    const double doubleRatio = run<double>("double", nbPoints, repeats);
+    const double worst       = std::max(floatRatio, doubleRatio);
+    if (maxRatio > 0.0 && worst > maxRatio) {
+        std::cerr << "The wind power kernels are " << worst << " times slower than the magnitude kernel, more than "
+                  << maxRatio << std::endl;
+        return 1;
+    }
+    return 0;
+}
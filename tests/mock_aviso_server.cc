@@ -0,0 +1,145 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+
+#include "eckit/exception/Exceptions.h"
+
+#include "mock_aviso_server.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // not available on macOS, users of the server ignore SIGPIPE instead
+#endif
+
+namespace test {
+
+MockAvisoServer::MockAvisoServer(const Options& options) :
+    options_(options), random_(options.seed), windowStart_(std::chrono::steady_clock::now()) {
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT(listenFd_ >= 0);
+    int reuse = 1;
+    ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port        = 0;
+    ASSERT(::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    ASSERT(::listen(listenFd_, 128) == 0);
+
+    socklen_t len = sizeof(addr);
+    ASSERT(::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+    port_ = ntohs(addr.sin_port);
+
+    thread_ = std::thread(&MockAvisoServer::serve, this);
+}
+
+MockAvisoServer::~MockAvisoServer() {
+    stop_ = true;
+    thread_.join();
+    ::close(listenFd_);
+}
+
+void MockAvisoServer::setOptions(const Options& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = options;
+}
+
+MockAvisoServer::Counters MockAvisoServer::counters() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counters_;
+}
+
+void MockAvisoServer::serve() {
+    pollfd pfd{listenFd_, POLLIN, 0};
+    while (!stop_) {
+        // Wake up regularly to check whether the server is stopping
+        if (::poll(&pfd, 1, 50) <= 0) {
+            continue;
+        }
+        int fd = ::accept(listenFd_, nullptr, nullptr);
+        if (fd >= 0) {
+            handle(fd);
+            ::close(fd);
+        }
+    }
+}
+
+void MockAvisoServer::handle(int fd) {
+    // Read the headers, then the body announced by Content-Length
+    std::string request;
+    char buffer[4096];
+    size_t headerEnd = std::string::npos;
+    while (headerEnd == std::string::npos) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            return;
+        }
+        request.append(buffer, n);
+        headerEnd = request.find("\r\n\r\n");
+    }
+    size_t contentLength = 0;
+    for (const char* key : {"Content-Length:", "content-length:"}) {
+        auto pos = request.find(key);
+        if (pos != std::string::npos && pos < headerEnd) {
+            contentLength = std::strtoul(request.c_str() + pos + std::strlen(key), nullptr, 10);
+        }
+    }
+    while (request.size() < headerEnd + 4 + contentLength) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            return;
+        }
+        request.append(buffer, n);
+    }
+
+    int code;
+    double latencyMs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++counters_.received;
+        latencyMs = options_.latencyMs;
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - windowStart_ >= std::chrono::seconds(1)) {
+            windowStart_    = now;
+            windowRequests_ = 0;
+        }
+        ++windowRequests_;
+
+        if (options_.maxRequestsPerSecond > 0 && windowRequests_ > options_.maxRequestsPerSecond) {
+            code = 429;
+            ++counters_.throttled;
+        }
+        else if (std::bernoulli_distribution(options_.errorRate)(random_)) {
+            code = 500;
+            ++counters_.failed;
+        }
+        else {
+            code = 200;
+            ++counters_.succeeded;
+        }
+    }
+    if (latencyMs > 0) {
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(latencyMs));
+    }
+
+    std::string response = "HTTP/1.1 " + std::to_string(code) + (code == 200 ? " OK" : " Error") +
+                           "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    ::send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+}
+
+}  // namespace test
@@ -0,0 +1,82 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace test {
+
+/**
+ * @class MockAvisoServer
+ * @brief Minimal HTTP server on the loopback interface standing in for an Aviso server in tests and benchmarks.
+ *
+ * Every request is answered with an empty body after a configurable latency. A fraction of the requests can be
+ * answered with a server error (500), and requests above a rate limit are answered with 429 (throttled).
+ * Connections are served one at a time and closed after each response.
+ */
+class MockAvisoServer {
+public:
+    struct Options {
+        double latencyMs            = 0.0;  ///< Time spent before answering each request
+        double errorRate            = 0.0;  ///< Fraction of the requests answered with a 500
+        double maxRequestsPerSecond = 0.0;  ///< Requests above this rate are answered with a 429, 0 means no limit
+        unsigned int seed           = 42;   ///< Seed of the error draws, for reproducible runs
+    };
+
+    struct Counters {
+        size_t received  = 0;
+        size_t succeeded = 0;
+        size_t failed    = 0;
+        size_t throttled = 0;
+    };
+
+    /// Starts listening on an ephemeral port of 127.0.0.1.
+    explicit MockAvisoServer(const Options& options);
+
+    /// Stops the server, pending connections are not served.
+    ~MockAvisoServer();
+
+    MockAvisoServer(const MockAvisoServer&)            = delete;
+    MockAvisoServer& operator=(const MockAvisoServer&) = delete;
+
+    /// Returns the base url of the server, to be used as the Aviso url.
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port_); }
+
+    /// Changes the behaviour of the server, e.g. to simulate an outage followed by a recovery.
+    void setOptions(const Options& options);
+
+    /// Returns the number of requests received so far, by outcome.
+    Counters counters() const;
+
+private:
+    int listenFd_;
+    int port_;
+    std::atomic<bool> stop_{false};
+
+    mutable std::mutex mutex_;
+    Options options_;
+    Counters counters_;
+    std::mt19937 random_;
+    std::chrono::steady_clock::time_point windowStart_;
+    size_t windowRequests_ = 0;
+
+    std::thread thread_;
+
+    void serve();
+    void handle(int fd);
+};
+
+}  // namespace test
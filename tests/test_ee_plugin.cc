@@ -9,18 +9,81 @@
  * does it submit to any jurisdiction.
  */
 #include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <csignal>
 #include <ctime>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
 
 #include "atlas/library.h"
 #include "atlas/util/Point.h"
 #include "eckit/config/LocalConfiguration.h"
 #include "eckit/testing/Test.h"
 
+#include "async_writer.h"
+#include "cell_aggregation.h"
 #include "ee_plugin.h"
+#include "ee_registry/power_curve.h"
+#include "ee_registry/quantile_sketch.h"
+#include "ee_registry/wind_kernels.h"
+#include "ensemble_reducer.h"
+#include "event_statistics.h"
+#include "event_tracker.h"
+#include "healpix_utils.h"
+#include "mock_aviso_server.h"
+#include "notification_dispatcher.h"
+#include "polygon_cache.h"
+#include "region_utils.h"
+#include "results_sink.h"
+#include "snapshot.h"
+#include "step_budget.h"
+#include "subscription_index.h"
+#include "threshold_field.h"
+#include "threshold_overrides.h"
 
 using namespace eckit::testing;
 
 namespace test {
+
+/// Returns the configuration of an event requiring the given Atlas fields, with the given instances.
+eckit::LocalConfiguration eventConfig(const std::vector<std::string>& fields,
+                                      const std::vector<eckit::LocalConfiguration>& instances) {
+    std::vector<eckit::LocalConfiguration> params;
+    for (const auto& name : fields) {
+        eckit::LocalConfiguration field;
+        field.set("name", name);
+        field.set("type", "atlas_field");
+        params.push_back(field);
+    }
+    eckit::LocalConfiguration config;
+    config.set("required_params", params);
+    config.set("instances", instances);
+    return config;
+}
+
+/// Returns a point cloud function space of the given points, none of them in the halo unless listed in `ghosts`.
+atlas::functionspace::PointCloud pointCloud(const std::vector<atlas::PointLonLat>& points,
+                                            const std::vector<int>& ghosts = {}) {
+    const auto size = static_cast<atlas::idx_t>(points.size());
+    atlas::Field lonlat("lonlat", atlas::array::make_datatype<double>(), atlas::array::make_shape(size, 2));
+    atlas::Field ghost("ghost", atlas::array::make_datatype<int>(), atlas::array::make_shape(size));
+    auto lonlatView = atlas::array::make_view<double, 2>(lonlat);
+    auto ghostView  = atlas::array::make_view<int, 1>(ghost);
+    for (atlas::idx_t j = 0; j < size; ++j) {
+        lonlatView(j, 0) = points[j].lon();
+        lonlatView(j, 1) = points[j].lat();
+        ghostView(j)     = std::find(ghosts.begin(), ghosts.end(), j) != ghosts.end();
+    }
+    return atlas::functionspace::PointCloud(lonlat, ghost);
+}
+
 CASE("test_construction") {
     eckit::LocalConfiguration localEvent;
     localEvent.set("name", "dummyEvent");
@@ -61,6 +124,1030 @@ CASE("test_aviso_notification") {
 
     EXPECT_THROWS_AS(notificationHandler.setSchemaData(), eckit::BadParameter);
 }
+
+CASE("test_field_type_dispatch") {
+    auto fs                         = pointCloud({{0.0, 0.0}, {10.0, 0.0}, {20.0, 0.0}, {30.0, 0.0}});
+    const std::vector<double> speed = {10.0, 26.0, 24.5, 40.0};
+    eckit::LocalConfiguration instance;
+    instance.set("lower_bound", 25.0);
+    instance.set("upper_bound", 0.0);
+    instance.set("description", "Strong wind");
+
+    // The same winds in single and double precision fire the same points, with the same values
+    for (bool doublePrecision : {false, true}) {
+        std::vector<atlas::Field> wind;
+        for (const auto& name : {"100u", "100v"}) {
+            atlas::util::Config config;
+            config.set("name", name).set("levels", 1);
+            wind.push_back(doublePrecision ? fs.createField<double>(config) : fs.createField<float>(config));
+        }
+        dispatchFieldType(wind[0], [&](auto tag) {
+            using T = decltype(tag);
+            auto u  = atlas::array::make_view<T, 2>(wind[0]);
+            auto v  = atlas::array::make_view<T, 2>(wind[1]);
+            for (atlas::idx_t j = 0; j < 4; ++j) {
+                u(j, 0) = static_cast<T>(0.6 * speed[j]);
+                v(j, 0) = static_cast<T>(-0.8 * speed[j]);
+            }
+        });
+        plume::data::ModelData modelData;
+        modelData.provideAtlasFieldShared("100u", wind[0]);
+        modelData.provideAtlasFieldShared("100v", wind[1]);
+        auto event = ExtremeEventRegistry::instance().createEvent("extreme_wind",
+                                                                  eventConfig({"100u", "100v"}, {instance}));
+        event->setup(modelData);
+        auto results = event->detect(modelData);
+        EXPECT(results[0].detectedPoints == std::vector<int>({1, 3}));
+        EXPECT(std::abs(results[0].detectedValues[0] - 26.f) < 1e-4);
+        EXPECT(std::abs(results[0].detectedValues[1] - 40.f) < 1e-4);
+    }
+
+    // The fields of an event must share their precision, and only real fields are supported
+    atlas::util::Config config;
+    config.set("name", "100u").set("levels", 1);
+    auto u = fs.createField<float>(config);
+    config.set("name", "100v");
+    auto v = fs.createField<double>(config);
+    plume::data::ModelData mixed;
+    mixed.provideAtlasFieldShared("100u", u);
+    mixed.provideAtlasFieldShared("100v", v);
+    auto event =
+        ExtremeEventRegistry::instance().createEvent("extreme_wind", eventConfig({"100u", "100v"}, {instance}));
+    event->setup(mixed);
+    EXPECT_THROWS_AS(event->detect(mixed), eckit::BadValue);
+    config.set("name", "mask");
+    auto mask = fs.createField<int>(config);
+    EXPECT_THROWS_AS(dispatchFieldType(mask, [](auto) {}), eckit::BadValue);
+}
+
+CASE("test_regions") {
+    // Box crossing the antimeridian
+    eckit::LocalConfiguration box;
+    box.set("area", std::vector<double>{10.0, 170.0, -10.0, -170.0});
+    RegionUtils::Region pacific(box);
+    EXPECT(pacific.contains(atlas::PointLonLat{175.0, 0.0}));
+    EXPECT(pacific.contains(atlas::PointLonLat{-175.0, 5.0}));
+    EXPECT(pacific.contains(atlas::PointLonLat{185.0, -5.0}));
+    EXPECT_NOT(pacific.contains(atlas::PointLonLat{0.0, 0.0}));
+    EXPECT_NOT(pacific.contains(atlas::PointLonLat{175.0, 20.0}));
+
+    // Triangle over the North Sea, given as (lat, lon) pairs
+    eckit::LocalConfiguration triangle;
+    triangle.set("polygon", std::vector<double>{51.0, 0.0, 51.0, 8.0, 60.0, 4.0});
+    RegionUtils::Region northSea(triangle);
+    EXPECT(northSea.contains(atlas::PointLonLat{4.0, 55.0}));
+    EXPECT(northSea.contains(atlas::PointLonLat{364.0, 55.0}));
+    EXPECT_NOT(northSea.contains(atlas::PointLonLat{0.5, 59.0}));
+    EXPECT_NOT(northSea.contains(atlas::PointLonLat{4.0, 50.0}));
+
+    eckit::LocalConfiguration both = box;
+    both.set("polygon", std::vector<double>{51.0, 0.0, 51.0, 8.0, 60.0, 4.0});
+    EXPECT_THROWS_AS(RegionUtils::Region region(both), eckit::BadParameter);
+}
+
+CASE("test_local_cell_vertices") {
+    // Two adjacent square cells, known to a partition by their global index only
+    std::vector<std::vector<atlas::PointLonLat>> global = {
+        {{0.0, 0.0}, {1.0, 0.0}, {1.0, 1.0}, {0.0, 1.0}}, {{1.0, 0.0}, {2.0, 0.0}, {2.0, 1.0}, {1.0, 1.0}}};
+    HEALPixUtils::CellVertexMap local = {{1000, global[0]}, {1001, global[1]}};
+    auto polygons                     = HEALPixUtils::cellsToPolygons({0, 1}, global);
+    EXPECT_EQUAL(polygons.size(), 1);
+    EXPECT(HEALPixUtils::cellsToPolygons({1000, 1001}, local) == polygons);
+    EXPECT_THROWS(HEALPixUtils::cellsToPolygons({1002}, local));
+}
+
+CASE("test_mapping_cache") {
+    // The 100 m wind on one function space, the 10 m wind on another one on the other side of the globe
+    auto surface = pointCloud({{0.0, 0.0}, {2.0, 0.0}, {30.0, 40.0}});
+    auto other   = pointCloud({{180.0, 0.0}, {182.0, 0.0}, {210.0, -40.0}});
+    const std::vector<std::pair<std::string, atlas::functionspace::PointCloud>> fieldSpaces = {
+        {"100u", surface}, {"100v", surface}, {"10u", other}, {"10v", other}};
+    std::vector<atlas::Field> wind;
+    for (const auto& [name, fs] : fieldSpaces) {
+        atlas::util::Config config;
+        config.set("name", name).set("levels", 1);
+        wind.push_back(fs.createField<double>(config));
+        // Westerly wind of 40 m/s everywhere
+        atlas::array::make_view<double, 2>(wind.back()).assign(name.back() == 'u' ? 40.0 : 0.0);
+    }
+    int nstep    = 1;
+    double tstep = 3600.0;
+    int nflevg   = 1;
+    plume::data::ModelData modelData;
+    modelData.provideInt("NSTEP", &nstep);
+    modelData.provideDouble("TSTEP", &tstep);
+    modelData.provideInt("NFLEVG", &nflevg);
+    for (auto& field : wind) {
+        modelData.provideAtlasFieldShared(field.name(), field);
+    }
+
+    eckit::LocalConfiguration instance;
+    instance.set("lower_bound", 25.0).set("upper_bound", 0.0).set("description", "Strong wind");
+    std::vector<eckit::LocalConfiguration> events;
+    for (const auto& fields : {std::vector<std::string>{"100u", "100v"}, std::vector<std::string>{"100u", "100v"},
+                               std::vector<std::string>{"10u", "10v"}}) {
+        events.push_back(eventConfig(fields, {instance}));
+        events.back().set("name", "extreme_wind");
+    }
+    const std::string path = "test_mapping_cache.bin";
+    std::remove(path.c_str());
+    eckit::LocalConfiguration config;
+    config.set("healpix_res", 8).set("enable_notification", false).set("results_file", path).set("events", events);
+    {
+        ExtremeEventPlugin::EEPluginCore core(config);
+        core.grabData(modelData);
+        core.setup();
+        // The two events on the 100 m wind share one mapping
+        EXPECT_EQUAL(core.mappedFunctionSpaces(), 2);
+        core.run();
+    }
+
+    // Each event fires the cells of the points of its own function space
+    auto cellsOf = [](const atlas::FunctionSpace& fs) {
+        std::vector<int> mapping;
+        std::vector<std::vector<atlas::PointLonLat>> vertices;
+        HEALPixUtils::mapLonLatToHEALPixCell(8, fs, mapping, vertices);
+        return HEALPixUtils::pointsToCells({0, 1, 2}, mapping);
+    };
+    auto records = ExtremeEventPlugin::ResultsSink::read(path);
+    EXPECT_EQUAL(records.size(), 3);
+    EXPECT(records[0].cells == cellsOf(surface));
+    EXPECT(records[1].cells == cellsOf(surface));
+    EXPECT(records[2].cells == cellsOf(other));
+    EXPECT(records[2].cells != records[0].cells);
+    std::remove(path.c_str());
+}
+
+CASE("test_event_statistics") {
+    // Cells 0 and 1 share an edge, cell 2 only touches cell 1 at a corner, cell 3 is apart
+    std::vector<std::vector<atlas::PointLonLat>> cells = {{{0.0, 0.0}, {1.0, 0.0}, {1.0, 1.0}, {0.0, 1.0}},
+                                                          {{1.0, 0.0}, {2.0, 0.0}, {2.0, 1.0}, {1.0, 1.0}},
+                                                          {{2.0, 1.0}, {3.0, 1.0}, {3.0, 2.0}, {2.0, 2.0}},
+                                                          {{5.0, 5.0}, {6.0, 5.0}, {6.0, 6.0}, {5.0, 6.0}}};
+    auto groups = HEALPixUtils::contiguousCells({0, 1, 2, 3}, cells);
+    EXPECT(groups == std::vector<std::vector<int>>({{0, 1, 2}, {3}}));
+
+    // The values of the detected points are collected in the selection pass
+    std::vector<atlas::idx_t> points = {0, 1, 2, 3, 4};
+    std::vector<double> wind         = {30.0, 20.0, 26.0, 40.0, 25.0};
+    std::vector<int> detected;
+    std::vector<float> values;
+    WindKernels::selectInInterval(wind.data(), points.data(), 5, 25.0, 0.0, detected, &values);
+    EXPECT(detected == std::vector<int>({0, 2, 3, 4}));
+    EXPECT(values == std::vector<float>({30.f, 26.f, 40.f, 25.f}));
+
+    // Points 0 and 2 fall in cell 0, points 3 and 4 in cell 3
+    std::vector<int> pointToCell = {0, 1, 0, 3, 3};
+    auto byCell                  = ExtremeEventPlugin::cellStatistics(detected, values, pointToCell);
+    EXPECT_EQUAL(byCell.size(), 2);
+    EXPECT_EQUAL(byCell[0].points, 2);
+    EXPECT_EQUAL(byCell[0].max, 30.f);
+    EXPECT_EQUAL(byCell[3].maxPoint, 3);
+    ExtremeEventPlugin::EventStatistics instance;
+    instance.merge(byCell[0]);
+    instance.merge(byCell[3]);
+    EXPECT_EQUAL(instance.cells, 2);
+    EXPECT_EQUAL(instance.max, 40.f);
+    EXPECT_EQUAL(instance.maxPoint, 3);
+    EXPECT(std::abs(instance.mean() - 30.25) < 1e-9);
+    // Events that do not report values have no statistics
+    EXPECT(ExtremeEventPlugin::cellStatistics(detected, {}, pointToCell).empty());
+
+    // The 12 cells of the first resolution cover the sphere
+    EXPECT(std::abs(12 * ExtremeEventPlugin::healpixCellArea(1) - 4.0 * M_PI * 6371.0 * 6371.0) < 1.0);
+    EXPECT(std::abs(ExtremeEventPlugin::healpixCellArea(2) * 4 - ExtremeEventPlugin::healpixCellArea(1)) < 1e-6);
+}
+
+CASE("test_cell_criterion") {
+    using Criterion = ExtremeEvent::CellCriterion;
+    // Cell 7 holds four owned points, cell 3 two, the last point is in the halo
+    ExtremeEventPlugin::CellSlots slots({7, 7, 3, 7, 3, 7, -1});
+    EXPECT(slots.slotCell == std::vector<int>({7, 3}));
+    EXPECT(slots.slotPoints == std::vector<int>({4, 2}));
+    std::vector<int> detected = {0, 2, 4, 5};
+    std::vector<float> values = {30.f, 21.f, 22.f, 20.f};
+
+    Criterion single;
+    EXPECT_NOT(single.aggregates());
+    EXPECT(ExtremeEventPlugin::aggregateCells(detected, values, slots, single) == std::vector<int>({3, 7}));
+
+    eckit::LocalConfiguration options;
+    options.set("min_fraction", 0.75);
+    eckit::LocalConfiguration instance;
+    instance.set("cell_criterion", options);
+    auto fraction = Criterion::fromConfig(instance);
+    EXPECT(fraction.aggregates());
+    // Two of the four points of cell 7 fired, both points of cell 3
+    EXPECT(ExtremeEventPlugin::aggregateCells(detected, values, slots, fraction) == std::vector<int>({3}));
+
+    Criterion mean;
+    mean.minMean = 24.0;
+    EXPECT(ExtremeEventPlugin::aggregateCells(detected, values, slots, mean) == std::vector<int>({7}));
+    EXPECT_THROWS_AS(ExtremeEventPlugin::aggregateCells(detected, {}, slots, mean), eckit::BadValue);
+
+    options.set("min_points", 0);
+    instance.set("cell_criterion", options);
+    EXPECT_THROWS_AS(Criterion::fromConfig(instance), eckit::BadParameter);
+}
+
+CASE("test_coarser_cells") {
+    // Fine cells 3 and 7 lie in coarse cell 1, fine cell 5 in coarse cell 0
+    std::vector<int> fromFinest(8, 0);
+    fromFinest[3] = fromFinest[7] = 1;
+    EXPECT(HEALPixUtils::coarserCells({3, 5, 7}, fromFinest) == std::vector<int>({0, 1}));
+    std::unordered_map<int, int> localFromFinest = {{3, 12}, {5, 10}, {7, 12}};
+    EXPECT(HEALPixUtils::coarserCells({7, 3}, localFromFinest) == std::vector<int>({12}));
+
+    // The fine slots are folded into the coarse ones, the criterion is judged on the coarse cells
+    ExtremeEventPlugin::CellSlots slots({7, 7, 3, 7, 3, 7, 5, -1});
+    ExtremeEventPlugin::CoarseSlots coarse(slots, [&](int cell) { return fromFinest[cell]; });
+    EXPECT(coarse.slotCell == std::vector<int>({1, 0}));
+    EXPECT(coarse.slotPoints == std::vector<int>({6, 1}));
+    ExtremeEvent::CellCriterion criterion;
+    criterion.minPoints       = 3;
+    std::vector<int> detected = {0, 2, 4, 6};
+    EXPECT(ExtremeEventPlugin::aggregateCells(detected, {}, slots, criterion).empty());
+    EXPECT(ExtremeEventPlugin::aggregateCells(detected, {}, slots, criterion, &coarse) == std::vector<int>({1}));
+
+    // The same indices at two levels are different cells
+    std::vector<std::vector<atlas::PointLonLat>> cells = {{{0.0, 0.0}, {1.0, 0.0}, {1.0, 1.0}, {0.0, 1.0}}};
+
+    size_t extracted = 0;
+    auto extract     = [&]() {
+        ++extracted;
+        return HEALPixUtils::cellsToPolygons({0}, cells);
+    };
+    ExtremeEventPlugin::PolygonCache cache(4);
+    cache.polygons({0}, extract, 0);
+    cache.polygons({0}, extract, 1);
+    cache.polygons({0}, extract, 1);
+    EXPECT_EQUAL(extracted, 2);
+}
+
+CASE("test_parent_cells") {
+    // The four cells of the first ring of resolution 2 lie in the four northern base cells, the last one in the last
+    for (int cell = 0; cell < 4; ++cell) {
+        EXPECT_EQUAL(HEALPixUtils::parentCell(cell, 2, 1), cell);
+    }
+    EXPECT_EQUAL(HEALPixUtils::parentCell(47, 2, 1), 11);
+    EXPECT_EQUAL(HEALPixUtils::parentCell(100, 8, 8), 100);
+    EXPECT_THROWS_AS(HEALPixUtils::parentCell(0, 8, 3), eckit::BadParameter);
+
+    // Each cell of resolution 8 lies within its parent cell of resolution 2, and each parent has 16 cells
+    std::vector<int> mapping;
+    std::vector<std::vector<atlas::PointLonLat>> fineVertices;
+    HEALPixUtils::mapLonLatToHEALPixCell(8, pointCloud({{0.0, 0.0}}), mapping, fineVertices);
+    std::vector<int> fromFinest;
+    std::vector<std::vector<atlas::PointLonLat>> coarseVertices;
+    HEALPixUtils::mapHEALPixCellsToCoarserCells(2, 8, fromFinest, coarseVertices);
+    EXPECT_EQUAL(fromFinest.size(), fineVertices.size());
+    std::vector<int> children(coarseVertices.size(), 0);
+    for (size_t cell = 0; cell < fromFinest.size(); ++cell) {
+        const auto& parent = coarseVertices[fromFinest[cell]];
+        ++children[fromFinest[cell]];
+        // The longitude of a pole vertex is arbitrary, the cells touching the poles are only counted
+        if (std::any_of(parent.begin(), parent.end(),
+                        [](const atlas::PointLonLat& vertex) { return std::abs(vertex.lat()) > 89.9; })) {
+            continue;
+        }
+        std::vector<double> polygon;
+        for (const auto& vertex : parent) {
+            polygon.push_back(vertex.lat());
+            polygon.push_back(vertex.lon());
+        }
+        eckit::LocalConfiguration outline;
+        outline.set("polygon", polygon);
+        const auto centre = HEALPixUtils::cellsCentroid({static_cast<int>(cell)}, fineVertices);
+        EXPECT(RegionUtils::Region(outline).contains(centre));
+    }
+    EXPECT(std::all_of(children.begin(), children.end(), [](int count) { return count == 16; }));
+}
+
+CASE("test_event_tracker") {
+    using ExtremeEventPlugin::EventTracker;
+    // Identifiers of rank 1 out of 2
+    EventTracker tracker(500.0, 1, 2);
+    std::vector<EventTracker::Track> died;
+    auto first = tracker.update(0, {{1, 2, 3}, {10, 11, 12}}, {{0.0, 0.0}, {20.0, 0.0}}, died);
+    EXPECT_EQUAL(first.size(), 2);
+    EXPECT(first[0].state == EventTracker::State::Born);
+    EXPECT_EQUAL(first[0].id, 1);
+    EXPECT_EQUAL(first[1].id, 3);
+    EXPECT(died.empty());
+    EXPECT(tracker.tracking(0));
+    EXPECT_NOT(tracker.tracking(1));
+
+    // The first event moves by a cell, the second splits, the part overlapping it most keeps its identifier
+    auto second = tracker.update(0, {{2, 3, 4}, {10}, {11, 12, 13}}, {{1.0, 0.0}, {19.0, 0.0}, {21.0, 0.0}}, died);
+    EXPECT(second[0].state == EventTracker::State::Moved);
+    EXPECT_EQUAL(second[0].id, 1);
+    EXPECT(second[1].state == EventTracker::State::Split);
+    EXPECT(second[1].related == std::vector<uint64_t>({3}));
+    EXPECT_EQUAL(second[1].id, 5);
+    EXPECT(second[2].state == EventTracker::State::Split);
+    EXPECT_EQUAL(second[2].id, 3);
+
+    // The two parts merge again, the first event jumps by a few cells and is matched by its centroid
+    auto third = tracker.update(0, {{7, 8}, {10, 11, 12}}, {{3.0, 0.0}, {20.0, 0.0}}, died);
+    EXPECT(third[0].state == EventTracker::State::Moved);
+    EXPECT_EQUAL(third[0].id, 1);
+    EXPECT(third[1].state == EventTracker::State::Merged);
+    EXPECT_EQUAL(third[1].id, 3);
+    EXPECT(third[1].related == std::vector<uint64_t>({5}));
+    EXPECT(died.empty());
+
+    // Both events end, their last cells are reported
+    auto fourth = tracker.update(0, {}, {}, died);
+    EXPECT(fourth.empty());
+    EXPECT_EQUAL(died.size(), 2);
+    EXPECT(died[0].state == EventTracker::State::Died);
+    EXPECT(died[0].cells == std::vector<int>({7, 8}));
+    EXPECT_EQUAL(EventTracker::toJson(died[1]), std::string("{\"id\":3,\"state\":\"died\",\"related\":[]}"));
+    EXPECT_NOT(tracker.tracking(0));
+    EXPECT_THROWS_AS(EventTracker(-1.0, 0, 1), eckit::BadParameter);
+}
+
+CASE("test_polygon_cache") {
+    std::vector<std::vector<atlas::PointLonLat>> cells = {{{0.0, 0.0}, {1.0, 0.0}, {1.0, 1.0}, {0.0, 1.0}},
+                                                          {{1.0, 0.0}, {2.0, 0.0}, {2.0, 1.0}, {1.0, 1.0}},
+                                                          {{5.0, 5.0}, {6.0, 5.0}, {6.0, 6.0}, {5.0, 6.0}}};
+    size_t extracted = 0;
+    auto extract     = [&](const std::vector<int>& ids) {
+        return [&, ids]() {
+            ++extracted;
+            return HEALPixUtils::cellsToPolygons(ids, cells);
+        };
+    };
+    ExtremeEventPlugin::PolygonCache cache(2);
+    EXPECT(cache.polygons({0, 1}, extract({0, 1})) == HEALPixUtils::cellsToPolygons({0, 1}, cells));
+    EXPECT(cache.polygons({0, 1}, extract({0, 1})) == HEALPixUtils::cellsToPolygons({0, 1}, cells));
+    EXPECT_EQUAL(extracted, 1);
+    EXPECT_EQUAL(cache.hits(), 1);
+    EXPECT_NOT(ExtremeEventPlugin::PolygonCache::hash({0, 1}) == ExtremeEventPlugin::PolygonCache::hash({1, 0}));
+
+    // The least recently used set is dropped beyond the capacity
+    cache.polygons({2}, extract({2}));
+    cache.polygons({0, 1}, extract({0, 1}));
+    cache.polygons({1}, extract({1}));
+    EXPECT_EQUAL(cache.size(), 2);
+    EXPECT_EQUAL(extracted, 3);
+    cache.polygons({0, 1}, extract({0, 1}));
+    EXPECT_EQUAL(extracted, 3);
+    cache.polygons({2}, extract({2}));
+    EXPECT_EQUAL(extracted, 4);
+
+    cache.clear();
+    EXPECT_EQUAL(cache.size(), 0);
+    ExtremeEventPlugin::PolygonCache disabled(0);
+    disabled.polygons({2}, extract({2}));
+    disabled.polygons({2}, extract({2}));
+    EXPECT_EQUAL(extracted, 6);
+    EXPECT_EQUAL(disabled.size(), 0);
+}
+
+CASE("test_async_writer") {
+    const std::string path = "test_async_writer.out";
+    {
+        ExtremeEventPlugin::AsyncFileWriter writer(path, false);
+        EXPECT(writer.startedEmpty());
+        writer.write("step,value\n");
+        for (int step = 0; step < 100; ++step) {
+            writer.write(std::to_string(step) + "," + std::to_string(step * step) + "\n");
+            writer.flush();
+        }
+        writer.sync();
+        writer.write("last,line\n");
+    }
+    std::ifstream in(path);
+    std::stringstream content;
+    content << in.rdbuf();
+    std::string expected = "step,value\n";
+    for (int step = 0; step < 100; ++step) {
+        expected += std::to_string(step) + "," + std::to_string(step * step) + "\n";
+    }
+    expected += "last,line\n";
+    EXPECT_EQUAL(content.str(), expected);
+
+    // With a single pending buffer, the flushes wait for the writes and nothing is lost
+    {
+        ExtremeEventPlugin::AsyncFileWriter bounded(path, false, 1);
+        for (int step = 0; step < 100; ++step) {
+            bounded.write(std::to_string(step) + "\n");
+            bounded.flush();
+        }
+    }
+    std::ifstream boundedIn(path);
+    for (int step = 0; step < 100; ++step) {
+        std::string line;
+        EXPECT(std::getline(boundedIn, line) && line == std::to_string(step));
+    }
+    EXPECT_THROWS_AS(ExtremeEventPlugin::AsyncFileWriter(path, false, 0), eckit::BadParameter);
+
+    ExtremeEventPlugin::AsyncFileWriter append(path);
+    EXPECT_NOT(append.startedEmpty());
+    std::remove(path.c_str());
+}
+
+CASE("test_results_sink") {
+    const std::string path = "test_results_sink.bin";
+    std::remove(path.c_str());
+    std::vector<atlas::PointLonLat> polygon = {atlas::PointLonLat{250.3, 16.9}, atlas::PointLonLat{247.4, 14.4},
+                                               atlas::PointLonLat{253.1, 14.4}, atlas::PointLonLat{250.3, 12.0}};
+    {
+        ExtremeEventPlugin::ResultsSink sink(path);
+        sink.write({"1h", 0, 1, "Strong wind", "u/v", "ml", "1", {3, 4, 5, 9}, {polygon}});
+        sink.write({"2h", 0, 1, "Strong wind", "u/v", "ml", "1", {7}, {polygon, polygon}});
+        sink.flush();
+        sink.write({"2h", 1, 0, "No wind", "100u/100v", "sfc", "0", {}, {}});
+    }
+
+    auto records = ExtremeEventPlugin::ResultsSink::read(path);
+    EXPECT_EQUAL(records.size(), 3);
+    EXPECT_EQUAL(records[0].step, "1h");
+    EXPECT_EQUAL(records[0].description, "Strong wind");
+    EXPECT(records[0].cells == std::vector<int>({3, 4, 5, 9}));
+    EXPECT_EQUAL(records[0].polygons.size(), 1);
+    EXPECT(records[0].polygons[0] == polygon);
+    EXPECT_EQUAL(records[1].step, "2h");
+    EXPECT_EQUAL(records[1].levelist, "1");
+    EXPECT(records[1].cells == std::vector<int>({7}));
+    EXPECT_EQUAL(records[1].polygons.size(), 2);
+    EXPECT_EQUAL(records[2].event, 1);
+    EXPECT_EQUAL(records[2].param, "100u/100v");
+    EXPECT(records[2].cells.empty());
+
+    // A truncated last record is ignored
+    std::ofstream truncated(path, std::ios::binary | std::ios::app);
+    truncated.put('R');
+    truncated.close();
+    EXPECT_EQUAL(ExtremeEventPlugin::ResultsSink::read(path).size(), 3);
+
+    // and dropped when appending, so that the records of the next run are read back
+    {
+        ExtremeEventPlugin::ResultsSink sink(path);
+        sink.write({"3h", 0, 1, "Strong wind", "u/v", "ml", "1", {8}, {}});
+    }
+    records = ExtremeEventPlugin::ResultsSink::read(path);
+    EXPECT_EQUAL(records.size(), 4);
+    EXPECT_EQUAL(records[3].step, "3h");
+    EXPECT_EQUAL(records[3].description, "Strong wind");
+    EXPECT(records[3].cells == std::vector<int>({8}));
+    std::remove(path.c_str());
+}
+
+CASE("test_snapshot") {
+    const std::string path = "test_snapshot.bin";
+    // Three points, the last one in the halo
+    atlas::Field lonlat("lonlat", atlas::array::make_datatype<double>(), atlas::array::make_shape(3, 2));
+    atlas::Field ghost("ghost", atlas::array::make_datatype<int>(), atlas::array::make_shape(3));
+    auto lonlatView = atlas::array::make_view<double, 2>(lonlat);
+    auto ghostView  = atlas::array::make_view<int, 1>(ghost);
+    for (atlas::idx_t j = 0; j < 3; ++j) {
+        lonlatView(j, 0) = 10.0 * j;
+        lonlatView(j, 1) = 45.0;
+        ghostView(j)     = j == 2;
+    }
+    atlas::functionspace::PointCloud fs(lonlat, ghost);
+    atlas::util::Config config;
+    config.set("name", "100u").set("levels", 1);
+    auto u = fs.createField<float>(config);
+    config.set("name", "u").set("levels", 2);
+    auto ml = fs.createField<double>(config);
+
+    int nstep    = 0;
+    double tstep = 450.0;
+    int nflevg   = 2;
+    plume::data::ModelData modelData;
+    modelData.provideInt("NSTEP", &nstep);
+    modelData.provideDouble("TSTEP", &tstep);
+    modelData.provideInt("NFLEVG", &nflevg);
+    modelData.provideAtlasFieldShared("100u", u);
+    modelData.provideAtlasFieldShared("u", ml);
+    auto uView  = atlas::array::make_view<float, 2>(u);
+    auto mlView = atlas::array::make_view<double, 2>(ml);
+    {
+        ExtremeEventPlugin::SnapshotWriter writer(path, modelData, {"100u", "u"});
+        for (nstep = 1; nstep <= 2; ++nstep) {
+            for (atlas::idx_t j = 0; j < 3; ++j) {
+                uView(j, 0)  = static_cast<float>(nstep * 10 + j);
+                mlView(j, 0) = -nstep;
+                mlView(j, 1) = 0.5 * j;
+            }
+            writer.write(modelData);
+            writer.flush();
+        }
+        writer.sync();
+    }
+
+    ExtremeEventPlugin::SnapshotReader reader(path);
+    const auto& geometry = reader.geometry();
+    EXPECT_EQUAL(geometry.points(), 3);
+    EXPECT(geometry.ghost == std::vector<int32_t>({0, 0, 1}));
+    EXPECT_EQUAL(geometry.lonlat[2], 10.0);
+    EXPECT_EQUAL(geometry.nflevg, 2);
+    EXPECT_EQUAL(geometry.fields.size(), 2);
+    EXPECT_EQUAL(geometry.fields[0].name, "100u");
+    EXPECT_NOT(geometry.fields[0].doublePrecision);
+    EXPECT(geometry.fields[1].doublePrecision);
+    EXPECT_EQUAL(geometry.fields[1].levels, 2);
+
+    // Fields of the replay, filled in place at each step
+    atlas::util::Config surface;
+    surface.set("levels", 1);
+    std::vector<atlas::Field> fields = {fs.createField<float>(surface), fs.createField<double>(config)};
+    int step;
+    double timeStep;
+    EXPECT(reader.next(step, timeStep, fields));
+    EXPECT_EQUAL(step, 1);
+    EXPECT_EQUAL(timeStep, 450.0);
+    EXPECT(reader.next(step, timeStep, fields));
+    EXPECT_EQUAL(step, 2);
+    EXPECT_EQUAL((atlas::array::make_view<float, 2>(fields[0])(1, 0)), 21.f);
+    EXPECT_EQUAL((atlas::array::make_view<double, 2>(fields[1])(2, 1)), 1.0);
+    EXPECT_NOT(reader.next(step, timeStep, fields));
+    std::remove(path.c_str());
+
+    // The recording and the replay name the files of the ensemble members alike, the rank is only added on more ranks
+    EXPECT_EQUAL(ExtremeEventPlugin::snapshotPath(path), path);
+    EXPECT_EQUAL(ExtremeEventPlugin::snapshotPath(path, 2), path + ".member2");
+}
+
+CASE("test_threshold_field") {
+    const std::string path = "test_threshold_field.bin";
+    // Two levels of five points, the threshold is missing at the second point of the second level
+    std::vector<float> values = {10.f, 11.f, 12.f, 13.f, 14.f, 20.f, NAN, 22.f, 23.f, 24.f};
+    ThresholdUtils::ThresholdField::write(path, 2, 5, values);
+    {
+        ThresholdUtils::ThresholdField thresholds(path);
+        EXPECT_EQUAL(thresholds.levels(), 2);
+        EXPECT_EQUAL(thresholds.points(), 5);
+        auto slice = thresholds.slice(std::vector<atlas::gidx_t>{5, 1, 3}, 1);
+        EXPECT(slice == std::vector<float>({24.f, 20.f, 22.f}));
+        EXPECT_THROWS_AS(thresholds.slice(std::vector<atlas::gidx_t>{6}, 0), eckit::BadValue);
+        EXPECT_THROWS_AS(thresholds.slice(std::vector<atlas::gidx_t>{1}, 2), eckit::BadValue);
+
+        // Field against field comparison, a missing threshold never fires
+        std::vector<atlas::idx_t> points         = {0, 1, 2, 3};
+        std::vector<double> wind                 = {25.0, 30.0, 21.0, 23.0};
+        std::vector<atlas::gidx_t> globalIndices = {1, 2, 3, 4};
+        auto levelThresholds                     = thresholds.slice(globalIndices, 1);
+        std::vector<int> detected;
+        std::vector<unsigned char> exceeds(4);
+        WindKernels::selectAboveThresholds(wind.data(), levelThresholds.data(), points.data(), 4, exceeds.data(),
+                                           detected);
+        EXPECT(detected == std::vector<int>({0, 3}));
+    }
+    EXPECT_THROWS_AS(ThresholdUtils::ThresholdField::write(path, 2, 5, {1.f}), eckit::BadValue);
+    std::remove(path.c_str());
+}
+
+CASE("test_threshold_overrides") {
+    ExtremeEventPlugin::EpochPublisher<int> publisher;
+    EXPECT(publisher.acquire() == nullptr);
+    publisher.publish(std::make_unique<int>(1));
+    const int* first = publisher.acquire();
+    EXPECT_EQUAL(*first, 1);
+    // The acquired value stays valid until the next acquire, whatever is published meanwhile
+    publisher.publish(std::make_unique<int>(2));
+    publisher.publish(std::make_unique<int>(3));
+    EXPECT_EQUAL(*first, 1);
+    EXPECT_EQUAL(*publisher.acquire(), 3);
+
+    eckit::LocalConfiguration instance;
+    instance.set("lower_bound", 25.0);
+    instance.set("upper_bound", 0.0);
+    instance.set("description", "Strong wind");
+    auto event = ExtremeEventRegistry::instance().createEvent("extreme_wind", eventConfig({"100u"}, {instance}));
+    eckit::LocalConfiguration bounds;
+    bounds.set("instance", 0);
+    bounds.set("lower_bound", 30.0);
+    EXPECT_NO_THROW(event->overrideInstances({bounds}));
+    bounds.set("instance", 1);
+    EXPECT_THROWS_AS(event->overrideInstances({bounds}), eckit::BadValue);
+
+    const std::string path = "test_threshold_overrides.yml";
+    std::remove(path.c_str());
+    {
+        ExtremeEventPlugin::ThresholdOverrideWatcher watcher(path, 0.01);
+        // A missing file overrides nothing
+        const auto* overrides = watcher.latest();
+        EXPECT(overrides != nullptr);
+        EXPECT(overrides->events.empty());
+        // Only the version is kept, each call to `latest` releases the overrides it returned before
+        const uint64_t missingVersion = overrides->version;
+        EXPECT_EQUAL(missingVersion, ExtremeEventPlugin::ThresholdOverrides::read(path, missingVersion).version);
+
+        // The file is replaced atomically, so that the watcher never reads it half written
+        std::ofstream(path + ".tmp") << "events:\n  - name: extreme_wind\n    instances:\n      - instance: 0\n"
+                                     << "        lower_bound: 30.0\n";
+        std::rename((path + ".tmp").c_str(), path.c_str());
+        for (int attempt = 0; attempt < 500 && watcher.latest()->version == missingVersion; ++attempt) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        overrides = watcher.latest();
+        EXPECT_EQUAL(overrides->events.size(), 1);
+        EXPECT_EQUAL(overrides->events.at("extreme_wind")[0].getDouble("lower_bound"), 30.0);
+    }
+    std::ofstream(path) << "events:\n  - name: extreme_wind\n    instances:\n      - lower_bound: 30.0\n";
+    EXPECT_THROWS_AS(ExtremeEventPlugin::ThresholdOverrides::read(path, 1), eckit::BadValue);
+    std::remove(path.c_str());
+}
+
+CASE("test_ensemble_probability") {
+    using ExtremeEventPlugin::cellsAboveProbability;
+    // Number of the 10 members firing at each cell
+    std::vector<int> cells  = {3, 8, 12, 40, 41};
+    std::vector<int> counts = {0, 2, 3, 10, 7};
+    EXPECT(cellsAboveProbability(cells, counts.data(), 10, 0.3) == std::vector<int>({12, 40, 41}));
+    EXPECT(cellsAboveProbability(cells, counts.data(), 10, 1.0) == std::vector<int>({40}));
+    EXPECT(cellsAboveProbability(cells, counts.data(), 10, 0.01) == std::vector<int>({8, 12, 40, 41}));
+
+    eckit::LocalConfiguration conf;
+    conf.set("probability", 1.5);
+    EXPECT_THROWS_AS(ExtremeEventPlugin::EnsembleReducer{conf}, eckit::BadParameter);
+    conf.set("probability", 0.5);
+    conf.set("members", -2);
+    EXPECT_THROWS_AS(ExtremeEventPlugin::EnsembleReducer{conf}, eckit::BadParameter);
+}
+
+CASE("test_power_curve") {
+    eckit::LocalConfiguration curveConfig;
+    curveConfig.set("cut_in", 3.0);
+    curveConfig.set("rated_speed", 12.0);
+    curveConfig.set("cut_out", 25.0);
+    PowerCurve parametric(curveConfig);
+    std::vector<float> speed = {0.f, 2.9f, 7.5f, 12.f, 24.85f, 30.f, -1.f, NAN};
+    std::vector<float> capacity(speed.size());
+    parametric.capacityFactor(speed.data(), speed.size(), capacity.data());
+    std::vector<float> expected = {0.f, 0.f, (7.5f * 7.5f * 7.5f - 27.f) / (1728.f - 27.f), 1.f, 1.f, 0.f, 0.f, 0.f};
+    for (size_t k = 0; k < speed.size(); ++k) {
+        EXPECT(std::abs(capacity[k] - expected[k]) < 1e-3);
+    }
+
+    // Tabulated curve with a step at the cut-out, resolved to the spacing of the table
+    PowerCurve tabulated({3.0, 12.0, 25.0, 25.0}, {0.0, 1.0, 1.0, 0.0}, 0.1);
+    std::vector<double> speed64 = {7.5, 24.9, 25.0};
+    tabulated.capacityFactor(speed64.data(), speed64.size(), capacity.data());
+    EXPECT(std::abs(capacity[0] - 0.5f) < 1e-4);
+    EXPECT(std::abs(capacity[1] - 1.f) < 1e-4);
+    EXPECT_EQUAL(capacity[2], 0.f);
+    EXPECT_THROWS_AS(PowerCurve({3.0, 2.0}, {0.0, 1.0}), eckit::BadParameter);
+    curveConfig.set("cut_in", 13.0);
+    EXPECT_THROWS_AS(PowerCurve{curveConfig}, eckit::BadParameter);
+
+    // Capacity factor change per hour for a 15 minutes step
+    std::vector<float> current  = {0.5f, 1.f};
+    std::vector<float> previous = {0.5f, 0.1f};
+    std::vector<float> ramp(2);
+    WindKernels::rampRate(current.data(), previous.data(), 2, 4.f, ramp.data());
+    EXPECT(std::abs(ramp[0] - 0.f) < 1e-3 && std::abs(ramp[1] - 3.6f) < 1e-3);
+
+    eckit::LocalConfiguration instance;
+    curveConfig.set("cut_in", 3.0);
+    instance.set("power_curve", curveConfig);
+    instance.set("criterion", "ramp");
+    instance.set("threshold", 0.5);
+    instance.set("description", "Wind power ramp");
+    EXPECT_NO_THROW(ExtremeEventRegistry::instance().createEvent("wind_power", eventConfig({"100u"}, {instance})));
+    instance.set("criterion", "production");
+    EXPECT_THROWS_AS(ExtremeEventRegistry::instance().createEvent("wind_power", eventConfig({"100u"}, {instance})),
+                     eckit::BadValue);
+}
+
+CASE("test_quantile_sketch") {
+    // The first point sees 0, 1, ..., 999 shuffled, the second a constant
+    QuantileSketch sketch(0.9, 2);
+    std::vector<double> values(2, 5.0);
+    for (int step = 0; step < 1000; ++step) {
+        values[0] = (step * 617) % 1000;
+        sketch.update(values.data());
+    }
+    EXPECT_EQUAL(sketch.count(), 1000);
+    EXPECT(std::abs(sketch.estimates()[0] - 900.f) < 20.f);
+    EXPECT_EQUAL(sketch.estimates()[1], 5.f);
+    // The memory does not grow with the number of steps
+    EXPECT_EQUAL(sketch.memory(), 2 * 8 * sizeof(float));
+    EXPECT_THROWS_AS(QuantileSketch(1.0, 2), eckit::BadParameter);
+
+    eckit::LocalConfiguration instance;
+    instance.set("run_quantile", 0.99);
+    instance.set("description", "Top 1% of the run");
+    EXPECT_NO_THROW(ExtremeEventRegistry::instance().createEvent("extreme_wind", eventConfig({"100u"}, {instance})));
+    instance.set("quantile_warmup", 2);
+    EXPECT_THROWS_AS(ExtremeEventRegistry::instance().createEvent("extreme_wind", eventConfig({"100u"}, {instance})),
+                     eckit::BadParameter);
+}
+
+CASE("test_wind_shear") {
+    // Two points on a stride of two levels: a speed-up without turning, then a reversal at the same speed
+    std::vector<float> u             = {5.f, 10.f, 0.f, 0.f};
+    std::vector<float> v             = {0.f, 0.f, 8.f, -8.f};
+    std::vector<atlas::idx_t> points = {0, 1};
+    std::vector<float> shear(2), veer(2);
+    WindKernels::shearAndVeer(u.data(), v.data(), 2, u.data() + 1, v.data() + 1, 2, points.data(), 2, shear.data(),
+                              veer.data());
+    EXPECT(std::abs(shear[0] - 5.f) < 1e-4 && std::abs(veer[0]) < 1e-2);
+    EXPECT(std::abs(shear[1]) < 1e-4 && std::abs(veer[1] - 180.f) < 1e-2);
+    EXPECT(std::abs(WindKernels::vectorAngle(1.0, 1.0) - 45.0) < 1e-3);
+    EXPECT(std::abs(WindKernels::vectorAngle(1.0, -1.0) - 135.0) < 1e-3);
+    EXPECT(std::abs(WindKernels::vectorAngle(2.0, 1.0) - std::atan2(2.0, 1.0) * 180.0 / M_PI) < 1e-3);
+    EXPECT_EQUAL(WindKernels::vectorAngle(0.f, 0.f), 0.f);
+    // A calm level gives a dot product of -0, which is still no veer
+    EXPECT_EQUAL(WindKernels::vectorAngle(0.f, -0.f), 0.f);
+
+    const std::vector<std::string> fields = {"10u", "10v", "100u", "100v"};
+    eckit::LocalConfiguration instance;
+    instance.set("criterion", "veer");
+    instance.set("lower_bound", 30.0);
+    instance.set("upper_bound", 0.0);
+    instance.set("description", "Strong veer across the rotor");
+    EXPECT_NO_THROW(ExtremeEventRegistry::instance().createEvent("wind_shear", eventConfig(fields, {instance})));
+    instance.set("criterion", "gust");
+    EXPECT_THROWS_AS(ExtremeEventRegistry::instance().createEvent("wind_shear", eventConfig(fields, {instance})),
+                     eckit::BadValue);
+    // The surface pair requires both heights
+    instance.set("criterion", "shear");
+    EXPECT_THROWS_AS(
+        ExtremeEventRegistry::instance().createEvent("wind_shear", eventConfig({"10u", "10v", "100u"}, {instance})),
+        eckit::BadParameter);
+}
+
+CASE("test_step_budget") {
+    // The clock is driven by the test, in seconds
+    double now = 0.0;
+    eckit::LocalConfiguration config;
+    config.set("fraction", 0.1);
+    config.set("milliseconds", 500.0);
+    config.set("max_polygons", 2);
+    config.set("relax_steps", 2);
+    ExtremeEventPlugin::StepBudget budget(config, [&now]() { return now; });
+
+    // The first step has no model time yet, only the absolute budget applies
+    budget.startStep();
+    EXPECT(std::abs(budget.budget() - 0.5) < 1e-9);
+    now += 0.2;
+    budget.mark(ExtremeEventPlugin::StepBudget::Phase::Detection);
+    EXPECT(!budget.exhausted());
+    EXPECT(budget.endStep("0s").empty());
+
+    // 2 s of model time give 200 ms, the step spends 300 ms and caps the next steps
+    now += 2.0;
+    budget.startStep();
+    EXPECT(std::abs(budget.budget() - 0.2) < 1e-9);
+    now += 0.3;
+    EXPECT(budget.exhausted());
+    budget.deferred();
+    EXPECT(budget.endStep("1h").find("capped to 2") != std::string::npos);
+    EXPECT(budget.capping());
+
+    // The cap is lifted after two steps in budget
+    for (int step = 0; step < 2; ++step) {
+        EXPECT_EQUAL(budget.polygonCap(), 2);
+        now += 2.0;
+        budget.startStep();
+        now += 0.01;
+        budget.capped(3);
+        EXPECT(!budget.endStep("2h").empty());
+    }
+    EXPECT(!budget.capping());
+    EXPECT_EQUAL(budget.polygonCap(), std::numeric_limits<size_t>::max());
+
+    // Another rank over its budget makes this one defer and cap too
+    double remote = 0.05;
+    config.set("fraction", 0.1);
+    ExtremeEventPlugin::StepBudget shared(config, [&now]() { return now; },
+                                          [&remote](double overshoot) { return std::max(overshoot, remote); });
+    shared.startStep();
+    now += 0.01;
+    EXPECT(shared.exhausted());
+    EXPECT(!shared.endStep("3h").empty());
+    EXPECT(shared.capping());
+
+    config.set("fraction", 0.0);
+    EXPECT_THROWS_AS(ExtremeEventPlugin::StepBudget{config}, eckit::BadParameter);
+    EXPECT_THROWS_AS(ExtremeEventPlugin::StepBudget{eckit::LocalConfiguration()}, eckit::BadParameter);
+}
+
+CASE("test_step_budget_deferral") {
+    // A westerly wind of 40 m/s on three points, with three instances firing on all of them
+    auto fs = pointCloud({{0.0, 0.0}, {2.0, 0.0}, {30.0, 40.0}});
+    std::vector<atlas::Field> wind;
+    for (const std::string name : {"100u", "100v"}) {
+        atlas::util::Config config;
+        config.set("name", name).set("levels", 1);
+        wind.push_back(fs.createField<double>(config));
+        atlas::array::make_view<double, 2>(wind.back()).assign(name == "100u" ? 40.0 : 0.0);
+    }
+    int nstep    = 1;
+    double tstep = 3600.0;
+    int nflevg   = 1;
+    plume::data::ModelData modelData;
+    modelData.provideInt("NSTEP", &nstep);
+    modelData.provideDouble("TSTEP", &tstep);
+    modelData.provideInt("NFLEVG", &nflevg);
+    for (auto& field : wind) {
+        modelData.provideAtlasFieldShared(field.name(), field);
+    }
+    std::vector<eckit::LocalConfiguration> instances;
+    for (double bound : {25.0, 30.0, 35.0}) {
+        eckit::LocalConfiguration instance;
+        instance.set("lower_bound", bound).set("upper_bound", 0.0).set("description", "Strong wind");
+        instances.push_back(instance);
+    }
+    auto event = eventConfig({"100u", "100v"}, instances);
+    event.set("name", "extreme_wind");
+
+    // Two steps with and without a budget too small for any output, which defers all the instances of each step
+    auto runSteps = [&](const std::string& path, bool budget) {
+        std::remove(path.c_str());
+        eckit::LocalConfiguration config;
+        config.set("healpix_res", 8).set("enable_notification", false).set("results_file", path);
+        config.set("events", std::vector<eckit::LocalConfiguration>{event});
+        if (budget) {
+            eckit::LocalConfiguration options;
+            options.set("milliseconds", 1e-6);
+            config.set("step_budget", options);
+        }
+        {
+            ExtremeEventPlugin::EEPluginCore core(config);
+            core.grabData(modelData);
+            core.setup();
+            for (nstep = 1; nstep <= 2; ++nstep) {
+                core.run();
+            }
+        }
+        // The outputs of the second step are still deferred after the last step, the plugin sends them when destroyed
+        return ExtremeEventPlugin::ResultsSink::read(path);
+    };
+    auto reference = runSteps("test_step_budget_reference.bin", false);
+    auto deferred  = runSteps("test_step_budget_deferral.bin", true);
+
+    // The deferred outputs keep the step order, and the same content
+    EXPECT_EQUAL(reference.size(), 6);
+    EXPECT_EQUAL(deferred.size(), reference.size());
+    EXPECT(reference[0].step != reference[3].step);
+    for (size_t k = 0; k < reference.size() && k < deferred.size(); ++k) {
+        EXPECT_EQUAL(deferred[k].step, reference[k < 3 ? 0 : 3].step);
+        EXPECT_EQUAL(deferred[k].step, reference[k].step);
+        EXPECT_EQUAL(deferred[k].instance, reference[k].instance);
+        EXPECT(deferred[k].cells == reference[k].cells);
+    }
+    std::remove("test_step_budget_reference.bin");
+    std::remove("test_step_budget_deferral.bin");
+}
+
+CASE("test_subscription_index") {
+    // Two points over the North Sea and one in the Indian Ocean, each in its own 1 degree cell
+    std::vector<int> pointToCell = {7, 8, 9, -1};
+    auto square                  = [](double lon, double lat, double half) {
+        return std::vector<atlas::PointLonLat>{{lon - half, lat - half}, {lon + half, lat - half},
+                                               {lon + half, lat + half}, {lon - half, lat + half}};
+    };
+    std::map<int, std::vector<atlas::PointLonLat>> cells = {
+        {7, square(2.0, 55.0, 0.5)}, {8, square(5.0, 55.0, 0.5)}, {9, square(80.0, -10.0, 0.5)}};
+    auto vertices = [&cells](int cell) -> const std::vector<atlas::PointLonLat>& { return cells.at(cell); };
+
+    eckit::LocalConfiguration region;
+    region.set("area", std::vector<double>{62.0, -4.0, 51.0, 9.0});
+    eckit::LocalConfiguration northSea;
+    northSea.set("name", "north-sea");
+    northSea.set("regions", std::vector<eckit::LocalConfiguration>{region});
+    eckit::LocalConfiguration listed;
+    listed.set("name", "listed");
+    listed.set("cells", std::vector<int>{9, 42});
+    listed.set("endpoint", "/notify/listed");
+    // An area within cell 9 that holds no grid point
+    eckit::LocalConfiguration islet;
+    islet.set("area", std::vector<double>{-9.8, 80.1, -9.9, 80.2});
+    eckit::LocalConfiguration atoll;
+    atoll.set("name", "atoll");
+    atoll.set("regions", std::vector<eckit::LocalConfiguration>{islet});
+    eckit::LocalConfiguration config;
+    config.set("subscribers", std::vector<eckit::LocalConfiguration>{northSea, listed, atoll});
+    config.set("main_endpoint", "subscribed");
+
+    ExtremeEventPlugin::SubscriptionIndex index(config);
+    index.addFunctionSpace(pointToCell, vertices);
+    EXPECT_EQUAL(index.indexedCells(), 4);
+    EXPECT(index.subscribersOf({8}) == std::vector<size_t>{0});
+    EXPECT(index.subscribersOf({9}) == (std::vector<size_t>{1, 2}));
+    EXPECT(index.subscribersOf({7, 9}) == (std::vector<size_t>{0, 1, 2}));
+    EXPECT(index.subscribersOf({3, 5}).empty());
+    EXPECT_EQUAL(index.namesToJson(index.subscribersOf({42})), "[\"listed\"]");
+    EXPECT_EQUAL(index.subscriber(1).endpoint, "/notify/listed");
+    EXPECT(index.mainEndpoint() == ExtremeEventPlugin::SubscriptionIndex::MainEndpoint::Subscribed);
+
+    // Cells 8 and 9 are merged at a coarser level, whose polygons are intersected again, 42 has no coarse cell
+    std::map<int, std::vector<atlas::PointLonLat>> coarseCells = {
+        {3, square(2.0, 55.0, 0.5)}, {4, {{4.0, -11.0}, {81.0, -11.0}, {81.0, 56.0}, {4.0, 56.0}}}};
+    auto coarse = index.coarsened(
+        [](int cell) { return cell == 42 ? -1 : cell == 7 ? 3 : 4; },
+        [&coarseCells](int cell) -> const std::vector<atlas::PointLonLat>& { return coarseCells.at(cell); });
+    EXPECT_EQUAL(coarse.indexedCells(), 2);
+    EXPECT(coarse.subscribersOf({3}) == std::vector<size_t>{0});
+    EXPECT(coarse.subscribersOf({4}) == (std::vector<size_t>{0, 1, 2}));
+    EXPECT(coarse.subscribersOf({21}).empty());
+
+    config.set("subscribers", std::vector<eckit::LocalConfiguration>{northSea, northSea});
+    EXPECT_THROWS_AS(ExtremeEventPlugin::SubscriptionIndex{config}, eckit::BadParameter);
+    config.set("subscribers", std::vector<eckit::LocalConfiguration>{northSea});
+    config.set("main_endpoint", "some");
+    EXPECT_THROWS_AS(ExtremeEventPlugin::SubscriptionIndex{config}, eckit::BadValue);
+}
+
+CASE("test_notification_retry") {
+    std::map<std::string, std::string> vars = {{"CLASS", "test"}, {"TYPE", "test"}, {"EXPVER", "0001"},
+                                               {"DATE", "20250101"}, {"TIME", "0000"}, {"PLUME_PLUGIN_DEV", "0"}};
+    for (const auto& [key, value] : vars) {
+        ASSERT(setenv(key.c_str(), value.c_str(), 1) == 0);
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+
+    const std::string path = "test_notification_retry.journal";
+    std::remove(path.c_str());
+    std::vector<atlas::PointLonLat> polygon = {atlas::PointLonLat{250.3, 16.9}, atlas::PointLonLat{247.4, 14.4},
+                                               atlas::PointLonLat{253.1, 14.4}, atlas::PointLonLat{250.3, 16.9}};
+    ExtremeEventPlugin::RetryPolicy policy;
+    policy.initialBackoff   = 0.01;
+    policy.maxBackoff       = 0.05;
+    policy.failureThreshold = 3;
+    policy.cooldown         = 0.1;
+    policy.shutdownGrace    = 1.0;
+
+    // Outage: every notification fails and is journaled when the run stops
+    MockAvisoServer::Options outage;
+    outage.errorRate = 1.0;
+    MockAvisoServer server(outage);
+    ExtremeEventPlugin::AvisoNotificationHandler handler(server.url(), "/api/v1/notification");
+    {
+        ExtremeEventPlugin::NotificationDispatcher dispatcher(handler, path, policy);
+        for (int n = 0; n < 10; ++n) {
+            dispatcher.post("{\"n\":" + std::to_string(n) + "}", polygon);
+        }
+        EXPECT_NOT(dispatcher.drain(0.3));
+        EXPECT(dispatcher.stats().failures >= 3);
+        EXPECT_EQUAL(dispatcher.stats().delivered, 0);
+        // Journaled when posted, so they are not lost if the run crashes
+        EXPECT_EQUAL(dispatcher.stats().journaled, 10);
+        EXPECT_EQUAL(ExtremeEventPlugin::NotificationJournal::read(path).size(), 10);
+    }
+    auto pending = ExtremeEventPlugin::NotificationJournal::read(path);
+    EXPECT_EQUAL(pending.size(), 10);
+    EXPECT_EQUAL(pending.front().payload, "{\"n\":0}");
+
+    // Restart once the server is back: the journal is replayed, then emptied
+    server.setOptions(MockAvisoServer::Options());
+    {
+        ExtremeEventPlugin::NotificationDispatcher dispatcher(handler, path, policy);
+        EXPECT_EQUAL(dispatcher.stats().replayed, 10);
+        dispatcher.post("{\"n\":10}", polygon);
+        EXPECT(dispatcher.drain(5.0));
+        EXPECT_EQUAL(dispatcher.stats().delivered, 11);
+        // Everything is marked as delivered
+        EXPECT(ExtremeEventPlugin::NotificationJournal::read(path).empty());
+    }
+    EXPECT(ExtremeEventPlugin::NotificationJournal::read(path).empty());
+    EXPECT_EQUAL(server.counters().succeeded, 11);
+    std::remove(path.c_str());
+
+    for (const auto& var : vars) {
+        unsetenv(var.first.c_str());
+    }
+}
+CASE("test_notification_journal") {
+    const std::string path = "test_notification_journal.journal";
+    std::remove(path.c_str());
+    {
+        ExtremeEventPlugin::NotificationJournal journal(path);
+        std::vector<uint64_t> ids;
+        for (int n = 0; n < 2000; ++n) {
+            ids.push_back(journal.append("/notify", "{\"n\":" + std::to_string(n) + "}"));
+        }
+        // The compaction cannot write its file, the journal keeps the current one
+        ASSERT(mkdir((path + ".tmp").c_str(), 0700) == 0);
+        bool failed = false;
+        for (size_t n = 0; n + 1 < ids.size(); ++n) {
+            try {
+                journal.markDelivered(ids[n]);
+            }
+            catch (const eckit::Exception&) {
+                failed = true;
+            }
+        }
+        EXPECT(failed);
+        const uint64_t last = journal.append("/notify", "{\"n\":2000}");
+        journal.sync();
+        auto pending = ExtremeEventPlugin::NotificationJournal::read(path);
+        EXPECT_EQUAL(pending.size(), 2);
+        EXPECT_EQUAL(pending.front().id, ids.back());
+        EXPECT_EQUAL(pending.back().id, last);
+        ASSERT(rmdir((path + ".tmp").c_str()) == 0);
+    }
+    // Compacted when opened again
+    ExtremeEventPlugin::NotificationJournal journal(path);
+    EXPECT_EQUAL(journal.pending().size(), 2);
+    std::remove(path.c_str());
+}
 }  // namespace test
 
 int main(int argc, char** argv) {
@@ -0,0 +1,324 @@
+/*
+ * (C) Copyright 2025- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "atlas/array.h"
+#include "atlas/field.h"
+#include "atlas/functionspace.h"
+#include "atlas/grid.h"
+#include "atlas/library.h"
+#include "atlas/parallel/mpi/mpi.h"
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/mpi/Comm.h"
+#include "eckit/testing/Test.h"
+
+#include "cell_aggregation.h"
+#include "ensemble_reducer.h"
+#include "healpix_utils.h"
+#include "site_output.h"
+
+using namespace eckit::testing;
+
+namespace test {
+
+/**
+ * @brief Returns the partition of this rank of a grid along the equator, with a point every 5 degrees.
+ *
+ * Rank `r` owns the points at longitudes `10 r` and `10 r + 5`, and holds the first point of the next rank in its
+ * halo, so the partitions meet between `10 r + 5` and `10 r + 10`.
+ */
+atlas::functionspace::PointCloud equatorPartition() {
+    const auto& comm          = atlas::mpi::comm();
+    const auto rank           = static_cast<atlas::idx_t>(comm.rank());
+    const bool last           = comm.rank() + 1 == comm.size();
+    const atlas::idx_t points = last ? 2 : 3;
+    atlas::Field lonlat("lonlat", atlas::array::make_datatype<double>(), atlas::array::make_shape(points, 2));
+    atlas::Field ghost("ghost", atlas::array::make_datatype<int>(), atlas::array::make_shape(points));
+    auto lonlatView = atlas::array::make_view<double, 2>(lonlat);
+    auto ghostView  = atlas::array::make_view<int, 1>(ghost);
+    for (atlas::idx_t j = 0; j < points; ++j) {
+        lonlatView(j, 0) = 10.0 * rank + 5.0 * j;
+        lonlatView(j, 1) = 0.0;
+        ghostView(j)     = j == 2;
+    }
+    atlas::functionspace::PointCloud fs(lonlat, ghost);
+    auto gidx = atlas::array::make_view<atlas::gidx_t, 1>(fs.global_index());
+    for (atlas::idx_t j = 0; j < points; ++j) {
+        gidx(j) = 2 * rank + j + 1;
+    }
+    return fs;
+}
+
+/// Returns the lines of a file.
+std::vector<std::string> readLines(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+CASE("test_site_partition") {
+    const auto& comm = atlas::mpi::comm();
+    const int rank   = static_cast<int>(comm.rank());
+    const int size   = static_cast<int>(comm.size());
+    auto fs          = equatorPartition();
+    atlas::util::Config fieldConfig;
+    fieldConfig.set("name", "100u").set("levels", 1);
+    auto u     = fs.createField<double>(fieldConfig);
+    auto uView = atlas::array::make_view<double, 2>(u);
+    for (atlas::idx_t j = 0; j < fs.size(); ++j) {
+        uView(j, 0) = 10.0 * rank + 5.0 * j;
+    }
+    plume::data::ModelData modelData;
+    modelData.provideAtlasFieldShared("100u", u);
+
+    // A site next to the points of each rank, and a site closer to the halo point of a rank than to its owned
+    // points, which belongs to the next rank
+    std::vector<eckit::LocalConfiguration> locations;
+    for (int r = 0; r < size; ++r) {
+        eckit::LocalConfiguration near;
+        near.set("name", "near-" + std::to_string(r)).set("lat", 0.0).set("lon", 10.0 * r + 4.0);
+        locations.push_back(near);
+        if (r + 1 < size) {
+            eckit::LocalConfiguration border;
+            border.set("name", "border-" + std::to_string(r)).set("lat", 0.0).set("lon", 10.0 * r + 8.5);
+            locations.push_back(border);
+        }
+    }
+    eckit::LocalConfiguration config;
+    config.set("output", "test_site_partition.csv").set("u", "100u").set("locations", locations);
+    const std::string path = size > 1 ? "test_site_partition.csv." + std::to_string(rank) : "test_site_partition.csv";
+    std::remove(path.c_str());
+    {
+        ExtremeEventPlugin::SiteWindOutput sites(config);
+        sites.setup(modelData);
+        sites.write(modelData, "60");
+    }
+
+    // Each site is written exactly once, by the rank owning its nearest grid point
+    auto lines                        = readLines(path);
+    std::vector<std::string> expected = {"60,near-" + std::to_string(rank) + ",0,"};
+    if (rank > 0) {
+        expected.push_back("60,border-" + std::to_string(rank - 1) + ",0,");
+    }
+    EXPECT_EQUAL(lines.size(), expected.size() + 1);
+    for (const auto& prefix : expected) {
+        bool found = false;
+        for (const auto& line : lines) {
+            found = found || line.compare(0, prefix.size(), prefix) == 0;
+        }
+        EXPECT(found);
+    }
+    long rows = static_cast<long>(lines.size()) - 1;
+    comm.allReduceInPlace(rows, eckit::mpi::sum());
+    EXPECT_EQUAL(rows, static_cast<long>(locations.size()));
+    std::remove(path.c_str());
+}
+
+CASE("test_ensemble_members") {
+    const auto& world = atlas::mpi::comm("world");
+    const int rank    = static_cast<int>(world.rank());
+    const int members = static_cast<int>(world.size()) / 2;
+    if (members < 2) {
+        return;
+    }
+    eckit::LocalConfiguration config;
+    config.set("probability", 1.0).set("members", members);
+
+    // Members interleaved across the world ranks would pair different partitions, all the ranks reject them
+    world.split(rank % members, "test_interleaved_members");
+    eckit::mpi::setCommDefault("test_interleaved_members");
+    {
+        ExtremeEventPlugin::EnsembleReducer reducer(config);
+        EXPECT_THROWS_AS(reducer.setup({0, 1}), eckit::BadValue);
+    }
+
+    // Members of two consecutive ranks, the partition `r` of each member covers the cells `2 r` and `2 r + 1`
+    world.split(rank / 2, "test_members");
+    eckit::mpi::setCommDefault("test_members");
+    const int partition = static_cast<int>(atlas::mpi::comm().rank());
+    {
+        ExtremeEventPlugin::EnsembleReducer reducer(config);
+        reducer.setup({2 * partition, 2 * partition + 1, -1});
+        EXPECT_EQUAL(reducer.members(), members);
+        EXPECT_EQUAL(reducer.member(), rank / 2);
+        EXPECT_EQUAL(reducer.outputs(), rank < 2);
+
+        // Only the first member fires the first cell, all the members fire the second one
+        std::vector<int> fired = {2 * partition + 1};
+        if (rank < 2) {
+            fired.insert(fired.begin(), 2 * partition);
+        }
+        auto cells = reducer.reduce({fired, {}});
+        EXPECT_EQUAL(cells.size(), 2);
+        EXPECT(cells[0] == std::vector<int>({2 * partition + 1}));
+        EXPECT(cells[1].empty());
+    }
+
+    eckit::mpi::setCommDefault("world");
+    eckit::mpi::deleteComm("test_interleaved_members");
+    eckit::mpi::deleteComm("test_members");
+}
+
+CASE("test_local_healpix_mapping") {
+    // The grid and HEALPix resolution of the plugin test run, distributed over the ranks with a halo
+    const int resolution = 32;
+    atlas::functionspace::StructuredColumns fs(atlas::Grid("N80"), atlas::option::halo(1));
+    std::vector<int> globalMapping;
+    std::vector<std::vector<atlas::PointLonLat>> globalVertices;
+    HEALPixUtils::mapLonLatToHEALPixCell(resolution, fs, globalMapping, globalVertices);
+    std::vector<int> localMapping;
+    HEALPixUtils::CellVertexMap localVertices;
+    HEALPixUtils::mapLonLatToLocalHEALPixCells(resolution, fs, localMapping, localVertices);
+
+    // Same cell for every point, and the same vertices for every cell of the partition
+    EXPECT(localMapping == globalMapping);
+    for (const auto& cell : localVertices) {
+        EXPECT(cell.second == globalVertices[cell.first]);
+    }
+
+    // Same polygons for the points of a box crossing the partition boundaries
+    auto lonlat = atlas::array::make_view<double, 2>(fs.lonlat());
+    auto ghost  = atlas::array::make_view<int, 1>(fs.ghost());
+    std::vector<int> firing;
+    for (atlas::idx_t j = 0; j < fs.size(); ++j) {
+        if (!ghost(j) && lonlat(j, 0) >= 20.0 && lonlat(j, 0) <= 60.0 && std::abs(lonlat(j, 1)) <= 30.0) {
+            firing.push_back(j);
+        }
+    }
+    auto cells = HEALPixUtils::pointsToCells(firing, globalMapping);
+    EXPECT(HEALPixUtils::cellsToPolygons(cells, localVertices) == HEALPixUtils::cellsToPolygons(cells, globalVertices));
+
+    // The coarse cells around the partition are the parents of its cells, with the vertices of the global mesh
+    std::vector<int> fromFinest;
+    std::vector<std::vector<atlas::PointLonLat>> coarseGlobal;
+    HEALPixUtils::mapHEALPixCellsToCoarserCells(resolution / 4, resolution, fromFinest, coarseGlobal);
+    std::unordered_map<int, int> localFromFinest;
+    HEALPixUtils::CellVertexMap coarseLocal;
+    HEALPixUtils::mapLocalHEALPixCellsToCoarserCells(resolution / 4, resolution, fs, localMapping, localFromFinest,
+                                                     coarseLocal);
+    EXPECT_EQUAL(localFromFinest.size(), localVertices.size());
+    for (const auto& fine : localFromFinest) {
+        EXPECT_EQUAL(fine.second, fromFinest[fine.first]);
+        EXPECT(coarseLocal.at(fine.second) == coarseGlobal[fine.second]);
+    }
+}
+
+CASE("test_shared_cells") {
+    const auto& comm = atlas::mpi::comm();
+    const int rank   = static_cast<int>(comm.rank());
+    const int size   = static_cast<int>(comm.size());
+    // Rank `r` holds the cells `r` and `r + 1`, shared with its neighbours, and a cell of its own
+    ExtremeEventPlugin::SharedSlots shared({rank, rank + 1, 1000 + rank}, {1, 2, 3}, comm);
+    EXPECT_EQUAL(shared.size, static_cast<size_t>(size - 1));
+    EXPECT_EQUAL(shared.slotShared[0] >= 0, rank > 0);
+    EXPECT_EQUAL(shared.slotShared[1] >= 0, rank + 1 < size);
+    EXPECT_EQUAL(shared.slotShared[2], -1);
+    EXPECT_EQUAL(shared.cellShared.size(), static_cast<size_t>((rank > 0) + (rank + 1 < size)));
+
+    // Both neighbours give a shared cell the same index, and the indices number the shared cells from 0
+    std::vector<int> lowest(size + 1, size), highest(size + 1, -1);
+    for (int slot : {0, 1}) {
+        if (shared.slotShared[slot] >= 0) {
+            lowest[rank + slot]  = shared.slotShared[slot];
+            highest[rank + slot] = shared.slotShared[slot];
+        }
+    }
+    comm.allReduceInPlace(lowest.begin(), lowest.end(), eckit::mpi::min());
+    comm.allReduceInPlace(highest.begin(), highest.end(), eckit::mpi::max());
+    std::vector<int> indices;
+    for (int cell = 1; cell < size; ++cell) {
+        EXPECT_EQUAL(lowest[cell], highest[cell]);
+        indices.push_back(lowest[cell]);
+    }
+    std::sort(indices.begin(), indices.end());
+    for (int idx = 0; idx < size - 1; ++idx) {
+        EXPECT_EQUAL(indices[idx], idx);
+    }
+}
+
+CASE("test_cell_criterion_boundary") {
+    using Criterion  = ExtremeEvent::CellCriterion;
+    const auto& comm = atlas::mpi::comm();
+    const int rank   = static_cast<int>(comm.rank());
+    const int size   = static_cast<int>(comm.size());
+    // Cell 7 lies across all the partitions, two owned points on each, each rank also has a cell of its own
+    ExtremeEventPlugin::CellSlots slots({7, 100 + rank, 7, -1});
+    ExtremeEventPlugin::SharedSlots shared(slots.slotCell, slots.slotPoints, comm);
+    EXPECT_EQUAL(shared.size, static_cast<size_t>(1));
+    EXPECT_EQUAL(shared.sharedPoints[0], 2 * size);
+
+    // The first two ranks detect one point of cell 7 each, the first one also the point of its own cell
+    std::vector<int> detected;
+    std::vector<float> values;
+    if (rank < 2) {
+        detected.push_back(0);
+        values.push_back(30.f);
+    }
+    if (rank == 0) {
+        detected.push_back(1);
+        values.push_back(40.f);
+    }
+    const std::vector<int> none;
+    const std::vector<int> ownCell = {100};
+    const std::vector<int> shared7 = {7};
+    const std::vector<int> both    = {7, 100};
+
+    // Two points of cell 7 are detected over the partitions, though no partition holds two of them
+    eckit::LocalConfiguration options;
+    options.set("min_points", 2);
+    eckit::LocalConfiguration instance;
+    instance.set("cell_criterion", options);
+    auto points = Criterion::fromConfig(instance);
+    auto cells  = ExtremeEventPlugin::aggregateCells(detected, values, slots, points, nullptr, &shared);
+    EXPECT(cells == shared7);
+    // Judged on its own, each partition holds a single detected point of cell 7
+    EXPECT(ExtremeEventPlugin::aggregateCells(detected, values, slots, points).empty());
+
+    // The fraction is taken over the points of all the partitions, 2 of 2 * size
+    options = eckit::LocalConfiguration();
+    options.set("min_fraction", 0.75);
+    instance.set("cell_criterion", options);
+    auto fraction = Criterion::fromConfig(instance);
+    cells         = ExtremeEventPlugin::aggregateCells(detected, values, slots, fraction, nullptr, &shared);
+    EXPECT(cells == (rank == 0 ? ownCell : none));
+    options.set("min_fraction", 1.0 / size);
+    instance.set("cell_criterion", options);
+    fraction = Criterion::fromConfig(instance);
+    cells    = ExtremeEventPlugin::aggregateCells(detected, values, slots, fraction, nullptr, &shared);
+    EXPECT(cells == (rank == 0 ? both : shared7));
+
+    // The mean of cell 7 is taken over the values of both partitions
+    options = eckit::LocalConfiguration();
+    options.set("min_mean", 30.0);
+    instance.set("cell_criterion", options);
+    auto mean = Criterion::fromConfig(instance);
+    cells     = ExtremeEventPlugin::aggregateCells(detected, values, slots, mean, nullptr, &shared);
+    EXPECT(cells == (rank == 0 ? both : shared7));
+}
+
+}  // namespace test
+
+int main(int argc, char** argv) {
+    atlas::initialize();
+    int status = run_tests(argc, argv);
+    atlas::finalize();
+    return status;
+}